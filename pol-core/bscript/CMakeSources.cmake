@@ -339,6 +339,8 @@ set (bscript_sources    # sorted !
   bclassinstance.h
   berror.cpp
   berror.h
+  binpack.cpp
+  binpack.h
   blong.cpp
   bobject.h
   bstruct.cpp
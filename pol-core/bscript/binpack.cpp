@@ -0,0 +1,409 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "binpack.h"
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <memory>
+#include <string.h>
+
+#include "../clib/rawtypes.h"
+#include "berror.h"
+#include "bobject.h"
+#include "bstruct.h"
+#include "dict.h"
+#include "impstr.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+/**
+ * Binary pack format:
+ * Every value starts with a one character tag, numbers and lengths are varints.
+ * - u                 uninitialized
+ * - x                 array hole
+ * - T / F             boolean
+ * - iVARINT           integer, zigzag encoded
+ * - rLEN CHARS        real, shortest round trip representation
+ * - sLEN BYTES        string
+ * - aCOUNT VALUES     array
+ * - dCOUNT KEY VALUE  dictionary
+ * - tCOUNT LEN NAME VALUE   struct (e for error)
+ * - vLEN TEXT         anything else, in the text format
+ *
+ * A varint stores 5 bits per character, least significant group first: '0'+group ends the
+ * number, 'P'+group is followed by more groups. Only bytes of string contents are stored
+ * unchanged, so the packed form is as line safe as the text format.
+ *
+ * Examples:
+ * - 57              ~ib3
+ * - "hello"         ~s5hello
+ * - { 5, "hey" }    ~a2i:s3hey
+ */
+namespace
+{
+const char VARINT_LAST = '0';
+const char VARINT_MORE = 'P';
+const unsigned VARINT_BITS = 5;
+const unsigned VARINT_MASK = ( 1u << VARINT_BITS ) - 1;
+// containers nested deeper than this are rejected instead of exhausting the stack
+const unsigned MAX_NESTING = 100;
+
+void write_varint( std::string& out, u64 value )
+{
+  while ( value > VARINT_MASK )
+  {
+    out += static_cast<char>( VARINT_MORE + ( value & VARINT_MASK ) );
+    value >>= VARINT_BITS;
+  }
+  out += static_cast<char>( VARINT_LAST + value );
+}
+
+void write_bytes( std::string& out, const std::string& value )
+{
+  write_varint( out, value.size() );
+  out += value;
+}
+
+void write_value( std::string& out, const BObjectImp& imp );
+
+void write_ref( std::string& out, const BObjectRef& ref )
+{
+  if ( ref.get() )
+    write_value( out, ref->impref() );
+  else
+    out += 'x';
+}
+
+void write_struct( std::string& out, const BStruct& bstruct, char tag )
+{
+  out += tag;
+  write_varint( out, bstruct.contents().size() );
+  for ( const auto& content : bstruct.contents() )
+  {
+    write_bytes( out, content.first );
+    write_ref( out, content.second );
+  }
+}
+
+void write_value( std::string& out, const BObjectImp& imp )
+{
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTUninit:
+    out += 'u';
+    break;
+  case BObjectImp::OTBoolean:
+    out += static_cast<const BBoolean&>( imp ).value() ? 'T' : 'F';
+    break;
+  case BObjectImp::OTLong:
+  {
+    s32 value = static_cast<const BLong&>( imp ).value();
+    out += 'i';
+    write_varint( out, ( static_cast<u32>( value ) << 1 ) ^ static_cast<u32>( value >> 31 ) );
+    break;
+  }
+  case BObjectImp::OTDouble:
+  {
+    double value = static_cast<const Double&>( imp ).value();
+    char buf[32];
+    auto res = fmt::format_to_n( buf, sizeof buf, "{}", value );
+    out += 'r';
+    write_varint( out, res.size );
+    out.append( buf, res.size );
+    break;
+  }
+  case BObjectImp::OTString:
+    out += 's';
+    write_bytes( out, static_cast<const String&>( imp ).value() );
+    break;
+  case BObjectImp::OTArray:
+  {
+    const auto& arr = static_cast<const ObjArray&>( imp ).ref_arr;
+    out += 'a';
+    write_varint( out, arr.size() );
+    for ( const auto& elem : arr )
+      write_ref( out, elem );
+    break;
+  }
+  case BObjectImp::OTDictionary:
+  {
+    const auto& contents = static_cast<const BDictionary&>( imp ).contents();
+    out += 'd';
+    write_varint( out, contents.size() );
+    for ( const auto& content : contents )
+    {
+      write_value( out, content.first.impref() );
+      write_ref( out, content.second );
+    }
+    break;
+  }
+  case BObjectImp::OTStruct:
+    write_struct( out, static_cast<const BStruct&>( imp ), 't' );
+    break;
+  case BObjectImp::OTError:
+    write_struct( out, static_cast<const BError&>( imp ), 'e' );
+    break;
+  default:
+  {
+    std::string text = imp.pack();
+    if ( text == "u" )
+    {
+      out += 'u';
+    }
+    else
+    {
+      out += 'v';
+      write_bytes( out, text );
+    }
+    break;
+  }
+  }
+}
+
+class Reader
+{
+public:
+  Reader( const char* data, size_t len )
+      : pos_( data ), end_( data + len ), error_( nullptr ), depth_( 0 )
+  {
+  }
+
+  BObjectImp* read_top();
+
+private:
+  BObjectImp* read_value();
+  BObjectImp* read_container( char tag );
+  bool read_varint( u64& value );
+  bool read_length( size_t& len );
+  BObjectImp* read_struct( std::unique_ptr<BStruct> bstruct );
+  BObjectImp* fail( const char* error )
+  {
+    if ( error_ == nullptr )
+      error_ = error;
+    return nullptr;
+  }
+
+  const char* pos_;
+  const char* end_;
+  const char* error_;
+  unsigned depth_;
+};
+
+BObjectImp* Reader::read_top()
+{
+  BObjectImp* imp = read_value();
+  if ( imp == nullptr )
+    return new BError( std::string( "Unable to unpack binary value: " ) + error_ );
+  return imp;
+}
+
+bool Reader::read_varint( u64& value )
+{
+  value = 0;
+  for ( unsigned shift = 0; shift < 64; shift += VARINT_BITS )
+  {
+    if ( pos_ == end_ )
+      return false;
+    char ch = *pos_++;
+    if ( ch >= VARINT_LAST && ch < VARINT_MORE )
+    {
+      value |= static_cast<u64>( ch - VARINT_LAST ) << shift;
+      return true;
+    }
+    if ( ch < VARINT_MORE || ch > VARINT_MORE + static_cast<char>( VARINT_MASK ) )
+      return false;
+    value |= static_cast<u64>( ch - VARINT_MORE ) << shift;
+  }
+  return false;
+}
+
+// lengths and element counts can never exceed the remaining input
+bool Reader::read_length( size_t& len )
+{
+  u64 value;
+  if ( !read_varint( value ) || value > static_cast<u64>( end_ - pos_ ) )
+    return false;
+  len = static_cast<size_t>( value );
+  return true;
+}
+
+BObjectImp* Reader::read_struct( std::unique_ptr<BStruct> bstruct )
+{
+  size_t count;
+  if ( !read_length( count ) )
+    return fail( "invalid struct member count" );
+  for ( size_t i = 0; i < count; ++i )
+  {
+    size_t len;
+    if ( !read_length( len ) )
+      return fail( "invalid struct member name" );
+    std::string name( pos_, len );
+    pos_ += len;
+    BObjectImp* imp = read_value();
+    if ( imp == nullptr )
+      return nullptr;
+    bstruct->addMember( name.c_str(), imp );
+  }
+  return bstruct.release();
+}
+
+BObjectImp* Reader::read_container( char tag )
+{
+  switch ( tag )
+  {
+  case 'a':
+  {
+    size_t count;
+    if ( !read_length( count ) )
+      return fail( "invalid array element count" );
+    std::unique_ptr<ObjArray> arr( new ObjArray );
+    arr->ref_arr.resize( count );
+    for ( size_t i = 0; i < count; ++i )
+    {
+      if ( pos_ != end_ && *pos_ == 'x' )
+      {
+        ++pos_;
+        continue;
+      }
+      BObjectImp* imp = read_value();
+      if ( imp == nullptr )
+        return nullptr;
+      arr->ref_arr[i].set( new BObject( imp ) );
+    }
+    return arr.release();
+  }
+  case 'd':
+  {
+    size_t count;
+    if ( !read_length( count ) )
+      return fail( "invalid dictionary element count" );
+    std::unique_ptr<BDictionary> dict( new BDictionary );
+    for ( size_t i = 0; i < count; ++i )
+    {
+      BObjectImp* imp = read_value();
+      if ( imp == nullptr )
+        return nullptr;
+      // held by a BObject, 'u' and 'x' give the shared uninit instance
+      BObject key( imp );
+      if ( !key.isa( BObjectImp::OTString ) && !key.isa( BObjectImp::OTLong ) &&
+           !key.isa( BObjectImp::OTDouble ) && !key.isa( BObjectImp::OTApplicObj ) )
+        return fail( "dictionary keys must be integer, real, or string" );
+      BObjectImp* value = read_value();
+      if ( value == nullptr )
+        return nullptr;
+      dict->addMember( key.impptr(), value );
+    }
+    return dict.release();
+  }
+  case 't':
+    return read_struct( std::unique_ptr<BStruct>( new BStruct ) );
+  default:
+    return read_struct( std::unique_ptr<BStruct>( new BError ) );
+  }
+}
+
+BObjectImp* Reader::read_value()
+{
+  if ( pos_ == end_ )
+    return fail( "unexpected end of data" );
+  char tag = *pos_++;
+  switch ( tag )
+  {
+  case 'u':
+  case 'x':
+    return UninitObject::create();
+  case 'T':
+    return new BBoolean( true );
+  case 'F':
+    return new BBoolean( false );
+  case 'i':
+  {
+    u64 value;
+    if ( !read_varint( value ) || value > 0xFFFFFFFFu )
+      return fail( "invalid integer" );
+    u32 zigzag = static_cast<u32>( value );
+    return new BLong( static_cast<s32>( ( zigzag >> 1 ) ^ ( 0u - ( zigzag & 1 ) ) ) );
+  }
+  case 'r':
+  {
+    size_t len;
+    char buf[32];
+    if ( !read_length( len ) || len >= sizeof buf )
+      return fail( "invalid real" );
+    memcpy( buf, pos_, len );
+    buf[len] = '\0';
+    pos_ += len;
+    return new Double( strtod( buf, nullptr ) );
+  }
+  case 's':
+  {
+    size_t len;
+    if ( !read_length( len ) )
+      return fail( "invalid string length" );
+    const char* str = pos_;
+    pos_ += len;
+    return new String( str, len );
+  }
+  case 'a':
+  case 'd':
+  case 't':
+  case 'e':
+  {
+    if ( depth_ == MAX_NESTING )
+      return fail( "nesting too deep" );
+    ++depth_;
+    BObjectImp* imp = read_container( tag );
+    --depth_;
+    return imp;
+  }
+  case 'v':
+  {
+    size_t len;
+    if ( !read_length( len ) )
+      return fail( "invalid text value" );
+    // only the text format is embedded, a binary value would start over at nesting depth 0
+    if ( len > 0 && *pos_ == BINARY_PACK_MARKER )
+      return fail( "invalid text value" );
+    std::string text( pos_, len );
+    pos_ += len;
+    return BObjectImp::unpack( text.c_str() );
+  }
+  default:
+    return fail( "unknown object type" );
+  }
+}
+}  // namespace
+
+bool valid_pack_format( int format )
+{
+  return format == static_cast<int>( PackFormat::TEXT ) ||
+         format == static_cast<int>( PackFormat::BINARY );
+}
+
+std::string pack( const BObjectImp& imp, PackFormat format )
+{
+  if ( format == PackFormat::TEXT )
+    return imp.pack();
+  std::string out;
+  pack_binary( imp, out );
+  return out;
+}
+
+void pack_binary( const BObjectImp& imp, std::string& out )
+{
+  out += BINARY_PACK_MARKER;
+  write_value( out, imp );
+}
+
+BObjectImp* unpack_binary( const char* data, size_t len )
+{
+  return Reader( data, len ).read_top();
+}
+}  // namespace Bscript
+}  // namespace Pol
@@ -0,0 +1,40 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef BSCRIPT_BINPACK_H
+#define BSCRIPT_BINPACK_H
+
+#include <stddef.h>
+#include <string>
+
+namespace Pol
+{
+namespace Bscript
+{
+class BObjectImp;
+
+/**
+ * Formats understood by BObjectImp::unpack().
+ * TEXT is the classic "S5:hello" format, BINARY the compact tagged format which starts with
+ * BINARY_PACK_MARKER. Both are free of line breaks, so either can be stored in a save file.
+ */
+enum class PackFormat
+{
+  TEXT = 1,
+  BINARY = 2
+};
+const char BINARY_PACK_MARKER = '~';
+
+bool valid_pack_format( int format );
+
+std::string pack( const BObjectImp& imp, PackFormat format );
+void pack_binary( const BObjectImp& imp, std::string& out );
+
+// data points behind the marker
+BObjectImp* unpack_binary( const char* data, size_t len );
+}  // namespace Bscript
+}  // namespace Pol
+#endif
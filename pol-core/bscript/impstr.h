@@ -10,9 +10,11 @@
 #include "bobject.h"
 #endif
 
+#include <memory>
 #include <stack>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace Pol
 {
@@ -36,7 +38,13 @@ public:
   explicit String( const std::string& str, Tainted san = Tainted::NO );
   explicit String( const std::string_view& str, Tainted san = Tainted::NO );
   explicit String( BObjectImp& objimp );
-  String( const String& str ) : BObjectImp( OTString ), value_( str.value_ ) {}
+  String( const String& str )
+      : BObjectImp( OTString ),
+        value_( str.value_ ),
+        encoding_( str.encoding_ ),
+        index_( str.index_ )
+  {
+  }
   virtual ~String() = default;
 
 private:
@@ -79,14 +87,20 @@ public:
   String& operator=( const char* s )
   {
     value_ = s;
+    changed();
     return *this;
   }
   String& operator=( const String& str )
   {
-    value_ = str.value_;
+    copyvalue( str );
     return *this;
   }
-  void copyvalue( const String& str ) { value_ = str.value_; }
+  void copyvalue( const String& str )
+  {
+    value_ = str.value_;
+    encoding_ = str.encoding_;
+    index_ = str.index_;
+  }
 
 private:
   void remove( const std::string& s );
@@ -147,8 +161,35 @@ protected:
 
 private:
   size_t getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const;
+  size_t getCodepointPosition( size_t bytepos ) const;
+
+  // Character positions are codepoints of the utf8 value. Pure ASCII strings map them directly to
+  // bytes, others build a sparse index of byte offsets on first use, which copies share. Every
+  // change of value_ has to call changed().
+  enum class Encoding : u8
+  {
+    UNKNOWN,
+    ASCII,
+    UTF8
+  };
+  struct CodepointIndex
+  {
+    static constexpr size_t STRIDE = 32;
+    size_t length;                // in codepoints
+    std::vector<size_t> offsets;  // byte offset of every STRIDE-th codepoint
+  };
+  bool isASCII() const;
+  const CodepointIndex& codepointIndex() const;
+  void changed()
+  {
+    encoding_ = Encoding::UNKNOWN;
+    index_.reset();
+  }
+  void appended( size_t oldsize );
 
   std::string value_;
+  mutable Encoding encoding_ = Encoding::UNKNOWN;
+  mutable std::shared_ptr<const CodepointIndex> index_;
   friend class SubString;
 };
 
@@ -285,6 +285,8 @@ ObjMember object_members[] = {
     { MBR_MAX_ATTACK_RANGE_INCREASE, "max_attack_range_increase" },
     { MBR_MAX_ATTACK_RANGE_INCREASE_MOD, "max_attack_range_increase_mod" },
     { MBR_ITEMS_DECAY, "items_decay" },
+    { MBR_QUEUED_PACKETS, "queued_packets" },  // 270
+    { MBR_BANDWIDTH_LIMIT, "bandwidth_limit" },
 };
 int n_objmembers = sizeof object_members / sizeof object_members[0];
 ObjMember* getKnownObjMember( const char* token )
@@ -9,9 +9,12 @@
  */
 
 #include <assert.h>
+#include <ctype.h>
 #include <istream>
+#include <iterator>
 #include <limits>
 #include <stddef.h>
+#include <string.h>
 #include <string>
 
 #include "../clib/clib.h"
@@ -23,6 +26,7 @@
 #include "../clib/stlutil.h"
 #include "bclassinstance.h"
 #include "berror.h"
+#include "binpack.h"
 #include "bobject.h"
 #include "bstruct.h"
 #include "continueimp.h"
@@ -80,6 +84,8 @@ size_t BObject::sizeEstimate() const
  * - { 5,3 }         a2:i5i3
  * - { 5, "hey" }    a2:i5S3:hey
  * - { 5, "hey", 7 } a3:i5S3:heyi7
+ *
+ * Values packed in PackFormat::BINARY start with BINARY_PACK_MARKER, see binpack.cpp.
  */
 BObjectImp* BObjectImp::unpack( std::istream& is )
 {
@@ -110,6 +116,12 @@ BObjectImp* BObjectImp::unpack( std::istream& is )
       return UninitObject::create();
     case 'b':
       return BBoolean::unpack( is );
+    case BINARY_PACK_MARKER:
+    {
+      std::string rest( ( std::istreambuf_iterator<char>( is ) ),
+                        std::istreambuf_iterator<char>() );
+      return unpack_binary( rest.data(), rest.size() );
+    }
 
     default:
       return new BError( "Unknown object type '" + std::string( 1, typech ) + "'" );
@@ -123,6 +135,11 @@ BObjectImp* BObjectImp::unpack( std::istream& is )
 
 BObjectImp* BObjectImp::unpack( const char* pstr )
 {
+  const char* start = pstr;
+  while ( isspace( static_cast<unsigned char>( *start ) ) )
+    ++start;
+  if ( *start == BINARY_PACK_MARKER )
+    return unpack_binary( start + 1, strlen( start + 1 ) );
   ISTRINGSTREAM is( pstr );
   return unpack( is );
 }
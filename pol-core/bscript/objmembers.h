@@ -310,6 +310,8 @@ enum MemberID
   MBR_MAX_ATTACK_RANGE_INCREASE,
   MBR_MAX_ATTACK_RANGE_INCREASE_MOD,
   MBR_ITEMS_DECAY,
+  MBR_QUEUED_PACKETS,  // 270
+  MBR_BANDWIDTH_LIMIT,
 };
 
 inline auto format_as( MemberID id )
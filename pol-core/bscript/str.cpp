@@ -8,6 +8,7 @@
  * sense.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctype.h>
 #include <cwctype>
@@ -83,7 +84,47 @@ String* String::StrStr( int begin, int len ) const
 
 size_t String::length() const
 {
-  return utf8::unchecked::distance( value_.begin(), value_.end() );
+  if ( isASCII() )
+    return value_.size();
+  return codepointIndex().length;
+}
+
+bool String::isASCII() const
+{
+  if ( encoding_ == Encoding::UNKNOWN )
+    encoding_ = hasUTF8Characters( value_ ) ? Encoding::UTF8 : Encoding::ASCII;
+  return encoding_ == Encoding::ASCII;
+}
+
+const String::CodepointIndex& String::codepointIndex() const
+{
+  if ( !index_ )
+  {
+    auto index = std::make_shared<CodepointIndex>();
+    index->offsets.reserve( value_.size() / CodepointIndex::STRIDE + 1 );
+    size_t count = 0;
+    for ( auto itr = value_.cbegin(), end = value_.cend(); itr != end;
+          utf8::unchecked::next( itr ), ++count )
+    {
+      if ( count % CodepointIndex::STRIDE == 0 )
+        index->offsets.push_back( std::distance( value_.cbegin(), itr ) );
+    }
+    index->length = count;
+    if ( index->offsets.empty() )
+      index->offsets.push_back( 0 );
+    index_ = std::move( index );
+  }
+  return *index_;
+}
+
+void String::appended( size_t oldsize )
+{
+  // appending ASCII to ASCII is common, no need to scan everything again
+  if ( encoding_ == Encoding::ASCII &&
+       std::none_of( std::next( value_.cbegin(), oldsize ), value_.cend(),
+                     []( char c ) { return c & 0x80; } ) )
+    return;
+  changed();
 }
 
 String* String::ETrim( const char* CRSet, int type ) const
@@ -135,6 +176,7 @@ void String::EStrReplace( String* str1, String* str2 )
   {
     value_.replace( valpos, str1->value_.size(), str2->value_ );
     valpos += str2->value_.size();
+    changed();
   }
 }
 
@@ -144,7 +186,10 @@ void String::ESubStrReplace( String* replace_with, unsigned int index, unsigned
   size_t begin = getBytePosition( &itr, index - 1 );
   size_t end = getBytePosition( &itr, len );
   if ( begin != std::string::npos )
+  {
     value_.replace( begin, end - begin, replace_with->value_ );
+    changed();
+  }
 }
 
 std::string String::pack() const
@@ -205,7 +250,10 @@ BObjectImp* String::unpackWithLen( std::istream& is )
 
 size_t String::sizeEstimate() const
 {
-  return sizeof( String ) + value_.capacity();
+  size_t size = sizeof( String ) + value_.capacity();
+  if ( index_ )
+    size += sizeof( CodepointIndex ) + index_->offsets.capacity() * sizeof( size_t );
+  return size;
 }
 
 /*
@@ -223,8 +271,7 @@ int String::find( int begin, const char* target ) const
     return -1;
   else
   {
-    pos = utf8::unchecked::distance( value_.cbegin(), std::next( value_.cbegin(), pos ) );
-    return static_cast<int>( pos );
+    return static_cast<int>( getCodepointPosition( pos ) );
   }
 }
 
@@ -283,23 +330,33 @@ void String::selfPlusObjImp( BObjectImp& objimp, BObject& obj )
 }
 void String::selfPlusObj( BObjectImp& objimp, BObject& /*obj*/ )
 {
+  auto oldsize = value_.size();
   value_ += objimp.getStringRep();
+  appended( oldsize );
 }
 void String::selfPlusObj( BLong& objimp, BObject& /*obj*/ )
 {
+  auto oldsize = value_.size();
   value_ += objimp.getStringRep();
+  appended( oldsize );
 }
 void String::selfPlusObj( Double& objimp, BObject& /*obj*/ )
 {
+  auto oldsize = value_.size();
   value_ += objimp.getStringRep();
+  appended( oldsize );
 }
 void String::selfPlusObj( String& objimp, BObject& /*obj*/ )
 {
+  auto oldsize = value_.size();
   value_ += objimp.getStringRep();
+  appended( oldsize );
 }
 void String::selfPlusObj( ObjArray& objimp, BObject& /*obj*/ )
 {
+  auto oldsize = value_.size();
   value_ += objimp.getStringRep();
+  appended( oldsize );
 }
 
 
@@ -307,7 +364,10 @@ void String::remove( const std::string& rm )
 {
   auto pos = value_.find( rm );
   if ( pos != std::string::npos )
+  {
     value_.erase( pos, rm.size() );
+    changed();
+  }
 }
 
 BObjectImp* String::selfMinusObjImp( const BObjectImp& objimp ) const
@@ -413,6 +473,7 @@ void String::toUpper()
     Clib::mkupperASCII( value_ );
     return;
   }
+  changed();
 #ifndef WINDOWS
   std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
   value_.clear();
@@ -452,6 +513,7 @@ void String::toLower()
     Clib::mklowerASCII( value_ );
     return;
   }
+  changed();
 #ifndef WINDOWS
   std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
   value_.clear();
@@ -486,17 +548,51 @@ void String::toLower()
 
 size_t String::getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const
 {
-  auto itr_end = value_.cend();
-  for ( size_t i = 0; i < codeindex && *itr != itr_end; ++i )
-    utf8::unchecked::next( *itr );
-
-  if ( *itr != itr_end )
+  size_t pos = std::distance( value_.cbegin(), *itr );
+  if ( isASCII() )
   {
-    return std::distance( value_.cbegin(), *itr );
+    pos = codeindex < value_.size() - pos ? pos + codeindex : value_.size();
   }
+  else
+  {
+    const auto& index = codepointIndex();
+    size_t target = getCodepointPosition( pos );
+    if ( codeindex < index.length - target )
+    {
+      target += codeindex;
+      pos = index.offsets[target / CodepointIndex::STRIDE];
+      auto next = std::next( value_.cbegin(), pos );
+      for ( size_t i = target % CodepointIndex::STRIDE; i > 0; --i )
+        utf8::unchecked::next( next );
+      pos = std::distance( value_.cbegin(), next );
+    }
+    else
+    {
+      pos = value_.size();
+    }
+  }
+  *itr = std::next( value_.cbegin(), pos );
+
+  if ( pos < value_.size() )
+    return pos;
   return std::string::npos;
 }
 
+size_t String::getCodepointPosition( size_t bytepos ) const
+{
+  if ( isASCII() )
+    return bytepos;
+  const auto& index = codepointIndex();
+  auto block =
+      std::prev( std::upper_bound( index.offsets.cbegin(), index.offsets.cend(), bytepos ) );
+  size_t codepos = std::distance( index.offsets.cbegin(), block ) * CodepointIndex::STRIDE;
+  auto itr = std::next( value_.cbegin(), *block );
+  auto target = std::next( value_.cbegin(), std::min( bytepos, value_.size() ) );
+  for ( ; itr < target; ++codepos )
+    utf8::unchecked::next( itr );
+  return codepos;
+}
+
 BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*copy*/ )
 {
   std::string::size_type pos, len;
@@ -549,6 +645,7 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
     {
       String* target_str = (String*)target;
       value_.replace( pos, len, target_str->value_ );
+      changed();
     }
     return this;
   }
@@ -630,6 +727,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   {
     String* target_str = (String*)target;
     value_.replace( index, len, target_str->value_ );
+    changed();
   }
   else
   {
@@ -1130,7 +1228,7 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
 
 bool String::hasUTF8Characters() const
 {
-  return hasUTF8Characters( value_ );
+  return !isASCII();
 }
 
 bool String::hasUTF8Characters( const std::string& str )
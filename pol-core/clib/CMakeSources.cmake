@@ -44,6 +44,10 @@ set (clib_sources
   kbhit.h
   logfacility.cpp
   logfacility.h
+  mappedcfgfile.cpp
+  mappedcfgfile.h
+  mappedfile.cpp
+  mappedfile.h
   maputil.h
   message_queue.h
   mlog.cpp 
@@ -9,8 +9,11 @@
 
 #include "cfgfile.h"
 
+#include <condition_variable>
 #include <ctype.h>
 #include <exception>
+#include <map>
+#include <mutex>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -532,6 +535,34 @@ bool VectorConfigElem::remove_first_prop( std::string* propname, std::string* va
   return true;
 }
 
+struct ConfigFile::PreparsedElem
+{
+  ConfigElem elem;
+  int line_start;
+  int line_end;
+};
+
+namespace
+{
+struct PreparsedFile
+{
+  enum class State
+  {
+    PENDING,
+    PARSING,
+    DONE,
+    FAILED
+  };
+  State state = State::PENDING;
+  unsigned reads = 0;
+  std::vector<ConfigFile::PreparsedElem> elems;
+};
+
+std::mutex preparsed_mutex;
+std::condition_variable preparsed_cv;
+std::map<std::string, PreparsedFile> preparsed_files;
+}  // namespace
+
 ConfigFile::ConfigFile( const char* i_filename, const char* allowed_types_str )
     : _filename( "<n/a>" ),
       _modified( 0 ),
@@ -541,7 +572,9 @@ ConfigFile::ConfigFile( const char* i_filename, const char* allowed_types_str )
       fp( nullptr ),
 #endif
       _element_line_start( 0 ),
-      _cur_line( 0 )
+      _cur_line( 0 ),
+      _use_preparsed( false ),
+      _preparsed_next( 0 )
 {
   init( i_filename, allowed_types_str );
 }
@@ -555,7 +588,9 @@ ConfigFile::ConfigFile( const std::string& i_filename, const char* allowed_types
       fp( nullptr ),
 #endif
       _element_line_start( 0 ),
-      _cur_line( 0 )
+      _cur_line( 0 ),
+      _use_preparsed( false ),
+      _preparsed_next( 0 )
 {
   init( i_filename.c_str(), allowed_types_str );
 }
@@ -592,6 +627,12 @@ unsigned ConfigFile::element_line_start() const
 }
 
 void ConfigFile::open( const char* i_filename )
+{
+  open_file( i_filename );
+  take_preparsed();
+}
+
+void ConfigFile::open_file( const char* i_filename )
 {
   _filename = i_filename;
 
@@ -618,6 +659,138 @@ void ConfigFile::open( const char* i_filename )
   _modified = cfgstat.st_mtime;
 }
 
+void ConfigFile::seek( size_t offset )
+{
+#if CFGFILE_USES_IOSTREAMS
+  ifs.clear();
+  ifs.seekg( offset );
+#elif defined( _WIN32 )
+  _fseeki64( fp, offset, SEEK_SET );
+#else
+  fseeko( fp, offset, SEEK_SET );
+#endif
+  _cur_line = 0;
+  _use_preparsed = false;
+}
+
+void ConfigFile::check_allowed_type( const std::string& type ) const
+{
+  if ( allowed_types_.empty() || allowed_types_.find( type ) != allowed_types_.end() )
+    return;
+  OSTRINGSTREAM os;
+  os << "Unexpected type '" << type << "'" << std::endl;
+  os << "\tValid types are:";
+  for ( const auto& allowed : allowed_types_ )
+  {
+    os << " " << allowed.c_str();
+  }
+  throw std::runtime_error( OSTRINGSTREAM_STR( os ) );
+}
+
+void ConfigFile::expect( const std::string& filename, unsigned reads )
+{
+  std::lock_guard<std::mutex> lock( preparsed_mutex );
+  preparsed_files[filename].reads += reads;
+}
+
+bool ConfigFile::parse_all( const std::string& filename, std::vector<PreparsedElem>& elems )
+{
+  try
+  {
+    ConfigFile cf;
+    cf.open_file( filename.c_str() );
+    ConfigElem elem;
+    while ( cf._read( elem ) )
+    {
+      elems.emplace_back();
+      PreparsedElem& parsed = elems.back();
+      parsed.elem.type_.swap( elem.type_ );
+      parsed.elem.rest_.swap( elem.rest_ );
+      parsed.elem.properties.swap( elem.properties );
+      parsed.line_start = cf._element_line_start;
+      parsed.line_end = cf._cur_line;
+    }
+    return true;
+  }
+  catch ( ... )
+  {
+    // read again by the ConfigFile which needs it, to report the error there
+    return false;
+  }
+}
+
+void ConfigFile::preparse( const std::string& filename )
+{
+  {
+    std::lock_guard<std::mutex> lock( preparsed_mutex );
+    auto itr = preparsed_files.find( filename );
+    if ( itr == preparsed_files.end() || itr->second.state != PreparsedFile::State::PENDING )
+      return;
+    itr->second.state = PreparsedFile::State::PARSING;
+  }
+  std::vector<PreparsedElem> elems;
+  bool parsed = parse_all( filename, elems );
+  {
+    std::lock_guard<std::mutex> lock( preparsed_mutex );
+    auto itr = preparsed_files.find( filename );
+    if ( itr == preparsed_files.end() )
+      return;
+    itr->second.state = parsed ? PreparsedFile::State::DONE : PreparsedFile::State::FAILED;
+    itr->second.elems.swap( elems );
+  }
+  preparsed_cv.notify_all();
+}
+
+void ConfigFile::discard_preparsed()
+{
+  std::lock_guard<std::mutex> lock( preparsed_mutex );
+  preparsed_files.clear();
+}
+
+void ConfigFile::take_preparsed()
+{
+  std::unique_lock<std::mutex> lock( preparsed_mutex );
+  auto itr = preparsed_files.find( _filename );
+  if ( itr == preparsed_files.end() )
+    return;
+  PreparsedFile& file = itr->second;
+  if ( file.state == PreparsedFile::State::PENDING )
+  {
+    // nobody started yet, no need to wait for a free thread
+    lock.unlock();
+    preparse( _filename );
+    lock.lock();
+  }
+  preparsed_cv.wait( lock, [&]() { return file.state != PreparsedFile::State::PARSING; } );
+  if ( file.state == PreparsedFile::State::DONE )
+  {
+    // the last expected reader takes the elements, earlier ones a copy
+    if ( file.reads > 1 )
+      _preparsed = file.elems;
+    else
+      _preparsed.swap( file.elems );
+    _use_preparsed = true;
+    _preparsed_next = 0;
+    if ( --file.reads > 0 )
+      return;
+  }
+  preparsed_files.erase( itr );
+}
+
+bool ConfigFile::read_preparsed( ConfigElem& elem )
+{
+  if ( _preparsed_next == _preparsed.size() )
+    return false;
+  PreparsedElem& parsed = _preparsed[_preparsed_next++];
+  _element_line_start = parsed.line_start;
+  _cur_line = parsed.line_end;
+  elem.type_.swap( parsed.elem.type_ );
+  elem.rest_.swap( parsed.elem.rest_ );
+  elem.properties.swap( parsed.elem.properties );
+  check_allowed_type( elem.type_ );
+  return true;
+}
+
 ConfigFile::~ConfigFile()
 {
 #if !CFGFILE_USES_IOSTREAMS
@@ -627,10 +800,6 @@ ConfigFile::~ConfigFile()
 #endif
 }
 
-#if !CFGFILE_USES_IOSTREAMS
-char ConfigFile::buffer[1024];
-#endif
-
 #if CFGFILE_USES_IOSTREAMS
 // returns true if ended on a }, false if ended on EOF.
 bool ConfigFile::read_properties( ConfigElem& elem )
@@ -768,8 +937,8 @@ bool ConfigFile::readline( std::string& strbuf )
 // returns true if ended on a }, false if ended on EOF.
 bool ConfigFile::read_properties( ConfigElem& elem )
 {
-  static std::string strbuf;
-  static std::string propname, propvalue;
+  thread_local std::string strbuf;
+  thread_local std::string propname, propvalue;
   while ( readline( strbuf ) )
   {
     if ( !_cur_line )
@@ -803,8 +972,8 @@ bool ConfigFile::read_properties( ConfigElem& elem )
 }
 bool ConfigFile::read_properties( VectorConfigElem& elem )
 {
-  static std::string strbuf;
-  static std::string propname, propvalue;
+  thread_local std::string strbuf;
+  thread_local std::string propname, propvalue;
   while ( readline( strbuf ) )
   {
     if ( !_cur_line )
@@ -870,20 +1039,7 @@ bool ConfigFile::_read( ConfigElem& elem )
 
     elem.type_ = type;
 
-    if ( !allowed_types_.empty() )
-    {
-      if ( allowed_types_.find( type.c_str() ) == allowed_types_.end() )
-      {
-        OSTRINGSTREAM os;
-        os << "Unexpected type '" << type << "'" << std::endl;
-        os << "\tValid types are:";
-        for ( const auto& allowed : allowed_types_ )
-        {
-          os << " " << allowed.c_str();
-        }
-        throw std::runtime_error( OSTRINGSTREAM_STR( os ) );
-      }
-    }
+    check_allowed_type( type );
 
     elem.rest_ = rest;
 
@@ -939,20 +1095,7 @@ bool ConfigFile::_read( VectorConfigElem& elem )
 
     elem.type_ = type;
 
-    if ( !allowed_types_.empty() )
-    {
-      if ( allowed_types_.find( type.c_str() ) == allowed_types_.end() )
-      {
-        OSTRINGSTREAM os;
-        os << "Unexpected type '" << type << "'" << std::endl;
-        os << "\tValid types are:";
-        for ( const auto& allowed : allowed_types_ )
-        {
-          os << " " << allowed.c_str();
-        }
-        throw std::runtime_error( OSTRINGSTREAM_STR( os ) );
-      }
-    }
+    check_allowed_type( type );
 
     elem.rest_ = rest;
 
@@ -1036,6 +1179,8 @@ bool ConfigFile::read( ConfigElem& elem )
   try
   {
     elem._source = this;
+    if ( _use_preparsed )
+      return read_preparsed( elem );
     return _read( elem );
   }
   catch ( ... )
@@ -1049,6 +1194,7 @@ void ConfigFile::readraw( ConfigElem& elem )
   try
   {
     elem._source = this;
+    _use_preparsed = false;
     if ( read_properties( elem ) )
       throw std::runtime_error( "unexpected '}' in file" );
   }
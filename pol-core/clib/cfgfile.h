@@ -51,11 +51,28 @@ public:
 
   bool read( ConfigElem& elem );     // true=got one, false=end of file
   void readraw( ConfigElem& elem );  // reads 0 or more properties
+  // continues reading at the start of an element, like an offset remembered from an earlier
+  // scan of the file. Line numbers of errors count from there.
+  void seek( size_t offset );
 
   const std::string& filename() const;
   time_t modified() const;
   unsigned element_line_start() const;
 
+  /**
+   * Parsing of files ahead of their use, to parse independent files concurrently.
+   * expect() registers a file with the number of times it is going to be opened, preparse()
+   * parses it on any thread. A ConfigFile opened for a registered file reads the parsed elements
+   * instead of the file; it waits if the file is being parsed right now, or parses it itself if
+   * nobody started yet. Files which fail to parse are read from disk again, so the error is
+   * reported by the reader as usual.
+   */
+  static void expect( const std::string& filename, unsigned reads );
+  static void preparse( const std::string& filename );
+  // drops the files not read yet
+  static void discard_preparsed();
+  struct PreparsedElem;
+
 
 protected:
   void init( const char* i_filename, const char* allowed_types_str );
@@ -71,6 +88,11 @@ protected:
                               bool error = true ) const override;
   [[noreturn]] void display_and_rethrow_exception();
   void register_allowed_type( const char* allowed_type );
+  void check_allowed_type( const std::string& type ) const;
+  void open_file( const char* i_filename );
+  void take_preparsed();
+  bool read_preparsed( ConfigElem& elem );
+  static bool parse_all( const std::string& filename, std::vector<PreparsedElem>& elems );
 
 private:
   std::string _filename;  // saved for exception reporting
@@ -79,11 +101,15 @@ private:
   std::ifstream ifs;
 #else
   FILE* fp;
-  static char buffer[1024];
+  char buffer[1024];
 #endif
   int _element_line_start;  // what line in the file did this elem start on?
   int _cur_line;
 
+  bool _use_preparsed;
+  std::vector<PreparsedElem> _preparsed;
+  size_t _preparsed_next;
+
   typedef std::set<std::string, ci_cmp_pred> AllowedTypesCont;
   AllowedTypesCont allowed_types_;
 };
@@ -0,0 +1,612 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "mappedcfgfile.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <exception>
+#include <stdlib.h>
+#include <string.h>
+#include <utf8/utf8.h>
+
+#include "cfgelem.h"
+#include "clib.h"
+#include "logfacility.h"
+#include "stlutil.h"
+#include "strutil.h"
+
+
+namespace Pol
+{
+namespace Clib
+{
+namespace
+{
+const char* const WHITESPACE = " \t\r\n";
+
+bool name_is( std::string_view name, const char* propname )
+{
+  return strnicmp( name.data(), propname, name.size() ) == 0 && propname[name.size()] == '\0';
+}
+
+bool name_less( std::string_view a, std::string_view b )
+{
+  int cmp = strnicmp( a.data(), b.data(), std::min( a.size(), b.size() ) );
+  return cmp < 0 || ( cmp == 0 && a.size() < b.size() );
+}
+
+bool commentline( std::string_view name )
+{
+  return name[0] == '#' || name.substr( 0, 2 ) == "//";
+}
+
+// same split as splitnamevalue()
+void splitnamevalue( std::string_view line, std::string_view& name, std::string_view& value )
+{
+  name = value = std::string_view();
+  size_t start = line.find_first_not_of( WHITESPACE );
+  if ( start == std::string_view::npos )
+    return;
+  size_t delimpos = line.find_first_of( " \t\r\n=", start + 1 );
+  if ( delimpos == std::string_view::npos )
+  {
+    name = line.substr( start );
+    return;
+  }
+  name = line.substr( start, delimpos - start );
+  size_t valuestart = line.find_first_not_of( WHITESPACE, delimpos + 1 );
+  if ( valuestart != std::string_view::npos )
+    value = line.substr( valuestart, line.find_last_not_of( WHITESPACE ) - valuestart + 1 );
+}
+
+// strtoul and friends need a terminated string, a value can end with the mapping
+template <class F>
+auto with_cstr( std::string_view value, F func )
+{
+  char buf[64];
+  if ( value.size() < sizeof buf )
+  {
+    memcpy( buf, value.data(), value.size() );
+    buf[value.size()] = '\0';
+    return func( static_cast<const char*>( buf ) );
+  }
+  std::string tmp( value );
+  return func( tmp.c_str() );
+}
+}  // namespace
+
+ConfigElemView::ConfigElemView() : _source( nullptr ) {}
+
+bool ConfigElemView::type_is( const char* name ) const
+{
+  return name_is( type_, name );
+}
+
+std::string_view ConfigElemView::type() const
+{
+  return type_;
+}
+
+std::string_view ConfigElemView::rest() const
+{
+  return rest_;
+}
+
+ConfigElemView::Props::iterator ConfigElemView::find( const char* propname )
+{
+  auto itr = properties.begin();
+  for ( ; itr != properties.end(); ++itr )
+  {
+    if ( name_is( itr->name, propname ) )
+      break;
+  }
+  return itr;
+}
+
+ConfigElemView::Props::const_iterator ConfigElemView::find( const char* propname ) const
+{
+  return const_cast<ConfigElemView*>( this )->find( propname );
+}
+
+bool ConfigElemView::has_prop( const char* propname ) const
+{
+  return find( propname ) != properties.end();
+}
+
+// the properties of a ConfigElem come in case insensitive name order, equal names in file order
+bool ConfigElemView::remove_first_prop( std::string* propname, std::string* value )
+{
+  if ( properties.empty() )
+    return false;
+  auto first = properties.begin();
+  for ( auto itr = first + 1; itr != properties.end(); ++itr )
+  {
+    if ( name_less( itr->name, first->name ) )
+      first = itr;
+  }
+  *propname = first->name;
+  *value = first->value;
+  properties.erase( first );
+  return true;
+}
+
+bool ConfigElemView::remove_prop( const char* propname, std::string_view* value )
+{
+  auto itr = find( propname );
+  if ( itr == properties.end() )
+    return false;
+  *value = itr->value;
+  properties.erase( itr );
+  return true;
+}
+
+bool ConfigElemView::remove_prop( const char* propname, std::string* value )
+{
+  std::string_view temp;
+  if ( !remove_prop( propname, &temp ) )
+    return false;
+  *value = temp;
+  return true;
+}
+
+bool ConfigElemView::read_prop( const char* propname, std::string_view* value ) const
+{
+  auto itr = find( propname );
+  if ( itr == properties.end() )
+    return false;
+  *value = itr->value;
+  return true;
+}
+
+bool ConfigElemView::read_prop( const char* propname, std::string* value ) const
+{
+  std::string_view temp;
+  if ( !read_prop( propname, &temp ) )
+    return false;
+  *value = temp;
+  return true;
+}
+
+void ConfigElemView::get_prop( const char* propname, unsigned int* plong ) const
+{
+  std::string_view temp;
+  if ( !read_prop( propname, &temp ) )
+    throw_error( "SERIAL property not found" );
+  *plong = with_cstr( temp, []( const char* s ) { return strtoul( s, nullptr, 0 ); } );
+}
+
+bool ConfigElemView::remove_prop( const char* propname, unsigned int* plong )
+{
+  std::string_view temp;
+  if ( !remove_prop( propname, &temp ) )
+    return false;
+  *plong = with_cstr( temp, []( const char* s ) { return strtoul( s, nullptr, 0 ); } );
+  return true;
+}
+
+bool ConfigElemView::remove_prop( const char* propname, unsigned short* psval )
+{
+  std::string_view temp;
+  if ( !remove_prop( propname, &temp ) )
+    return false;
+  bool wellformed = with_cstr( temp,
+                               [&]( const char* s )
+                               {
+                                 char* endptr = nullptr;
+                                 *psval = (unsigned short)strtoul( s, &endptr, 0 );
+                                 return endptr == nullptr || *endptr == '\0' || isspace( *endptr );
+                               } );
+  if ( !wellformed )
+  {
+    std::string errmsg;
+    errmsg = "Poorly formed number in property '";
+    errmsg += propname;
+    errmsg += "': ";
+    errmsg += temp;
+    throw_error( errmsg );
+  }
+  return true;
+}
+
+void ConfigElemView::throw_error( const std::string& errmsg ) const
+{
+  if ( _source != nullptr )
+    _source->display_error( errmsg, false, this, true );
+  throw std::runtime_error( "Configuration file error" );
+}
+
+void ConfigElemView::warn( const std::string& errmsg ) const
+{
+  if ( _source != nullptr )
+    _source->display_error( errmsg, false, this, false );
+}
+
+void ConfigElemView::warn_with_line( const std::string& errmsg ) const
+{
+  if ( _source != nullptr )
+    _source->display_error( errmsg, true, this, false );
+}
+
+void ConfigElemView::prop_not_found( const char* propname ) const
+{
+  std::string errmsg( "Property '" );
+  errmsg += propname;
+  errmsg += "' was not found.";
+  throw_error( errmsg );
+}
+
+unsigned short ConfigElemView::remove_ushort( const char* propname )
+{
+  unsigned short temp;
+  if ( !remove_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return temp;
+}
+
+unsigned short ConfigElemView::remove_ushort( const char* propname, unsigned short dflt )
+{
+  unsigned short temp;
+  if ( remove_prop( propname, &temp ) )
+    return temp;
+  return dflt;
+}
+
+int ConfigElemView::remove_int( const char* propname )
+{
+  std::string_view temp;
+  if ( !remove_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return with_cstr( temp, []( const char* s ) { return atoi( s ); } );
+}
+
+int ConfigElemView::remove_int( const char* propname, int dflt )
+{
+  std::string_view temp;
+  if ( remove_prop( propname, &temp ) )
+    return with_cstr( temp, []( const char* s ) { return atoi( s ); } );
+  return dflt;
+}
+
+unsigned ConfigElemView::remove_unsigned( const char* propname )
+{
+  std::string_view temp;
+  if ( !remove_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return with_cstr( temp, []( const char* s ) { return strtoul( s, nullptr, 0 ); } );
+}
+
+unsigned ConfigElemView::remove_unsigned( const char* propname, int dflt )
+{
+  std::string_view temp;
+  if ( remove_prop( propname, &temp ) )
+    return with_cstr( temp, []( const char* s ) { return strtoul( s, nullptr, 0 ); } );
+  return dflt;
+}
+
+std::string ConfigElemView::remove_string( const char* propname )
+{
+  std::string temp;
+  if ( !remove_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return temp;
+}
+
+std::string ConfigElemView::remove_string( const char* propname, const char* dflt )
+{
+  std::string temp;
+  if ( remove_prop( propname, &temp ) )
+    return temp;
+  return dflt;
+}
+
+std::string ConfigElemView::read_string( const char* propname ) const
+{
+  std::string temp;
+  if ( !read_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return temp;
+}
+
+std::string ConfigElemView::read_string( const char* propname, const char* dflt ) const
+{
+  std::string temp;
+  if ( read_prop( propname, &temp ) )
+    return temp;
+  return dflt;
+}
+
+bool ConfigElemView::remove_bool( const char* propname )
+{
+  return remove_ushort( propname ) ? true : false;
+}
+
+bool ConfigElemView::remove_bool( const char* propname, bool dflt )
+{
+  return remove_ushort( propname, dflt ) ? true : false;
+}
+
+float ConfigElemView::remove_float( const char* propname, float dflt )
+{
+  std::string_view temp;
+  if ( remove_prop( propname, &temp ) )
+    return with_cstr( temp,
+                      []( const char* s ) { return static_cast<float>( strtod( s, nullptr ) ); } );
+  return dflt;
+}
+
+double ConfigElemView::remove_double( const char* propname, double dflt )
+{
+  std::string_view temp;
+  if ( remove_prop( propname, &temp ) )
+    return with_cstr( temp, []( const char* s ) { return strtod( s, nullptr ); } );
+  return dflt;
+}
+
+unsigned int ConfigElemView::remove_ulong( const char* propname )
+{
+  unsigned int temp;
+  if ( !remove_prop( propname, &temp ) )
+    prop_not_found( propname );  // prop_not_found throws
+  return temp;
+}
+
+unsigned int ConfigElemView::remove_ulong( const char* propname, unsigned int dflt )
+{
+  unsigned int temp;
+  if ( remove_prop( propname, &temp ) )
+    return temp;
+  return dflt;
+}
+
+void ConfigElemView::clear_prop( const char* propname )
+{
+  for ( auto itr = properties.begin(); itr != properties.end(); )
+  {
+    if ( name_is( itr->name, propname ) )
+      itr = properties.erase( itr );
+    else
+      ++itr;
+  }
+}
+
+void ConfigElemView::copy_to( ConfigElem& elem ) const
+{
+  elem.set_type( std::string( type_ ).c_str() );
+  elem.set_rest( std::string( rest_ ).c_str() );
+  elem.set_source( _source );
+  std::string name, value;
+  while ( elem.remove_first_prop( &name, &value ) )
+    continue;
+  for ( const auto& prop : properties )
+    elem.add_prop( std::string( prop.name ), std::string( prop.value ) );
+}
+
+MappedConfigFile::MappedConfigFile( const std::string& filename, const char* allowed_types )
+    : _filename( filename ),
+      _file( filename ),
+      _pos( _file.data() ),
+      _end( _file.data() + _file.size() ),
+      _element_line_start( 0 ),
+      _cur_line( 0 ),
+      allowed_types_()
+{
+  if ( allowed_types != nullptr )
+  {
+    ISTRINGSTREAM is( allowed_types );
+    std::string tag;
+    while ( is >> tag )
+    {
+      allowed_types_.insert( tag.c_str() );
+    }
+  }
+}
+
+const std::string& MappedConfigFile::filename() const
+{
+  return _filename;
+}
+
+unsigned MappedConfigFile::element_line_start() const
+{
+  return _element_line_start;
+}
+
+/**
+ * Next line of the file without the line break.
+ * Lines with invalid utf8 are converted like sanitizeUnicodeWithIso() does and stored in the
+ * element, every other line stays in the mapping.
+ */
+bool MappedConfigFile::readline( std::string_view& line, ConfigElemView& elem )
+{
+  if ( _pos == _end )
+    return false;
+  const char* eol = static_cast<const char*>( memchr( _pos, '\n', _end - _pos ) );
+  const char* next = eol != nullptr ? eol + 1 : _end;
+  if ( eol == nullptr )
+    eol = _end;
+  else if ( eol != _pos && *( eol - 1 ) == '\r' )
+    --eol;
+  line = std::string_view( _pos, eol - _pos );
+  _pos = next;
+
+  if ( !_cur_line && line.size() >= 3 && utf8::starts_with_bom( line.begin(), line.end() ) )
+    line.remove_prefix( 3 );
+  ++_cur_line;
+
+  for ( char ch : line )
+  {
+    if ( ch & 0x80 )
+    {
+      if ( utf8::find_invalid( line.begin(), line.end() ) != line.end() )
+      {
+        std::string sanitized( line );
+        sanitizeUnicodeWithIso( &sanitized );
+        elem.decoded_.push_back( std::move( sanitized ) );
+        line = elem.decoded_.back();
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+// returns true if ended on a }, false if ended on EOF.
+bool MappedConfigFile::read_properties( ConfigElemView& elem )
+{
+  std::string_view line, propname, propvalue;
+  while ( readline( line, elem ) )
+  {
+    splitnamevalue( line, propname, propvalue );
+
+    if ( propname.empty() ||  // empty line
+         commentline( propname ) )
+    {
+      continue;
+    }
+
+    if ( propname == "}" )
+      return true;
+
+    if ( !propvalue.empty() && propvalue[0] == '\"' )
+    {
+      // unescaped strings are used as they are, see decodequotedstring()
+      size_t special = propvalue.find_first_of( "\\\"", 1 );
+      if ( special == std::string_view::npos || propvalue[special] == '\"' )
+      {
+        size_t len = special == std::string_view::npos ? special : special - 1;
+        propvalue = propvalue.substr( 1, len );
+      }
+      else
+      {
+        std::string decoded( propvalue );
+        decodequotedstring( decoded );
+        elem.decoded_.push_back( std::move( decoded ) );
+        propvalue = elem.decoded_.back();
+      }
+    }
+
+    elem.properties.push_back( ConfigElemView::Prop{ propname, propvalue } );
+  }
+  return false;
+}
+
+bool MappedConfigFile::_read( ConfigElemView& elem )
+{
+  elem.properties.clear();
+  elem.decoded_.clear();
+  elem.type_ = std::string_view();
+  elem.rest_ = std::string_view();
+
+  _element_line_start = 0;
+
+  std::string_view line, type, rest;
+  while ( readline( line, elem ) )
+  {
+    splitnamevalue( line, type, rest );
+
+    if ( type.empty() ||  // empty line
+         commentline( type ) )
+    {
+      continue;
+    }
+
+    _element_line_start = _cur_line;
+
+    elem.type_ = type;
+
+    check_allowed_type( type );
+
+    elem.rest_ = rest;
+
+    if ( !readline( line, elem ) )
+      throw std::runtime_error( "File ends after element type -- expected a '{'" );
+
+    if ( line.empty() || line[0] != '{' )
+    {
+      throw std::runtime_error( "Expected '{' on a blank line after element type" );
+    }
+
+    if ( read_properties( elem ) )
+      return true;
+    else
+      throw std::runtime_error( "Expected '}' on a blank line after element properties" );
+  }
+  return false;
+}
+
+bool MappedConfigFile::read( ConfigElemView& elem )
+{
+  try
+  {
+    elem._source = this;
+    return _read( elem );
+  }
+  catch ( std::exception& ex )
+  {
+    display_error( ex.what() );
+  }
+  catch ( ... )
+  {
+    display_error( "(Generic exception)" );
+  }
+  throw std::runtime_error( "Configuration file error." );
+}
+
+void MappedConfigFile::check_allowed_type( std::string_view type ) const
+{
+  if ( allowed_types_.empty() ||
+       allowed_types_.find( std::string( type ) ) != allowed_types_.end() )
+    return;
+  std::string msg = "Unexpected type '";
+  msg += type;
+  msg += "'\n\tValid types are:";
+  for ( const auto& allowed : allowed_types_ )
+  {
+    msg += " ";
+    msg += allowed;
+  }
+  throw std::runtime_error( msg );
+}
+
+void MappedConfigFile::display_error( const std::string& msg, bool show_curline,
+                                      const ConfigElemBase* elem, bool error ) const
+{
+  if ( elem != nullptr )
+    print_error( msg, show_curline, elem->type(), elem->rest(), error );
+  else
+    print_error( msg, show_curline, std::string_view(), std::string_view(), error );
+}
+
+void MappedConfigFile::display_error( const std::string& msg, bool show_curline,
+                                      const ConfigElemView* elem, bool error ) const
+{
+  print_error( msg, show_curline, elem->type(), elem->rest(), error );
+}
+
+void MappedConfigFile::print_error( const std::string& msg, bool show_curline,
+                                    std::string_view type, std::string_view rest, bool error ) const
+{
+  std::string tmp = fmt::format(
+      " {} reading configuration file {}:\n"
+      "\t{}",
+      error ? "Error" : "Warning", _filename, msg );
+
+  if ( !type.empty() )
+  {
+    tmp += fmt::format( "\n\tElement: {} {}", type, rest );
+    if ( _element_line_start )
+      tmp += fmt::format( ", found on line {}", _element_line_start );
+  }
+
+  if ( show_curline )
+    tmp += fmt::format( "\n\tNear line: {}", _cur_line );
+  if ( _element_line_start && type.empty() )
+    tmp += fmt::format( "\n\tElement started on line: {}", _element_line_start );
+  ERROR_PRINTLN( tmp );
+}
+}  // namespace Clib
+}  // namespace Pol
@@ -0,0 +1,154 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_MAPPEDCFGFILE_H
+#define CLIB_MAPPEDCFGFILE_H
+
+#include <boost/container/small_vector.hpp>
+#include <deque>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "cfgfile.h"
+#include "mappedfile.h"
+#include "maputil.h"
+
+namespace Pol
+{
+namespace Clib
+{
+class ConfigElem;
+class MappedConfigFile;
+
+/**
+ * Element read by a MappedConfigFile, with the remove/read calls of ConfigElem.
+ * Type, rest and properties point into the mapped file, only values which need to be changed
+ * (escaped quoted strings, non utf8 lines) are copied. They stay valid until the next read into
+ * this element and must not outlive the file.
+ */
+class ConfigElemView
+{
+public:
+  ConfigElemView();
+  ConfigElemView( const ConfigElemView& ) = delete;
+  ConfigElemView& operator=( const ConfigElemView& ) = delete;
+
+  bool type_is( const char* name ) const;
+  std::string_view type() const;
+  std::string_view rest() const;
+
+  bool has_prop( const char* propname ) const;
+
+  std::string remove_string( const char* propname );
+  std::string remove_string( const char* propname, const char* dflt );
+
+  unsigned short remove_ushort( const char* propname );
+  unsigned short remove_ushort( const char* propname, unsigned short dflt );
+
+  int remove_int( const char* propname );
+  int remove_int( const char* propname, int dflt );
+
+  unsigned remove_unsigned( const char* propname );
+  unsigned remove_unsigned( const char* propname, int dflt );
+
+  unsigned int remove_ulong( const char* propname );
+  unsigned int remove_ulong( const char* propname, unsigned int dflt );
+
+  bool remove_bool( const char* propname );
+  bool remove_bool( const char* propname, bool dflt );
+
+  float remove_float( const char* propname, float dflt );
+  double remove_double( const char* propname, double dflt );
+
+  void clear_prop( const char* propname );
+
+  bool remove_first_prop( std::string* propname, std::string* value );
+  bool remove_prop( const char* propname, std::string* value );
+  bool remove_prop( const char* propname, std::string_view* value );
+  bool remove_prop( const char* propname, unsigned int* plong );
+  bool remove_prop( const char* propname, unsigned short* pushort );
+
+  bool read_prop( const char* propname, std::string* value ) const;
+  bool read_prop( const char* propname, std::string_view* value ) const;
+
+  // get_prop calls: don't remove, and throw if not found.
+  void get_prop( const char* propname, unsigned int* plong ) const;
+
+  std::string read_string( const char* propname ) const;
+  std::string read_string( const char* propname, const char* dflt ) const;
+
+  // copy of the remaining properties, for code expecting a ConfigElem
+  void copy_to( ConfigElem& elem ) const;
+
+  [[noreturn]] void throw_error( const std::string& errmsg ) const;
+  void warn( const std::string& errmsg ) const;
+  void warn_with_line( const std::string& errmsg ) const;
+
+protected:
+  friend class MappedConfigFile;
+  [[noreturn]] void prop_not_found( const char* propname ) const;
+  struct Prop
+  {
+    std::string_view name;
+    std::string_view value;
+  };
+  typedef boost::container::small_vector<Prop, 16> Props;
+  Props::iterator find( const char* propname );
+  Props::const_iterator find( const char* propname ) const;
+
+  std::string_view type_;
+  std::string_view rest_;
+  Props properties;
+  // storage of the values which are not a part of the file
+  std::deque<std::string> decoded_;
+
+  const MappedConfigFile* _source;
+};
+
+/**
+ * Reader of the config file format of ConfigFile, which maps the whole file and tokenizes it in
+ * place instead of copying every line, name and value into strings.
+ * Meant for the big files read once from start to end, like the world and data files.
+ */
+class MappedConfigFile : public ConfigSource
+{
+public:
+  explicit MappedConfigFile( const std::string& filename, const char* allowed_types = nullptr );
+
+  bool read( ConfigElemView& elem );  // true=got one, false=end of file
+
+  const std::string& filename() const;
+  unsigned element_line_start() const;
+
+  virtual void display_error( const std::string& msg, bool show_curline = true,
+                              const ConfigElemBase* elem = nullptr,
+                              bool error = true ) const override;
+  void display_error( const std::string& msg, bool show_curline, const ConfigElemView* elem,
+                      bool error ) const;
+
+protected:
+  bool readline( std::string_view& line, ConfigElemView& elem );
+  bool _read( ConfigElemView& elem );
+  bool read_properties( ConfigElemView& elem );
+  void check_allowed_type( std::string_view type ) const;
+  void print_error( const std::string& msg, bool show_curline, std::string_view type,
+                    std::string_view rest, bool error ) const;
+
+private:
+  std::string _filename;
+  MappedFile _file;
+  const char* _pos;
+  const char* _end;
+  int _element_line_start;  // what line in the file did this elem start on?
+  int _cur_line;
+
+  typedef std::set<std::string, ci_cmp_pred> AllowedTypesCont;
+  AllowedTypesCont allowed_types_;
+};
+}  // namespace Clib
+}  // namespace Pol
+#endif
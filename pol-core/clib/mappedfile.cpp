@@ -0,0 +1,97 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "mappedfile.h"
+#include "Header_Windows.h"
+
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Pol
+{
+namespace Clib
+{
+#ifdef _WIN32
+MappedFile::MappedFile( const std::string& filename )
+    : _data( "" ), _size( 0 ), _file( INVALID_HANDLE_VALUE ), _mapping( nullptr )
+{
+  _file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+  if ( _file == INVALID_HANDLE_VALUE )
+    throw std::runtime_error( "Unable to open " + filename + " for reading." );
+  LARGE_INTEGER size;
+  if ( !GetFileSizeEx( _file, &size ) )
+  {
+    CloseHandle( _file );
+    throw std::runtime_error( "Unable to get the size of " + filename );
+  }
+  // an empty file cannot be mapped
+  if ( size.QuadPart == 0 )
+    return;
+  _mapping = CreateFileMappingA( _file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  const void* data =
+      _mapping != nullptr ? MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+  if ( data == nullptr )
+  {
+    if ( _mapping != nullptr )
+      CloseHandle( _mapping );
+    CloseHandle( _file );
+    throw std::runtime_error( "Unable to map " + filename + " into memory." );
+  }
+  _data = static_cast<const char*>( data );
+  _size = static_cast<size_t>( size.QuadPart );
+}
+
+MappedFile::~MappedFile()
+{
+  if ( _size )
+    UnmapViewOfFile( _data );
+  if ( _mapping != nullptr )
+    CloseHandle( _mapping );
+  CloseHandle( _file );
+}
+#else
+MappedFile::MappedFile( const std::string& filename ) : _data( "" ), _size( 0 )
+{
+  int fd = ::open( filename.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    throw std::runtime_error( "Unable to open " + filename + " for reading." );
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 )
+  {
+    ::close( fd );
+    throw std::runtime_error( "Unable to get the size of " + filename );
+  }
+  // an empty file cannot be mapped
+  if ( st.st_size == 0 )
+  {
+    ::close( fd );
+    return;
+  }
+  void* data = mmap( nullptr, static_cast<size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+  // the mapping keeps its own reference to the file
+  ::close( fd );
+  if ( data == MAP_FAILED )
+    throw std::runtime_error( "Unable to map " + filename + " into memory." );
+  madvise( data, static_cast<size_t>( st.st_size ), MADV_SEQUENTIAL );
+  _data = static_cast<const char*>( data );
+  _size = static_cast<size_t>( st.st_size );
+}
+
+MappedFile::~MappedFile()
+{
+  if ( _size )
+    munmap( const_cast<char*>( _data ), _size );
+}
+#endif
+}  // namespace Clib
+}  // namespace Pol
@@ -0,0 +1,45 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_MAPPEDFILE_H
+#define CLIB_MAPPEDFILE_H
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+
+namespace Pol
+{
+namespace Clib
+{
+/**
+ * Read-only memory mapping of a whole file.
+ * The contents stay valid until the object is destroyed, throws std::runtime_error if the file
+ * cannot be opened or mapped.
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile( const std::string& filename );
+  ~MappedFile();
+  MappedFile( const MappedFile& ) = delete;
+  MappedFile& operator=( const MappedFile& ) = delete;
+
+  const char* data() const { return _data; }
+  size_t size() const { return _size; }
+  std::string_view view() const { return std::string_view( _data, _size ); }
+
+private:
+  const char* _data;
+  size_t _size;
+#ifdef _WIN32
+  void* _file;
+  void* _mapping;
+#endif
+};
+}  // namespace Clib
+}  // namespace Pol
+#endif
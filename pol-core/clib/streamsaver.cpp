@@ -1,16 +1,38 @@
 #include <exception>
+#include <filesystem>
 #include <fstream>
 #include <ios>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "streamsaver.h"
 
 namespace Pol::Clib
 {
-StreamWriter::StreamWriter( const std::string& path ) : _file( fopen( path.c_str(), "wb+" ) )
+StreamWriter::StreamWriter() : _file( nullptr ), _written( 0 ), _buffer_limit( 0 ) {}
+
+StreamWriter::StreamWriter( const std::string& path )
+    : _file( fopen( path.c_str(), "wb+" ) ), _written( 0 ), _buffer_limit( 0 )
+{
+  if ( !_file )
+    throw std::runtime_error{ fmt::format( "failed to open {}", path ) };
+  setbuf( _file, nullptr );  // disable buffer
+}
+
+StreamWriter::StreamWriter( const std::string& path, size_t offset )
+    : _file( nullptr ), _written( offset ), _buffer_limit( 0 )
 {
+  if ( offset == 0 )
+  {
+    _file = fopen( path.c_str(), "wb" );
+  }
+  else
+  {
+    std::filesystem::resize_file( path, offset );
+    _file = fopen( path.c_str(), "ab" );
+  }
   if ( !_file )
     throw std::runtime_error{ fmt::format( "failed to open {}", path ) };
   setbuf( _file, nullptr );  // disable buffer
@@ -31,6 +53,39 @@ StreamWriter::~StreamWriter() noexcept( false )
   }
 }
 
+void StreamWriter::append( const StreamWriter& part )
+{
+  if ( !_file )
+  {
+    _mbuff.append( part._mbuff.begin(), part._mbuff.end() );
+    return;
+  }
+  // write directly instead of copying possibly big parts into the buffer
+  auto write = [this]( const auto& buff )
+  {
+    auto size = fwrite( buff.data(), sizeof( char ), buff.size(), _file );
+    if ( size < buff.size() )
+      throw std::runtime_error{ "failed to write" };
+  };
+  write( _mbuff );
+  write( part._mbuff );
+  _written += _mbuff.size() + part._mbuff.size();
+  _mbuff.clear();
+}
+
+void StreamWriter::set_buffer_handler( size_t limit,
+                                       std::function<void( StreamWriter& )> handler )
+{
+  _buffer_limit = limit;
+  _buffer_handler = std::move( handler );
+}
+
+void StreamWriter::move_to( StreamWriter& file )
+{
+  file.append( *this );
+  _mbuff.clear();
+}
+
 void StreamWriter::flush_close()
 {
   if ( !_file )
@@ -40,6 +95,7 @@ void StreamWriter::flush_close()
     auto size = fwrite( _mbuff.data(), sizeof( char ), _mbuff.size(), _file );
     if ( size < _mbuff.size() )
       throw std::runtime_error{ "failed to write" };
+    _written += size;
   }
   _mbuff.clear();
   fclose( _file );
@@ -5,6 +5,7 @@
 #include <fmt/os.h>
 #include <fmt/ostream.h>
 #include <fstream>
+#include <functional>
 #include <iosfwd>
 #include <iterator>
 #include <stdio.h>
@@ -16,7 +17,11 @@ namespace Pol::Clib
 class StreamWriter
 {
 public:
+  // in memory only, for formatting parts of a file concurrently, see append()
+  StreamWriter();
   StreamWriter( const std::string& path );
+  // continues an existing file at offset, everything behind it is discarded
+  StreamWriter( const std::string& path, size_t offset );
   ~StreamWriter() noexcept( false );
   StreamWriter( const StreamWriter& ) = delete;
   StreamWriter& operator=( const StreamWriter& ) = delete;
@@ -54,21 +59,40 @@ public:
   {
     using namespace std::literals;
     _mbuff.append( "}\n\n"sv );
-    if ( _mbuff.size() > 0x8000 )
+    if ( _file && _mbuff.size() > 0x8000 )
     {
       auto size = fwrite( _mbuff.data(), sizeof( char ), _mbuff.size(), _file );
       if ( size < _mbuff.size() )
         throw std::runtime_error{ "failed to write" };
+      _written += size;
       _mbuff.clear();
     }
+    else if ( _buffer_handler && _mbuff.size() > _buffer_limit )
+    {
+      _buffer_handler( *this );
+    }
   }
+  // in memory only: handler is called from end() whenever the buffer exceeds limit bytes, it can
+  // move the buffer elsewhere or change the limit
+  void set_buffer_handler( size_t limit, std::function<void( StreamWriter& )> handler );
+  void set_buffer_limit( size_t limit ) { _buffer_limit = limit; }
+  size_t buffered() const { return _mbuff.size(); }
+  // appends the buffer to file and clears it
+  void move_to( StreamWriter& file );
+  // file offset the next output goes to
+  size_t tell() const { return _written + _mbuff.size(); }
+  // appends the content of an in memory writer
+  void append( const StreamWriter& part );
   void flush_close();
 
 protected:
   FILE* _file;
+  size_t _written;
   // formatting creates a temp buffer
   // to prevent this format into this buffer and when full write to disk, clear of the buffer keeps
   // the capacity
   fmt::basic_memory_buffer<char, 0x8000> _mbuff;
+  std::function<void( StreamWriter& )> _buffer_handler;
+  size_t _buffer_limit;
 };
 }  // namespace Pol::Clib
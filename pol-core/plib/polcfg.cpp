@@ -13,6 +13,7 @@
 
 #include "polcfg.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <exception>
 #include <sstream>
@@ -61,6 +62,11 @@ void PolConfig::read( bool initial_load )
     count_resource_tiles = elem.remove_bool( "CountResourceTiles", false );
     web_server = elem.remove_bool( "WebServer", false );
     web_server_port = elem.remove_ushort( "WebServerPort", 8080 );
+    web_server_keep_alive = elem.remove_bool( "WebServerKeepAlive", false );
+    web_server_keep_alive_timeout =
+        std::max<unsigned short>( elem.remove_ushort( "WebServerKeepAliveTimeout", 15 ), 1 );
+    sql_worker_threads = std::max<unsigned short>( elem.remove_ushort( "SQLWorkerThreads", 1 ), 1 );
+    sql_connection_pool_size = elem.remove_ushort( "SQLConnectionPoolSize", 0 );
 
     unsigned short max_tile = elem.remove_ushort( "MaxTileID", 0 );
     if ( max_tile != UOBJ_DEFAULT_MAX && max_tile != UOBJ_SA_MAX && max_tile != UOBJ_HSA_MAX &&
@@ -96,12 +102,17 @@ void PolConfig::read( bool initial_load )
   watch_sysload = elem.remove_bool( "WatchSysLoad", false );
   log_sysload = elem.remove_bool( "LogSysLoad", false );
   inhibit_saves = elem.remove_bool( "InhibitSaves", false );
+  snapshot_saves = elem.remove_bool( "SnapshotSaves", false );
   log_script_cycles = elem.remove_bool( "LogScriptCycles", false );
   web_server_local_only = elem.remove_bool( "WebServerLocalOnly", true );
   web_server_debug = elem.remove_ushort( "WebServerDebug", 0 );
   web_server_password = elem.remove_string( "WebServerPassword", "" );
 
   profile_cprops = elem.remove_bool( "ProfileCProps", false );
+  cache_cprops = elem.remove_bool( "CacheCProps", false );
+  cprop_pack_format = elem.remove_ushort( "CPropPackFormat", 1 );
+  if ( cprop_pack_format != 1 && cprop_pack_format != 2 )
+    cprop_pack_format = 1;
 
   cache_interactive_scripts = elem.remove_bool( "CacheInteractiveScripts", true );
   show_speech_colors = elem.remove_bool( "ShowSpeechColors", false );
@@ -131,6 +142,7 @@ void PolConfig::read( bool initial_load )
   report_critical_scripts = elem.remove_bool( "ReportCriticalScripts", true );
   report_missing_configs = elem.remove_bool( "ReportMissingConfigs", true );
   max_clients = elem.remove_ushort( "MaximumClients", 300 );
+  client_bandwidth_limit = elem.remove_ulong( "ClientBandwidthLimit", 0 );
   character_slots = elem.remove_ushort( "CharacterSlots", 5 );
   max_clients_bypass_cmdlevel = elem.remove_ushort( "MaximumClientsBypassCmdLevel", 1 );
   allow_multi_clients_per_account = elem.remove_bool( "AllowMultiClientsPerAccount", false );
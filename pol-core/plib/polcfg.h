@@ -35,14 +35,21 @@ struct PolConfig
   bool watch_mapcache;
   bool check_integrity;
   bool inhibit_saves;
+  bool snapshot_saves;
   bool log_script_cycles;
   bool count_resource_tiles;
   bool web_server;
   unsigned short web_server_port;
+  bool web_server_keep_alive;
+  unsigned short web_server_keep_alive_timeout;
   bool web_server_local_only;
   unsigned short web_server_debug;
   std::string web_server_password;
+  unsigned short sql_worker_threads;
+  unsigned short sql_connection_pool_size;
   bool profile_cprops;
+  bool cache_cprops;
+  unsigned short cprop_pack_format;
   bool cache_interactive_scripts;
   bool show_speech_colors;
   bool require_spellbooks;
@@ -63,6 +70,7 @@ struct PolConfig
   bool logfile_timestamp_everyline;
 
   unsigned short max_clients;
+  std::atomic<unsigned int> client_bandwidth_limit;
   unsigned short character_slots;
   unsigned short max_clients_bypass_cmdlevel;
   bool allow_multi_clients_per_account;
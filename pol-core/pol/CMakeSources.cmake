@@ -265,6 +265,9 @@ set (pol_sources  # sorted !
   network/packethooks.cpp
   network/packethooks.h
   network/packetinterface.h
+  network/packetpriority.h
+  network/packetrules.cpp
+  network/packetrules.h
   network/packets.cpp
   network/packets.h
   network/pktboth.h
@@ -325,6 +328,8 @@ set (pol_sources  # sorted !
   realms/realm.h
   realms/realmfunc.cpp
   realms/realmlos.cpp
+  realms/realmtask.cpp
+  realms/realmtask.h
   reftypes.cpp
   reftypes.h
   regions/region.cpp
@@ -387,6 +392,8 @@ set (pol_sources  # sorted !
   tasks.h
   testing/poltest.cpp
   testing/poltest.h
+  testing/testaccounts.cpp
+  testing/testcfgfile.cpp
   testing/testclamp.cpp
   testing/testdecay.cpp
   testing/testdrop.cpp
@@ -395,11 +402,16 @@ set (pol_sources  # sorted !
   testing/testexpansion.cpp
   testing/testlos.cpp
   testing/testmisc.cpp
+  testing/testpack.cpp
   testing/testpos.cpp
   testing/testrange.cpp
+  testing/testrealmtask.cpp
+  testing/testsavedata.cpp
+  testing/testregion.cpp
   testing/testskill.cpp
   testing/testvector.cpp
   testing/testwalk.cpp
+  testing/testworlditerator.cpp
   textcmd.cpp
   textcmd.h
   tildecmd.cpp
@@ -23,6 +23,7 @@
 #include "../../clib/logfacility.h"
 #include "../../clib/passert.h"
 #include "../../clib/streamsaver.h"
+#include "../../clib/strutil.h"
 #include "../../clib/timer.h"
 #include "../../plib/systemstate.h"
 #include "../globals/state.h"
@@ -34,6 +35,13 @@ namespace Pol
 {
 namespace Accounts
 {
+void add_account( Account* acct )
+{
+  Core::gamestate.accounts.push_back( Core::AccountRef( acct ) );
+  // first one wins on duplicate names, same as the former linear scan
+  Core::gamestate.accounts_by_name.emplace( Clib::strlowerASCII( acct->name() ), acct );
+}
+
 void read_account_data()
 {
   unsigned int naccounts = 0;
@@ -56,7 +64,7 @@ void read_account_data()
         INFO_PRINT( "." );
         num_until_dot = 1000;
       }
-      Core::gamestate.accounts.push_back( Core::AccountRef( new Account( elem ) ) );
+      add_account( new Account( elem ) );
       naccounts++;
     }
   }
@@ -119,7 +127,7 @@ Account* create_new_account( const std::string& acctname, const std::string& pas
 
   elem.add_prop( "enabled", ( (unsigned int)( enabled ? 1 : 0 ) ) );
   auto acct = new Account( elem );
-  Core::gamestate.accounts.push_back( Core::AccountRef( acct ) );
+  add_account( acct );
   if ( Plib::systemstate.config.account_save == -1 )
     write_account_data();
   else
@@ -140,7 +148,7 @@ Account* duplicate_account( const std::string& oldacctname, const std::string& n
     elem.add_prop( "name", newacctname );
 
     auto acct = new Account( elem );
-    Core::gamestate.accounts.push_back( Core::AccountRef( acct ) );
+    add_account( acct );
     if ( Plib::systemstate.config.account_save == -1 )
       write_account_data();
     else
@@ -152,38 +160,47 @@ Account* duplicate_account( const std::string& oldacctname, const std::string& n
 
 Account* find_account( const char* acctname )
 {
-  for ( auto& account : Core::gamestate.accounts )
-  {
-    if ( stricmp( account->name(), acctname ) == 0 )
-    {
-      return account.get();
-    }
-  }
-  return nullptr;
+  const auto& index = Core::gamestate.accounts_by_name;
+  auto itr = index.find( Clib::strlowerASCII( acctname ) );
+  if ( itr == index.end() )
+    return nullptr;
+  return itr->second;
 }
 
 int delete_account( const char* acctname )
 {
-  for ( auto itr = Core::gamestate.accounts.begin(), end = Core::gamestate.accounts.end();
-        itr != end; ++itr )
+  Account* account = find_account( acctname );
+  if ( account == nullptr )
+    return -2;
+  if ( account->numchars() != 0 )
+    return -1;
+
+  auto& accounts = Core::gamestate.accounts;
+  std::string key = Clib::strlowerASCII( account->name() );
+  Core::gamestate.accounts_by_name.erase( key );
+  for ( auto itr = accounts.begin(); itr != accounts.end(); ++itr )
   {
-    Account* account = ( *itr ).get();
-    if ( stricmp( account->name(), acctname ) == 0 )
+    if ( itr->get() == account )
     {
-      if ( account->numchars() == 0 )
-      {
-        Core::gamestate.accounts.erase( itr );
-        if ( Plib::systemstate.config.account_save == -1 )
-          write_account_data();
-        else
-          Plib::systemstate.accounts_txt_dirty = true;
-        return 1;
-      }
-      else
-        return -1;
+      accounts.erase( itr );
+      break;
+    }
+  }
+  // a duplicate entry in accounts.txt becomes reachable again
+  for ( const auto& other : accounts )
+  {
+    if ( stricmp( other->name(), key.c_str() ) == 0 )
+    {
+      Core::gamestate.accounts_by_name.emplace( std::move( key ), other.get() );
+      break;
     }
   }
-  return -2;
+
+  if ( Plib::systemstate.config.account_save == -1 )
+    write_account_data();
+  else
+    Plib::systemstate.accounts_txt_dirty = true;
+  return 1;
 }
 
 void reread_account( Clib::ConfigElem& elem )
@@ -197,7 +214,7 @@ void reread_account( Clib::ConfigElem& elem )
   else
   {
     elem.add_prop( "NAME", name );
-    Core::gamestate.accounts.push_back( Core::AccountRef( new Account( elem ) ) );
+    add_account( new Account( elem ) );
   }
 }
 
@@ -18,6 +18,7 @@ namespace Accounts
 {
 class Account;
 
+void add_account( Account* acct );
 Account* create_new_account( const std::string& acctname, const std::string& password,
                              bool enabled );
 Account* duplicate_account( const std::string& oldacctname, const std::string& newacctname );
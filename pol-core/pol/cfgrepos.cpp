@@ -17,6 +17,7 @@
 
 #include "cfgrepos.h"
 
+#include <algorithm>
 #include <ctype.h>
 #include <exception>
 #include <iosfwd>
@@ -40,6 +41,42 @@ namespace Pol
 {
 namespace Core
 {
+namespace
+{
+// FNV-1a of the lower case name, without creating the folded string
+size_t folded_hash( const std::string& name )
+{
+  size_t hash = 14695981039346656037ull;
+  for ( unsigned char ch : name )
+  {
+    hash ^= static_cast<unsigned char>( tolower( ch ) );
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+struct PropLess
+{
+  bool operator()( const StoredConfigElem::Prop& prop, const StoredConfigElem::PropKey& key ) const
+  {
+    if ( prop.hash != key.hash() )
+      return prop.hash < key.hash();
+    return stricmp( prop.name.get().c_str(), key.name().c_str() ) < 0;
+  }
+  bool operator()( const StoredConfigElem::PropKey& key, const StoredConfigElem::Prop& prop ) const
+  {
+    if ( key.hash() != prop.hash )
+      return key.hash() < prop.hash;
+    return stricmp( key.name().c_str(), prop.name.get().c_str() ) < 0;
+  }
+};
+}  // namespace
+
+StoredConfigElem::PropKey::PropKey( const std::string& name )
+    : name_( name ), hash_( folded_hash( name ) )
+{
+}
+
 StoredConfigElem::StoredConfigElem( Clib::ConfigElem& elem )
 {
   std::string propname, propval;
@@ -64,26 +101,41 @@ StoredConfigElem::~StoredConfigElem()
 
 void StoredConfigElem::addprop( const std::string& propname, Bscript::BObjectImp* imp )
 {
-  propimps_.insert( PropImpList::value_type( boost_utils::cfg_key_flystring( propname ),
-                                             ref_ptr<class Bscript::BObjectImp>( imp ) ) );
+  PropKey key( propname );
+  // behind the properties of the same name
+  auto itr = std::upper_bound( propimps_.begin(), propimps_.end(), key, PropLess() );
+  propimps_.insert( itr, Prop{ key.hash(), boost_utils::cfg_key_flystring( propname ),
+                               ref_ptr<Bscript::BObjectImp>( imp ) } );
 }
 
 Bscript::BObjectImp* StoredConfigElem::getimp( const std::string& propname ) const
 {
-  PropImpList::const_iterator itr = propimps_.find( boost_utils::cfg_key_flystring( propname ) );
-  if ( itr == propimps_.end() )
+  return getimp( PropKey( propname ) );
+}
+
+Bscript::BObjectImp* StoredConfigElem::getimp( const PropKey& key ) const
+{
+  auto itr = std::lower_bound( propimps_.begin(), propimps_.end(), key, PropLess() );
+  if ( itr == propimps_.end() || PropLess()( key, *itr ) )
     return nullptr;
   else
-    return ( *itr ).second.get();
+    return itr->imp.get();
 }
 
 Bscript::BObjectImp* StoredConfigElem::listprops() const
 {
+  std::vector<const std::string*> names;
+  names.reserve( propimps_.size() );
+  for ( const auto& prop : propimps_ )
+    names.push_back( &prop.name.get() );
+  std::stable_sort( names.begin(), names.end(),
+                    []( const std::string* a, const std::string* b )
+                    { return stricmp( a->c_str(), b->c_str() ) < 0; } );
+
   Bscript::ObjArray* objarr = new Bscript::ObjArray;
-  PropImpList::const_iterator itr;
-  for ( itr = propimps_.begin(); itr != propimps_.end(); ++itr )
+  for ( const auto* name : names )
   {
-    Bscript::String propname( ( *itr ).first );
+    Bscript::String propname( *name );
     if ( !objarr->contains( propname ) )
       objarr->addElement( propname.copy() );
   }
@@ -93,16 +145,22 @@ Bscript::BObjectImp* StoredConfigElem::listprops() const
 std::pair<StoredConfigElem::const_iterator, StoredConfigElem::const_iterator>
 StoredConfigElem::equal_range( const std::string& propname ) const
 {
-  return propimps_.equal_range( boost_utils::cfg_key_flystring( propname ) );
+  return equal_range( PropKey( propname ) );
+}
+
+std::pair<StoredConfigElem::const_iterator, StoredConfigElem::const_iterator>
+StoredConfigElem::equal_range( const PropKey& key ) const
+{
+  return std::equal_range( propimps_.begin(), propimps_.end(), key, PropLess() );
 }
 
 size_t StoredConfigElem::estimateSize() const
 {
   size_t size = Clib::memsize( propimps_ );
-  for ( const auto& pair : propimps_ )
+  for ( const auto& prop : propimps_ )
   {
-    if ( pair.second.get() != nullptr )
-      size += pair.second->sizeEstimate();
+    if ( prop.imp.get() != nullptr )
+      size += prop.imp->sizeEstimate();
   }
   return size;
 }
@@ -139,17 +197,19 @@ void StoredConfigFile::load( Clib::ConfigFile& cf )
     {
       unsigned int key = strtoul( elem.rest(), nullptr, 0 );
       elements_bynum_.insert( ElementsByNum::value_type( key, elemref ) );
+      elements_bynum_index_.emplace( key, elemref );
     }
 
     std::string key( elem.rest() );
     elements_byname_.insert( ElementsByName::value_type( key, elemref ) );
+    elements_byfoldedname_.emplace( Clib::strlowerASCII( key ), elemref );
   }
 }
 
 StoredConfigFile::ElemRef StoredConfigFile::findelem( int key )
 {
-  ElementsByNum::const_iterator itr = elements_bynum_.find( key );
-  if ( itr == elements_bynum_.end() )
+  auto itr = elements_bynum_index_.find( key );
+  if ( itr == elements_bynum_index_.end() )
     return ElemRef( nullptr );
   else
     return ( *itr ).second;
@@ -157,8 +217,8 @@ StoredConfigFile::ElemRef StoredConfigFile::findelem( int key )
 
 StoredConfigFile::ElemRef StoredConfigFile::findelem( const std::string& key )
 {
-  ElementsByName::const_iterator itr = elements_byname_.find( key );
-  if ( itr == elements_byname_.end() )
+  auto itr = elements_byfoldedname_.find( Clib::strlowerASCII( key ) );
+  if ( itr == elements_byfoldedname_.end() )
     return ElemRef( nullptr );
   else
     return ( *itr ).second;
@@ -197,7 +257,8 @@ void StoredConfigFile::load_tus_scp( const std::string& filename )
 
   int count = 0;
   ElemRef elemref( new StoredConfigElem() );
-  elements_bynum_.insert( ElementsByNum::value_type( count++, elemref ) );
+  elements_bynum_.insert( ElementsByNum::value_type( count, elemref ) );
+  elements_bynum_index_.emplace( count++, elemref );
 
   std::string strbuf;
   bool first_line = true;
@@ -212,7 +273,8 @@ void StoredConfigFile::load_tus_scp( const std::string& filename )
     if ( strbuf[0] == '[' )
     {
       elemref.set( new StoredConfigElem() );
-      elements_bynum_.insert( ElementsByNum::value_type( count++, elemref ) );
+      elements_bynum_.insert( ElementsByNum::value_type( count, elemref ) );
+      elements_bynum_index_.emplace( count++, elemref );
       strbuf = extractkey( strbuf );
       elemref->addprop( "_key", Bscript::bobject_from_string( strbuf, 16 ) );
     }
@@ -241,8 +303,10 @@ size_t StoredConfigFile::estimateSize() const
                              return sizeof( ElemRef ) + v->estimateSize();
                            return sizeof( ElemRef );
                          } );
-  // both maps share the same ref
+  // all maps share the same ref
+  size += Clib::memsize( elements_byfoldedname_ );
   size += Clib::memsize( elements_bynum_ );
+  size += Clib::memsize( elements_bynum_index_ );
   return size;
 }
 
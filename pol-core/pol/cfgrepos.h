@@ -16,7 +16,9 @@
 #include <map>
 #include <string>
 #include <time.h>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "../clib/boostutils.h"
 #include "../clib/maputil.h"
@@ -41,10 +43,33 @@ namespace Core
 {
 class StoredConfigElem : public ref_counted
 {
+public:
+  /**
+   * A property name resolved once, to look it up in many elements without hashing the name
+   * again, e.g. when checking the same property of a list of objtypes.
+   */
+  class PropKey
+  {
+  public:
+    explicit PropKey( const std::string& name );
+    const std::string& name() const { return name_; }
+    size_t hash() const { return hash_; }
+
+  private:
+    std::string name_;
+    size_t hash_;  // of the case folded name
+  };
+
+  struct Prop
+  {
+    size_t hash;
+    boost_utils::cfg_key_flystring name;
+    ref_ptr<Bscript::BObjectImp> imp;
+  };
+
 private:
-  typedef std::multimap<boost_utils::cfg_key_flystring, ref_ptr<Bscript::BObjectImp>,
-                        Clib::ci_cmp_pred>
-      PropImpList;
+  // ordered by hash and name, properties of the same name stay in file order
+  typedef std::vector<Prop> PropImpList;
 
 public:
   StoredConfigElem() = default;
@@ -57,11 +82,13 @@ public:
   size_t estimateSize() const;
 
   Bscript::BObjectImp* getimp( const std::string& propname ) const;
+  Bscript::BObjectImp* getimp( const PropKey& key ) const;
   Bscript::BObjectImp* listprops() const;
   void addprop( const std::string& propname, Bscript::BObjectImp* imp );
 
   typedef StoredConfigElem::PropImpList::const_iterator const_iterator;
   std::pair<const_iterator, const_iterator> equal_range( const std::string& propname ) const;
+  std::pair<const_iterator, const_iterator> equal_range( const PropKey& key ) const;
 
 private:
   PropImpList propimps_;
@@ -93,9 +120,12 @@ public:
   friend class Module::ConfigFileIterator;
 
 private:
+  // the ordered maps keep the order of iteration for scripts, lookups use the hashed indexes
   ElementsByName elements_byname_;
+  std::unordered_map<std::string, ElemRef> elements_byfoldedname_;
 
   ElementsByNum elements_bynum_;
+  std::unordered_map<int, ElemRef> elements_bynum_index_;
 
   time_t modified_;  // used to detect modification
 
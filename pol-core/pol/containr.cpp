@@ -76,12 +76,14 @@ size_t UContainer::estimatedSize() const
   const size_t size = base::estimatedSize() + sizeof( u16 ) /*held_weight_*/
                       + sizeof( unsigned int )              /*held_item_count_*/
                       // no estimateSize here element is in objhash
-                      + Clib::memsize( contents_ );
+                      + Clib::memsize( contents_ ) + sizeof( contents_index_ ) +
+                      ( contents_index_ ? contents_index_->estimatedSize() : 0 );
   return size;
 }
 
 void UContainer::destroy_contents()
 {
+  index_invalidate();
   while ( !contents_.empty() )
   {
     Contents::value_type item = contents_.back();
@@ -215,6 +217,7 @@ void UContainer::add( Items::Item* item )
   item->container = this;
   item->set_dirty();
   contents_.push_back( Contents::value_type( item ) );
+  index_insert( item );
 
   add_bulk( item );
 }
@@ -340,6 +343,7 @@ void UContainer::extract( Contents& cnt )
     POLLOG_ERRORLN( "Trying to add item to orphan container!" );
     passert_always( 0 );  // TODO remove once found
   }
+  index_invalidate();
   contents_.swap( cnt );
   add_bulk( -static_cast<int>( held_item_count_ ), -static_cast<int>( held_weight_ ) );
 }
@@ -371,6 +375,8 @@ void UContainer::swap( UContainer& cont )
     POLLOG_ERRORLN( "Trying to add item to orphan container!" );
     passert_always( 0 );  // TODO remove once found
   }
+  index_invalidate();
+  cont.index_invalidate();
   contents_.swap( cont.contents_ );
 }
 
@@ -447,6 +453,26 @@ Items::Item* UContainer::find_addable_stack( const Items::Item* adding_item ) co
 
 Items::Item* UContainer::find_objtype( u32 objtype, int flags ) const
 {
+  if ( !( flags & FINDOBJTYPE_ROOT_ONLY ) )
+  {
+    if ( const auto* index = contents_index() )
+    {
+      auto itr = index->by_objtype.find( objtype );
+      if ( itr == index->by_objtype.end() )
+        return nullptr;
+      // toplevel items first, like the walk below
+      Items::Item* nested = nullptr;
+      for ( const auto& item : itr->second )
+      {
+        if ( item->container == this )
+          return item;
+        if ( nested == nullptr &&
+             index_reachable( item, ( flags & FINDOBJTYPE_IGNORE_LOCKED ) != 0, false ) )
+          nested = item;
+      }
+      return nested;
+    }
+  }
   Items::Item* _item = find_toplevel_objtype( objtype );
   if ( _item != nullptr )
     return _item;
@@ -472,6 +498,23 @@ Items::Item* UContainer::find_objtype( u32 objtype, int flags ) const
 
 Items::Item* UContainer::find_objtype_noninuse( u32 objtype ) const
 {
+  if ( const auto* index = contents_index() )
+  {
+    auto itr = index->by_objtype.find( objtype );
+    if ( itr == index->by_objtype.end() )
+      return nullptr;
+    Items::Item* nested = nullptr;
+    for ( const auto& item : itr->second )
+    {
+      if ( item->inuse() )
+        continue;
+      if ( item->container == this )
+        return item;
+      if ( nested == nullptr && index_reachable( item, false, true ) )
+        nested = item;
+    }
+    return nested;
+  }
   Items::Item* _item = find_toplevel_objtype_noninuse( objtype );
   if ( _item != nullptr )
     return _item;
@@ -496,6 +539,20 @@ unsigned int UContainer::find_sumof_objtype_noninuse( u32 objtype ) const
 {
   unsigned int amt = 0;
 
+  if ( const auto* index = contents_index() )
+  {
+    auto itr = index->by_objtype.find( objtype );
+    if ( itr != index->by_objtype.end() )
+    {
+      for ( const auto& item : itr->second )
+      {
+        if ( !item->inuse() && index_reachable( item, false, true ) )
+          amt += item->getamount();
+      }
+    }
+    return amt;
+  }
+
   for ( auto& item : contents_ )
   {
     if ( item && !item->inuse() )
@@ -588,6 +645,7 @@ void UContainer::remove( iterator itr )
 {
   INC_PROFILEVAR( container_removes );
   Items::Item* item = *itr;
+  index_erase( item );
   contents_.erase( itr );
   item->container = nullptr;
   item->reset_slot();
@@ -615,6 +673,16 @@ UContainer* UContainer::find_container( u32 objserial ) const
 
 Items::Item* UContainer::find( u32 objserial, iterator& where_in_container )
 {
+  if ( contents_index() != nullptr )
+  {
+    Items::Item* item = find( objserial );
+    if ( item != nullptr )
+    {
+      auto& cnt = item->container->contents_;
+      where_in_container = std::find( cnt.begin(), cnt.end(), item );
+    }
+    return item;
+  }
   for ( iterator itr = contents_.begin(); itr != contents_.end(); ++itr )
   {
     Items::Item* item = *itr;
@@ -643,6 +711,13 @@ Items::Item* UContainer::find( u32 objserial, iterator& where_in_container )
 
 Items::Item* UContainer::find( u32 objserial ) const
 {
+  if ( const auto* index = contents_index() )
+  {
+    auto itr = index->by_serial.find( objserial );
+    if ( itr == index->by_serial.end() || !index_reachable( itr->second, false, false ) )
+      return nullptr;
+    return itr->second;
+  }
   for ( const auto& item : contents_ )
   {
     passert( item != nullptr );
@@ -680,6 +755,112 @@ Items::Item* UContainer::find_toplevel( u32 objserial ) const
   return nullptr;
 }
 
+namespace
+{
+template <typename F>
+void for_each_in_subtree( Items::Item* item, const F& f )
+{
+  f( item );
+  if ( item->isa( UOBJ_CLASS::CLASS_CONTAINER ) )
+  {
+    for ( const auto& child : *static_cast<UContainer*>( item ) )
+    {
+      if ( child != nullptr )  // wornitems has empty layers
+        for_each_in_subtree( child, f );
+    }
+  }
+}
+}  // namespace
+
+void UContainer::ContentsIndex::insert( Items::Item* item )
+{
+  by_serial[item->serial] = item;
+  by_objtype[item->objtype_].push_back( item );
+}
+
+void UContainer::ContentsIndex::erase( Items::Item* item )
+{
+  by_serial.erase( item->serial );
+  auto itr = by_objtype.find( item->objtype_ );
+  if ( itr == by_objtype.end() )
+    return;
+  auto& items = itr->second;
+  items.erase( std::remove( items.begin(), items.end(), item ), items.end() );
+  if ( items.empty() )
+    by_objtype.erase( itr );
+}
+
+size_t UContainer::ContentsIndex::estimatedSize() const
+{
+  // the per objtype vectors together hold every indexed item once
+  return sizeof( ContentsIndex ) + Clib::memsize( by_serial ) + Clib::memsize( by_objtype ) +
+         by_serial.size() * sizeof( Items::Item* );
+}
+
+const UContainer::ContentsIndex* UContainer::contents_index() const
+{
+  if ( !desc.index_contents )
+    return nullptr;
+  if ( !contents_index_ )
+  {
+    contents_index_.reset( new ContentsIndex );
+    for ( const auto& item : contents_ )
+    {
+      if ( item != nullptr )
+        for_each_in_subtree( item, [&]( Items::Item* i ) { contents_index_->insert( i ); } );
+    }
+  }
+  return contents_index_.get();
+}
+
+// item was just added to this container: every indexed container up the chain sees it
+void UContainer::index_insert( Items::Item* item )
+{
+  for ( UContainer* cont = this; cont != nullptr; cont = cont->container )
+  {
+    if ( cont->contents_index_ )
+    {
+      auto* index = cont->contents_index_.get();
+      for_each_in_subtree( item, [&]( Items::Item* i ) { index->insert( i ); } );
+    }
+  }
+}
+
+void UContainer::index_erase( Items::Item* item )
+{
+  for ( UContainer* cont = this; cont != nullptr; cont = cont->container )
+  {
+    if ( cont->contents_index_ )
+    {
+      auto* index = cont->contents_index_.get();
+      for_each_in_subtree( item, [&]( Items::Item* i ) { index->erase( i ); } );
+    }
+  }
+}
+
+// bulk changes of contents_: drop the indexes, the next lookup rebuilds them
+void UContainer::index_invalidate()
+{
+  for ( UContainer* cont = this; cont != nullptr; cont = cont->container )
+    cont->contents_index_.reset();
+}
+
+// same rules as the recursive walks: no descent into locked (or inuse) sub-containers
+bool UContainer::index_reachable( const Items::Item* item, bool ignore_locked,
+                                  bool noninuse ) const
+{
+  for ( const UContainer* cont = item->container; cont != this; cont = cont->container )
+  {
+    if ( cont == nullptr )
+      return false;
+    if ( !ignore_locked && cont->locked() )
+      return false;
+    if ( noninuse && cont->inuse() )
+      return false;
+  }
+  return true;
+}
+
 void UContainer::for_each_item( void ( *f )( Items::Item* item, void* a ), void* arg )
 {
   for ( auto& item : contents_ )
@@ -755,6 +936,7 @@ void UContainer::spill_contents( Multi::UMulti* multi )
   passert( container == nullptr );
   if ( !locked() )
   {
+    index_invalidate();
     while ( !contents_.empty() )
     {
       Items::Item* item = contents_.back();
@@ -915,6 +1097,30 @@ unsigned int UContainer::find_sumof_objtype_noninuse( u32 objtype, u32 amtToGet,
 {
   unsigned int amt = 0;
 
+  if ( const auto* index = contents_index() )
+  {
+    auto itr = index->by_objtype.find( objtype );
+    if ( itr == index->by_objtype.end() )
+      return amt;
+    for ( const auto& item : itr->second )
+    {
+      if ( item->inuse() )
+        continue;
+      if ( flags & FINDSUBSTANCE_ROOT_ONLY )
+      {
+        if ( item->container != this )
+          continue;
+      }
+      else if ( !index_reachable( item, ( flags & FINDSUBSTANCE_IGNORE_LOCKED ) != 0, true ) )
+        continue;
+      saveItemsTo.push_back( item );
+      amt += item->getamount();
+      if ( !( flags & FINDSUBSTANCE_FIND_ALL ) && amt >= amtToGet )
+        return amt;
+    }
+    return amt;
+  }
+
   for ( auto& item : contents_ )
   {
     if ( item && !item->inuse() )
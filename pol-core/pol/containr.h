@@ -14,7 +14,10 @@
 #ifndef CONTAINR_H
 #define CONTAINR_H
 
+#include <memory>
 #include <stddef.h>
+#include <unordered_map>
+#include <vector>
 
 #include "../clib/rawtypes.h"
 #include "baseobject.h"
@@ -237,6 +240,26 @@ protected:
       u32 serial,
       iterator& where_in_container );  // return the position in the array where it was found.
 
+  // Lookup index over the whole subtree, only for containers with IndexContents set in their
+  // itemdesc. Built on the first lookup, then kept up to date by add/remove in this container
+  // and every sub-container. Lock and inuse state is checked on lookup.
+  struct ContentsIndex
+  {
+    std::unordered_map<u32, Items::Item*> by_serial;
+    std::unordered_map<u32, std::vector<Items::Item*>> by_objtype;
+
+    void insert( Items::Item* item );
+    void erase( Items::Item* item );
+    size_t estimatedSize() const;
+  };
+  mutable std::unique_ptr<ContentsIndex> contents_index_;
+
+  const ContentsIndex* contents_index() const;
+  void index_insert( Items::Item* item );
+  void index_erase( Items::Item* item );
+  void index_invalidate();
+  bool index_reachable( const Items::Item* item, bool ignore_locked, bool noninuse ) const;
+
   // sticky places that currently need to know the internals:
   friend class UContainerIterator;
   // friend class Character; // uses the [] operator for quick layer access.
@@ -47,6 +47,8 @@ NetworkManager::NetworkManager()
       disconnected_filter( nullptr ),
       packet_hook_data(),
       packet_hook_data_v2(),
+      packet_rules(),
+      tooltip_cache(),
       handler(),
       handler_v2(),
       ext_handler_table(),
@@ -126,6 +128,7 @@ void NetworkManager::deinialize()
   Clib::delete_all( auxservices );
   auxthreadpool.reset();
   banned_ips.clear();
+  tooltip_cache.clear();
 
   Network::deinit_sockets_library();
   Network::clean_packethooks();
@@ -189,6 +192,8 @@ NetworkManager::Memory NetworkManager::estimateSize() const
     if ( hook != nullptr )
       usage.misc += hook->estimateSize();
   }
+  usage.misc += packet_rules.estimateSize();
+  usage.misc += tooltip_cache.estimateSize();
 
   usage.misc += packetsSingleton->estimateSize();
   usage.misc += sizeof( Network::ClientTransmit );
@@ -10,8 +10,10 @@
 #include "../network/bannedips.h"
 #include "../network/iostats.h"
 #include "../network/msghandl.h"
+#include "../network/packetrules.h"
 #include "../network/sockio.h"
 #include "../polstats.h"
+#include "../tooltips.h"
 #include "../uoclient.h"
 
 namespace Pol
@@ -84,6 +86,10 @@ public:
   // stores information about each packet and its script & default handler
   std::vector<std::unique_ptr<Network::PacketHookData>> packet_hook_data;
   std::vector<std::unique_ptr<Network::PacketHookData>> packet_hook_data_v2;
+  // declarative outgoing packet rules, applied without PolLock
+  Network::PacketRules packet_rules;
+  // built AOS tooltip packets keyed by object revision
+  TooltipCache tooltip_cache;
   // handler[] is used for storing the core MSG_HANDLER calls.
   std::array<Network::MSG_HANDLER, 256> handler;
   /*
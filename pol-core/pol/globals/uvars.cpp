@@ -85,6 +85,7 @@ GameState::GameState()
       // Using force allocate because this is inited before reading global CProp setting
       global_properties( new Core::PropertyList( CPropProfiler::Type::GLOBAL, true ) ),
       accounts(),
+      accounts_by_name(),
       startlocations(),
       wrestling_weapon( nullptr ),
       justicedef( nullptr ),
@@ -171,6 +172,7 @@ GameState::GameState()
       paramtextcmds(),
       uo_skills(),
       task_thread_pool(),
+      realm_thread_pool(),
       decay(),
       max_update_range( 0 ),
       max_update_range_client( 0 ),
@@ -303,6 +305,7 @@ void GameState::deinitialize()
   tipfilenames.clear();
 
   task_thread_pool.deinit_pool();
+  realm_thread_pool.deinit_pool();
 
   for ( ; !task_queue.empty(); task_queue.pop() )
     delete task_queue.top();
@@ -368,6 +371,7 @@ void GameState::cleanup_vars()
   // and Nando placed it outside the Realms' loop in 2009-01-18.
   objStorageManager.objecthash.ClearCharacterAccountReferences();
 
+  accounts_by_name.clear();
   accounts.clear();
   Clib::delete_all( startlocations );
 
@@ -473,6 +477,7 @@ GameState::Memory GameState::estimateSize() const
 
   usage.account_count = accounts.size();
   usage.account_size += Clib::memsize( accounts );
+  usage.account_size += Clib::memsize( accounts_by_name );
   for ( const auto& acc : accounts )
   {
     if ( acc.get() != nullptr )
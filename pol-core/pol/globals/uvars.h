@@ -13,6 +13,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -86,6 +87,8 @@ class WeatherDef;
 typedef std::vector<Core::CmdLevel> CmdLevels;
 
 typedef std::vector<AccountRef> AccountsVector;
+// lowercased account name -> account, see Accounts::find_account
+typedef std::unordered_map<std::string, Accounts::Account*> AccountsByName;
 class ItemsVector : public std::vector<Items::Item*>
 {
 };
@@ -145,6 +148,7 @@ public:
   std::unique_ptr<Core::PropertyList> global_properties;
 
   AccountsVector accounts;
+  AccountsByName accounts_by_name;
   StartingLocations startlocations;
   Items::UWeapon* wrestling_weapon;
 
@@ -247,6 +251,8 @@ public:
     size_t misc;
   };
   threadhelp::TaskThreadPool task_thread_pool;
+  // only used by Realms::for_each_realm_parallel, which waits for it under the PolLock
+  threadhelp::TaskThreadPool realm_thread_pool;
 
   Decay decay;
 
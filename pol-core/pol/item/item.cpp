@@ -39,6 +39,7 @@
 #include "../tooltips.h"
 #include "../ufunc.h"
 #include "../uoscrobj.h"
+#include "../uworld.h"
 #include "itemdesc.h"
 #include "regions/resource.h"
 
@@ -1396,6 +1397,7 @@ bool Item::stop_control_script()
         static_cast<Module::UOExecutorModule*>( ex.findModule( "UO" ) );
     uoemod->attached_item_.clear();
     process( nullptr );
+    Core::unregister_area_event_listener( this );
     return true;
   }
   return false;
@@ -956,6 +956,7 @@ ContainerDesc::ContainerDesc( u32 objtype, Clib::ConfigElem& elem, const Plib::P
           elem.remove_ushort( "MAXSLOTS", Core::settingsManager.ssopt.default_max_slots ) ) ),
       held_weight_multiplier( elem.remove_double( "HeldWeightMultiplier", 1.0 ) ),
       no_drop_exception( elem.remove_bool( "NoDropException", false ) ),
+      index_contents( elem.remove_bool( "IndexContents", false ) ),
       can_insert_script( elem.remove_string( "CANINSERTSCRIPT", "" ), pkg, "scripts/control/" ),
       on_insert_script( elem.remove_string( "ONINSERTSCRIPT", "" ), pkg, "scripts/control/" ),
       can_remove_script( elem.remove_string( "CANREMOVESCRIPT", "" ), pkg, "scripts/control/" ),
@@ -986,6 +987,7 @@ void ContainerDesc::PopulateStruct( Bscript::BStruct* descriptor ) const
   descriptor->addMember( "MaxSlots", new BLong( max_slots ) );
   descriptor->addMember( "HeldWeightMultiplier", new Double( held_weight_multiplier ) );
   descriptor->addMember( "NoDropException", new BLong( no_drop_exception ) );
+  descriptor->addMember( "IndexContents", new BLong( index_contents ) );
   descriptor->addMember( "CanInsertScript", new String( can_insert_script.relativename( pkg ) ) );
   descriptor->addMember( "CanRemoveScript", new String( can_remove_script.relativename( pkg ) ) );
   descriptor->addMember( "OnInsertScript", new String( on_insert_script.relativename( pkg ) ) );
@@ -1000,6 +1002,7 @@ size_t ContainerDesc::estimatedSize() const
          + sizeof( u16 )                       /*max_items*/
          + sizeof( u8 )                        /*max_slots*/
          + sizeof( bool )                      /*no_drop_exception*/
+         + sizeof( bool )                      /*index_contents*/
          + sizeof( double )                    /*held_weight_multiplier*/
          + can_insert_script.estimatedSize() + on_insert_script.estimatedSize() +
          can_remove_script.estimatedSize() + on_remove_script.estimatedSize();
@@ -205,6 +205,7 @@ public:
   double held_weight_multiplier;
 
   bool no_drop_exception;
+  bool index_contents;
 
   Core::ScriptDef can_insert_script;
   Core::ScriptDef on_insert_script;
@@ -9,9 +9,18 @@
 
 #include "loadunld.h"
 
+#include <atomic>
+#include <future>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "clib/cfgfile.h"
+#include "clib/fileutil.h"
+#include "clib/logfacility.h"
 #include "clib/strutil.h"
+#include "clib/threadhelp.h"
+#include "clib/timer.h"
 #include "plib/pkg.h"
 #include "plib/systemstate.h"
 #include "plib/tiles.h"
@@ -160,117 +169,246 @@ void load_config( bool reload )
   load_party_cfg( reload );
 }
 
+namespace
+{
+/**
+ * Steps of load_data(), timed for the startup log.
+ */
+class LoadPhases
+{
+public:
+  // ends the running phase and starts the next one
+  void next( const char* name )
+  {
+    stop();
+    checkpoint( name );
+    _name = name;
+    _timer.start();
+  }
+  void stop()
+  {
+    if ( _name != nullptr )
+      _times.emplace_back( _name, _timer.ellapsed() );
+    _name = nullptr;
+  }
+  std::string report() const
+  {
+    std::string out;
+    for ( const auto& phase : _times )
+      out += fmt::format( "\n  {:<40} {:>6} ms", phase.first, phase.second );
+    return out;
+  }
+
+private:
+  const char* _name = nullptr;
+  Tools::Timer<> _timer;
+  std::vector<std::pair<const char*, long long>> _times;
+};
+
+/**
+ * Parses the config files read by load_data() on the task_thread_pool, while the loaders link
+ * them in their order on this thread. A loader opening a file waits for it to be parsed, see
+ * Clib::ConfigFile::expect().
+ */
+class ConfigPreparser
+{
+public:
+  // filename is going to be opened reads times
+  void add( const std::string& filename, unsigned reads )
+  {
+    if ( gamestate.task_thread_pool.size() == 0 || !Clib::FileExists( filename ) )
+      return;
+    Clib::ConfigFile::expect( filename, reads );
+    _parts.push_back( gamestate.task_thread_pool.checked_push(
+        [this, filename]()
+        {
+          Tools::Timer<> timer;
+          Clib::ConfigFile::preparse( filename );
+          _parse_ms += timer.ellapsed();
+        } ) );
+  }
+  // waits for the running parses and drops the files nobody read
+  void finish()
+  {
+    for ( auto& part : _parts )
+      part.wait();
+    Clib::ConfigFile::discard_preparsed();
+  }
+  ~ConfigPreparser() { finish(); }
+  size_t count() const { return _parts.size(); }
+  long long parse_ms() const { return _parse_ms; }
+
+private:
+  std::vector<std::future<bool>> _parts;
+  std::atomic<long long> _parse_ms{ 0 };
+};
+
+// config files in config/ and the packages with the number of loaders reading them
+const std::pair<const char*, unsigned> core_config_files[] = {
+    { "cmds.cfg", 1 },      { "boats.cfg", 1 },   { "multis.cfg", 1 },
+    { "tiles.cfg", 1 },     { "landtiles.cfg", 1 },
+    { "itemdesc.cfg", 2 },  // load_itemdesc, load_special_storedconfig
+    { "spells.cfg", 2 },    // load_spell_data, load_special_storedconfig
+    { "npcdesc.cfg", 3 },   // load_npc_intrinsic_equip, load_npc_templates, read_npc_templates
+    { "stacking.cfg", 1 }
+};
+const std::pair<const char*, unsigned> package_config_files[] = {
+    { "attributes.cfg", 1 }, { "vitals.cfg", 1 },   { "uoskills.cfg", 1 },
+    { "uoclient.cfg", 1 },   { "tiles.cfg", 1 },    { "landtiles.cfg", 1 },
+    { "itemdesc.cfg", 2 },   { "spells.cfg", 2 },   { "npcdesc.cfg", 3 },
+    { "stacking.cfg", 1 }
+};
+const char* region_config_files[] = { "regions/justice.cfg", "regions/music.cfg",
+                                      "regions/nocast.cfg", "regions/light.cfg",
+                                      "regions/weather.cfg" };
+}  // namespace
+
 void load_data()
 {
+  LoadPhases phases;
+  Tools::Timer<> timer;
+  ConfigPreparser preparser;
+
+  phases.next( "parse core config files" );
+  for ( const auto& cfg : core_config_files )
+    preparser.add( std::string( "config/" ) + cfg.first, cfg.second );
+  // every region type without its own file reads the shared one
+  unsigned shared_region_reads = 0;
+  for ( const auto* filename : region_config_files )
+  {
+    if ( Clib::FileExists( filename ) )
+      preparser.add( filename, 1 );
+    else
+      ++shared_region_reads;
+  }
+  if ( shared_region_reads )
+    preparser.add( "regions/regions.cfg", shared_region_reads );
+
   //  checkpoint( "read_translations" );
   //  read_translations();
 
-  checkpoint( "load_cmdlevels" );
+  phases.next( "load_cmdlevels" );
   load_cmdlevels();
 
-  checkpoint( "read_combat_config" );
+  phases.next( "read_combat_config" );
   CombatConfig::read_combat_config();
 
-  checkpoint( "read_boat_cfg" );
+  phases.next( "read_boat_cfg" );
   Multi::read_boat_cfg();
 
-  checkpoint( "read_multidefs" );
+  phases.next( "read_multidefs" );
   Multi::read_multidefs();
   gamestate.update_range_from_multis();
 
-  checkpoint( "set_watch_vars" );
+  phases.next( "set_watch_vars" );
   set_watch_vars();
 
-  checkpoint( "load_packages" );
+  phases.next( "load_packages" );
   Plib::load_packages();
 
-  checkpoint( "load_package_cmdlevels" );
+  phases.next( "parse package config files" );
+  for ( const auto& pkg : Plib::systemstate.packages )
+  {
+    for ( const auto& cfg : package_config_files )
+      preparser.add( Plib::GetPackageCfgPath( pkg, cfg.first ), cfg.second );
+  }
+
+  phases.next( "load_package_cmdlevels" );
   load_package_cmdlevels();
 
-  checkpoint( "load_resource_cfg" );
+  phases.next( "load_resource_cfg" );
   load_resource_cfg();
 
-  checkpoint( "read_justice_zones" );
+  phases.next( "read_justice_zones" );
   read_justice_zones();
 
-  checkpoint( "read_music_zones" );
+  phases.next( "read_music_zones" );
   read_music_zones();
 
-  checkpoint( "read_nocast_zones" );
+  phases.next( "read_nocast_zones" );
   read_nocast_zones();
 
-  checkpoint( "read_light_zones" );
+  phases.next( "read_light_zones" );
   read_light_zones();
 
-  checkpoint( "read_weather_zones" );
+  phases.next( "read_weather_zones" );
   read_weather_zones();
 
-  checkpoint( "load_armor_zones" );
+  phases.next( "load_armor_zones" );
   Mobile::load_armor_zones();
 
-  checkpoint( "load_attributes_cfg" );
+  phases.next( "load_attributes_cfg" );
   Mobile::load_attributes_cfg();
 
-  checkpoint( "load_vitals_cfg" );
+  phases.next( "load_vitals_cfg" );
   load_vitals_cfg();
 
-  checkpoint( "load_uoskills_cfg" );
+  phases.next( "load_uoskills_cfg" );
   load_uoskills_cfg();
   Mobile::combine_attributes_skillid();
 
-  checkpoint( "load_uoclient_cfg" );
+  phases.next( "load_uoclient_cfg" );
   load_uoclient_cfg();
 
-  checkpoint( "initialize_client_interfaces" );
+  phases.next( "initialize_client_interfaces" );
   Network::initialize_client_interfaces();
 
-  checkpoint( "load_tiles_cfg" );
+  phases.next( "load_tiles_cfg" );
   Plib::load_tiles_cfg();
 
-  checkpoint( "load_landtile_cfg" );
+  phases.next( "load_landtile_cfg" );
   load_landtile_cfg();
 
-  checkpoint( "load_itemdesc" );
+  phases.next( "load_itemdesc" );
   Items::load_itemdesc();
 
-  checkpoint( "load_special_storedconfig: itemdesc" );
+  phases.next( "load_special_storedconfig: itemdesc" );
   Multi::load_special_storedconfig( "itemdesc" );
 
-  checkpoint( "load_special_storedconfig: spells" );
+  phases.next( "load_special_storedconfig: spells" );
   Multi::load_special_storedconfig( "spells" );
 
-  checkpoint( "load_npc_intrinsic_equip" );
+  phases.next( "load_npc_intrinsic_equip" );
   Items::load_npc_intrinsic_equip();
 
-  checkpoint( "load_npc_templates" );
+  phases.next( "load_npc_templates" );
   load_npc_templates();
 
-  checkpoint( "preload_test_scripts" );
+  phases.next( "preload_test_scripts" );
   Items::preload_test_scripts();
 
-  checkpoint( "load_spell_data" );
+  phases.next( "load_spell_data" );
   load_spell_data();
 
-  checkpoint( "load_tips" );
+  phases.next( "load_tips" );
   load_tips();
 
-  checkpoint( "load stacking cfg" );  // dave 1/26/3
+  phases.next( "load stacking cfg" );  // dave 1/26/3
   load_stacking_cfg();
 
+  phases.next( "load_config" );
   load_config( false );
 
+  phases.next( "read_npc_templates" );
   read_npc_templates();
 
 
   // #ifdef _WIN32
-  checkpoint( "load console commands" );
+  phases.next( "load console commands" );
   ConsoleCommand::load_console_commands();
   // #endif
 
+  phases.next( "load_fileaccess_cfg" );
   Module::load_fileaccess_cfg();
 
-  checkpoint( "check configuration" );
+  phases.next( "check configuration" );
   check_config();
+  phases.stop();
+
+  preparser.finish();
+  POLLOG_INFOLN( "Loaded configuration in {} ms, {} files parsed ahead in {} ms on {} threads:{}",
+                 timer.ellapsed(), preparser.count(), preparser.parse_ms(),
+                 gamestate.task_thread_pool.size(), phases.report() );
 }
 
 void reload_configuration()
@@ -143,6 +143,7 @@
 #include "../profile.h"
 #include "../realms/WorldChangeReasons.h"
 #include "../realms/realm.h"
+#include "../realms/realmtask.h"
 #include "../schedule.h"
 #include "../scrdef.h"
 #include "../scrsched.h"
@@ -1530,14 +1531,34 @@ void Character::set_current( const Core::Vital* pVital, VitalValue& vv, unsigned
                                  new Bscript::BLong( static_cast<int>( reason ) ) );
 }
 
-void Character::regen_vital( const Core::Vital* pVital )
+void Character::regen_vital( const Core::Vital* pVital, Realms::DeferredActions& deferred )
 {
   VitalValue& vv = vital( pVital->vitalid );
   int rr = vv.regenrate();
+  if ( rr == 0 )
+    return;
+  int start_ones = vv.current_ones();
+  set_dirty();
   if ( rr > 0 )
-    produce( pVital, vv, rr / 12 );
-  else if ( rr < 0 )
-    consume( pVital, vv, -rr / 12, VitalDepletedReason::REGENERATE );
+    vv.produce( rr / 12 );
+  else
+    vv.consume( -rr / 12 );
+  if ( start_ones == vv.current_ones() )
+    return;
+
+  bool depleted = rr < 0 && start_ones != 0 && vv.current_ones() == 0 &&
+                  pVital->depleted_func != nullptr;
+  deferred.push(
+      [chr = Core::CharacterRef( this ), pVital, depleted]()
+      {
+        if ( chr->orphan() )
+          return;
+        Network::ClientInterface::tell_vital_changed( chr.get(), pVital );
+        if ( depleted )
+          pVital->depleted_func->call(
+              new Module::ECharacterRefObjImp( chr.get() ),
+              new Bscript::BLong( static_cast<int>( VitalDepletedReason::REGENERATE ) ) );
+      } );
 }
 
 void Character::calc_vital_stuff( bool i_mod, bool v_mod )
@@ -1905,6 +1926,19 @@ void Character::check_undamaged()
   }
 }
 
+void Character::check_undamaged( Realms::DeferredActions& deferred )
+{
+  if ( vital( Core::gamestate.pVitalLife->vitalid ).is_at_maximum() && !poisoned() && !paralyzed() )
+  {
+    deferred.push(
+        [chr = Core::CharacterRef( this )]()
+        {
+          if ( !chr->orphan() )
+            chr->check_undamaged();
+        } );
+  }
+}
+
 
 ///
 /// When a Mobile is Healed
@@ -2733,83 +2767,110 @@ void PropagateMove( /*Client *client,*/ Character* chr )
   MoveChrPkt msgmove( chr );
   build_owncreate( chr, msgcreate.Get() );
 
-  Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
-      chr,
-      [&]( Character* zonechr )
+  // chr is visible to zonechr at its new position
+  auto send_update = [&]( Character* zonechr )
+  {
+    Client* client = zonechr->client;
+    /* The two characters exist, and are in range of each other.
+    Character 'chr''s lastpos coordinates are valid.
+    SO, if lastpos are out of range of client->chr, we
+    should send a 'create' type message.  If they are in range,
+    we should just send a move.
+    */
+    if ( chr->move_reason == Character::MULTIMOVE )
+    {
+      if ( client->ClientType & Network::CLIENTTYPE_7090 )
       {
-        Client* client = zonechr->client;
-        if ( zonechr == chr )
-          return;
-        if ( !zonechr->is_visible_to_me( chr ) )
-          return;
-        /* The two characters exist, and are in range of each other.
-        Character 'chr''s lastpos coordinates are valid.
-        SO, if lastpos are out of range of client->chr, we
-        should send a 'create' type message.  If they are in range,
-        we should just send a move.
-        */
-        if ( chr->move_reason == Character::MULTIMOVE )
-        {
-          if ( client->ClientType & Network::CLIENTTYPE_7090 )
-          {
-            if ( chr->poisoned() )  // if poisoned send 0x17 for newer clients
-              msgpoison.Send( client );
+        if ( chr->poisoned() )  // if poisoned send 0x17 for newer clients
+          msgpoison.Send( client );
 
-            if ( chr->invul() )  // if invul send 0x17 for newer clients
-              msginvul.Send( client );
-            return;
-          }
-          else
-          {
+        if ( chr->invul() )  // if invul send 0x17 for newer clients
+          msginvul.Send( client );
+        return;
+      }
+      else
+      {
 // NOTE: uncomment this line to make movement smoother (no stepping anims)
 // but basically makes it very difficult to talk while the ship
 // is moving.
 #ifdef PERGON
-            send_remove_character( client, chr, msgremove );
+        send_remove_character( client, chr, msgremove );
 #else
 // send_remove_character( client, chr );
 #endif
-            send_owncreate( client, chr, msgcreate.Get() );
-            if ( chr->poisoned() )
-              msgpoison.Send( client );
-            if ( chr->invul() )
-              msginvul.Send( client );
-          }
-        }
-        else if ( zonechr->in_visual_range( nullptr, chr->lastpos ) )
-        {
-          msgmove.Send( client );
-          if ( chr->poisoned() )
-            msgpoison.Send( client );
-          if ( chr->invul() )
-            msginvul.Send( client );
-        }
-        else
+        send_owncreate( client, chr, msgcreate.Get() );
+        if ( chr->poisoned() )
+          msgpoison.Send( client );
+        if ( chr->invul() )
+          msginvul.Send( client );
+      }
+    }
+    else if ( zonechr->in_visual_range( nullptr, chr->lastpos ) &&
+              client->knows_mobile( chr->serial ) )
+    {
+      msgmove.Send( client );
+      if ( chr->poisoned() )
+        msgpoison.Send( client );
+      if ( chr->invul() )
+        msginvul.Send( client );
+    }
+    else
+    {
+      send_owncreate( client, chr, msgcreate.Get() );
+      if ( chr->poisoned() )
+        msgpoison.Send( client );
+      if ( chr->invul() )
+        msginvul.Send( client );
+    }
+  };
+  // chr is not visible to zonechr at its new position. If its client still knows chr, we just
+  // walked out of range (or became invisible), send a remove or else a ghost will remain.
+  auto send_leave = [&]( Character* zonechr )
+  { send_remove_character( zonechr->client, chr, msgremove ); };
+
+  const auto range = Core::gamestate.max_update_range;
+  if ( chr->lastpos.realm() == chr->realm() && chr->distance_to( chr->lastpos ) <= range )
+  {
+    // For ordinary steps the old and new visual range overlap nearly completely. Visit their
+    // union once and diff per player whether chr entered, moved within or left its range.
+    const Core::Vec2d r( static_cast<s16>( range ), static_cast<s16>( range ) );
+    const Core::Pos2d nw( std::min( chr->x(), chr->lastpos.x() ),
+                          std::min( chr->y(), chr->lastpos.y() ) );
+    const Core::Pos2d se( std::max( chr->x(), chr->lastpos.x() ),
+                          std::max( chr->y(), chr->lastpos.y() ) );
+    Core::WorldIterator<Core::OnlinePlayerFilter>::InBox(
+        Core::Range2d( nw - r, se + r, chr->realm() ), chr->realm(),
+        [&]( Character* zonechr )
         {
-          send_owncreate( client, chr, msgcreate.Get() );
-          if ( chr->poisoned() )
-            msgpoison.Send( client );
-          if ( chr->invul() )
-            msginvul.Send( client );
-        }
-      } );
+          if ( zonechr == chr )
+            return;
+          if ( zonechr->is_visible_to_me( chr ) )
+            send_update( zonechr );
+          else
+            send_leave( zonechr );
+        } );
+    return;
+  }
 
-  // iter over all old in range players and send remove
+  // teleported: the areas are disjoint, iterate over both
   Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
-      chr->lastpos,
+      chr,
       [&]( Character* zonechr )
       {
-        Client* client = zonechr->client;
-        if ( !zonechr->in_visual_range( nullptr, chr->lastpos ) )
+        if ( zonechr == chr )
           return;
-        if ( !zonechr->is_visible_to_me( chr, /*check_range*/ false ) )
+        if ( !zonechr->is_visible_to_me( chr ) )
           return;
+        send_update( zonechr );
+      } );
 
-        if ( zonechr->in_visual_range( chr ) )  // already handled
-          return;
-        // if we just walked out of range of this character, send its
-        // client a remove object, or else a ghost character will remain.
-        send_remove_character( client, chr, msgremove );
+  // iter over all old in range players and send remove
+  Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
+      chr->lastpos,
+      [&]( Character* zonechr )
+      {
+        if ( !zonechr->is_visible_to_me( chr ) )
+          send_leave( zonechr );
       } );
 }
 
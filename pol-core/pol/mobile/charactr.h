@@ -112,7 +112,6 @@ class OneShotTask;
 class MenuItem;
 class Party;
 class RepSystem;
-class SaveContext;
 class Spellbook;
 class UOExecutor;
 class USpell;
@@ -126,13 +125,17 @@ void ClientCreateChar( Network::Client* client, PKTIN_00* msg );
 void ClientCreateCharKR( Network::Client* client, PKTIN_8D* msg );
 void ClientCreateChar70160( Network::Client* client, PKTIN_F8* msg );
 void createchar2( Accounts::Account* acct, unsigned index );
-void write_characters( SaveContext& sc );
-void write_npcs( SaveContext& sc );
+void write_characters( const std::vector<Mobile::Character*>& chrs, Clib::StreamWriter& sw,
+                       Clib::StreamWriter& sw_equip );
 }  // namespace Core
 namespace Module
 {
 class UOExecutorModule;
 }
+namespace Realms
+{
+class DeferredActions;
+}
 namespace Mobile
 {
 class Attribute;
@@ -496,7 +499,8 @@ public:
 
   const VitalValue& vital( unsigned vitalid ) const;
   VitalValue& vital( unsigned vitalid );
-  void regen_vital( const Core::Vital* );                         // throw()
+  // only touches this character, client updates and the depleted hook are deferred
+  void regen_vital( const Core::Vital*, Realms::DeferredActions& deferred );
   void calc_vital_stuff( bool i_mod = true, bool v_mod = true );  // throw()
   void calc_single_vital( const Core::Vital* pVital );
   void calc_single_attribute( const Attribute* pAttr );
@@ -554,6 +558,7 @@ public:
   void clear_my_aggressors();
   void clear_my_lawful_damagers();
   void check_undamaged();
+  void check_undamaged( Realms::DeferredActions& deferred );
 
   void on_criminal_changed();
   void on_murderer_changed();
@@ -700,8 +705,8 @@ public:
   void readAttributesAndVitals( Clib::ConfigElem& elem );
 
 protected:
-  friend void Core::write_characters( Core::SaveContext& sc );
-  friend void Core::write_npcs( Core::SaveContext& sc );
+  friend void Core::write_characters( const std::vector<Mobile::Character*>& chrs,
+                                     Clib::StreamWriter& sw, Clib::StreamWriter& sw_equip );
 
   void printWornItems( Clib::StreamWriter& sw_pc, Clib::StreamWriter& sw_equip ) const;
 
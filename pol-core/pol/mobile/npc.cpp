@@ -641,6 +641,7 @@ void NPC::restart_script()
     if ( ex->in_debugger_holdlist() )
       ex->revive_debugged();
     ex = nullptr;
+    Core::unregister_area_event_listener( this );
     // when the NPC executor module destructs, it checks this NPC to see if it points
     // back at it.  If not, it leaves us alone.
   }
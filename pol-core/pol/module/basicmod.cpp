@@ -10,13 +10,21 @@
 
 
 #include "basicmod.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <picojson/picojson.h>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "../../bscript/berror.h"
+#include "../../bscript/binpack.h"
 #include "../../bscript/bobject.h"
 #include "../../bscript/dict.h"
 #include "../../bscript/executor.h"
@@ -488,7 +496,10 @@ Bscript::BObjectImp* BasicExecutorModule::mf_SplitWords()
 Bscript::BObjectImp* BasicExecutorModule::mf_Pack()
 {
   Bscript::BObjectImp* imp = exec.getParamImp( 0 );
-  return new String( imp->pack() );
+  int format;
+  if ( !exec.getParam( 1, format ) || !Bscript::valid_pack_format( format ) )
+    return new BError( "Invalid pack format" );
+  return new String( Bscript::pack( *imp, static_cast<Bscript::PackFormat>( format ) ) );
 }
 
 Bscript::BObjectImp* BasicExecutorModule::mf_Unpack()
@@ -520,105 +531,302 @@ Bscript::BObjectImp* BasicExecutorModule::mf_TypeOfInt()
   return new BLong( imp->typeOfInt() );
 }
 
-picojson::value recurseE2J( BObjectImp* value )
+namespace
 {
-  if ( auto* s = impptrIf<String>( value ) )
-  {
-    return picojson::value( s->getStringRep() );
-  }
-  else if ( auto* l = impptrIf<BLong>( value ) )
-  {
-    return picojson::value( static_cast<double>( l->value() ) );
-  }
-  else if ( auto* d = impptrIf<Double>( value ) )
+// Renders script objects directly into a string, the output is the same as the serialization of
+// a picojson::value: object keys are sorted and unique (first one wins), numbers are doubles and
+// unsupported types become null.
+class JsonWriter
+{
+public:
+  JsonWriter( std::string& out, bool prettify ) : out_( out ), indent_( prettify ? 0 : -1 ) {}
+
+  void write( BObjectImp* value )
   {
-    return picojson::value( d->value() );
+    write_value( value );
+    if ( indent_ == 0 )
+      out_ += '\n';
   }
-  else if ( auto* b = impptrIf<BBoolean>( value ) )
+
+private:
+  typedef std::vector<std::pair<std::string_view, BObjectImp*>> Members;
+
+  void write_value( BObjectImp* value )
   {
-    return picojson::value( b->value() );
+    if ( auto* s = impptrIf<String>( value ) )
+    {
+      write_string( s->value() );
+    }
+    else if ( auto* l = impptrIf<BLong>( value ) )
+    {
+      fmt::format_to( std::back_inserter( out_ ), "{}", l->value() );
+    }
+    else if ( auto* d = impptrIf<Double>( value ) )
+    {
+      write_number( d->value() );
+    }
+    else if ( auto* b = impptrIf<BBoolean>( value ) )
+    {
+      out_ += b->value() ? "true" : "false";
+    }
+    else if ( auto* a = impptrIf<ObjArray>( value ) )
+    {
+      out_ += '[';
+      begin_block();
+      bool empty = true;
+      for ( const auto& elem : a->ref_arr )
+      {
+        BObject* bo = elem.get();
+        if ( bo == nullptr )
+          continue;
+        if ( !empty )
+          out_ += ',';
+        empty = false;
+        newline();
+        write_value( bo->impptr() );
+      }
+      end_block( empty );
+      out_ += ']';
+    }
+    else if ( auto* bstruct = impptrIf<BStruct>( value ) )
+    {
+      Members members;
+      members.reserve( bstruct->contents().size() );
+      for ( const auto& content : bstruct->contents() )
+        members.emplace_back( content.first, content.second->impptr() );
+      write_object( members );
+    }
+    else if ( auto* dict = impptrIf<BDictionary>( value ) )
+    {
+      std::vector<std::string> keys;
+      keys.reserve( dict->contents().size() );  // keeps the views valid
+      Members members;
+      members.reserve( dict->contents().size() );
+      for ( const auto& content : dict->contents() )
+      {
+        keys.push_back( content.first->getStringRep() );
+        members.emplace_back( keys.back(), content.second->impptr() );
+      }
+      write_object( members );
+    }
+    else
+    {
+      out_ += "null";
+    }
   }
-  else if ( auto* a = impptrIf<ObjArray>( value ) )
-  {
-    picojson::array jsonArr;
 
-    for ( const auto& elem : a->ref_arr )
+  void write_object( Members& members )
+  {
+    std::stable_sort( members.begin(), members.end(),
+                      []( const auto& a, const auto& b ) { return a.first < b.first; } );
+    out_ += '{';
+    begin_block();
+    const std::string_view* last = nullptr;
+    for ( const auto& [key, imp] : members )
     {
-      BObject* bo = elem.get();
-      if ( bo == nullptr )
+      if ( last != nullptr && *last == key )
         continue;
-      BObjectImp* imp = bo->impptr();
-      jsonArr.push_back( recurseE2J( imp ) );
+      if ( last != nullptr )
+        out_ += ',';
+      last = &key;
+      newline();
+      write_string( key );
+      out_ += ':';
+      if ( indent_ != -1 )
+        out_ += ' ';
+      write_value( imp );
     }
-    return picojson::value( jsonArr );
+    end_block( last == nullptr );
+    out_ += '}';
   }
-  else if ( auto* bstruct = impptrIf<BStruct>( value ) )
+
+  void write_string( std::string_view value )
   {
-    picojson::object jsonObj;
-    for ( const auto& content : bstruct->contents() )
+    out_ += '"';
+    auto plain = value.begin();
+    for ( auto itr = value.begin(); itr != value.end(); ++itr )
     {
-      BObjectImp* imp = content.second->impptr();
-      jsonObj.insert( std::pair<std::string, picojson::value>( content.first, recurseE2J( imp ) ) );
+      const char* escaped = nullptr;
+      switch ( *itr )
+      {
+      case '"':
+        escaped = "\\\"";
+        break;
+      case '\\':
+        escaped = "\\\\";
+        break;
+      case '/':
+        escaped = "\\/";
+        break;
+      case '\b':
+        escaped = "\\b";
+        break;
+      case '\f':
+        escaped = "\\f";
+        break;
+      case '\n':
+        escaped = "\\n";
+        break;
+      case '\r':
+        escaped = "\\r";
+        break;
+      case '\t':
+        escaped = "\\t";
+        break;
+      default:
+        if ( static_cast<unsigned char>( *itr ) >= 0x20 && *itr != 0x7f )
+          continue;
+        break;
+      }
+      out_.append( plain, itr );
+      plain = std::next( itr );
+      if ( escaped != nullptr )
+        out_ += escaped;
+      else
+        fmt::format_to( std::back_inserter( out_ ), "\\u{:04x}", *itr & 0xff );
     }
-    return picojson::value( jsonObj );
+    out_.append( plain, value.end() );
+    out_ += '"';
   }
-  else if ( auto* dict = impptrIf<BDictionary>( value ) )
+
+  void write_number( double value )
+  {
+    if ( std::isnan( value ) || std::isinf( value ) )
+      throw std::overflow_error( "PackJSON: number is NaN or infinite" );
+    char buf[64];
+    double tmp;
+    snprintf( buf, sizeof( buf ),
+              std::fabs( value ) < ( 1ULL << 53 ) && std::modf( value, &tmp ) == 0 ? "%.f"
+                                                                                   : "%.17g",
+              value );
+    out_ += buf;
+  }
+
+  void begin_block()
+  {
+    if ( indent_ != -1 )
+      ++indent_;
+  }
+  void end_block( bool empty )
   {
-    picojson::object jsonObj;
-    for ( const auto& content : dict->contents() )
+    if ( indent_ != -1 )
     {
-      BObjectImp* imp = content.second->impptr();
-      jsonObj.insert( std::pair<std::string, picojson::value>( content.first->getStringRep(),
-                                                               recurseE2J( imp ) ) );
+      --indent_;
+      if ( !empty )
+        newline();
     }
-    return picojson::value( jsonObj );
   }
-  return picojson::value();
-}
-Bscript::BObjectImp* BasicExecutorModule::mf_PackJSON()
-{
-  BObjectImp* imp = exec.getParamImp( 0 );
-  auto prettify = exec.getParamImp( 1 )->isTrue();
+  void newline()
+  {
+    if ( indent_ == -1 )
+      return;
+    out_ += '\n';
+    out_.append( indent_ * picojson::INDENT_WIDTH, ' ' );
+  }
 
-  return new String( recurseE2J( imp ).serialize( prettify ) );
-}
+  std::string& out_;
+  int indent_;
+};
 
-Bscript::BObjectImp* recurseJ2E( const picojson::value& v )
+// picojson parse context which builds the script objects directly, instead of a picojson::value
+// tree which gets converted afterwards.
+class ScriptParseContext
 {
-  if ( v.is<std::string>() )
+  struct ImpDeleter
+  {
+    // UninitObject is a shared instance, let the refcount decide
+    void operator()( BObjectImp* imp ) const { BObject release( imp ); }
+  };
+
+public:
+  explicit ScriptParseContext( size_t depth = picojson::DEFAULT_MAX_DEPTHS ) : depth_( depth ) {}
+  ScriptParseContext( const ScriptParseContext& ) = delete;
+  ScriptParseContext& operator=( const ScriptParseContext& ) = delete;
+
+  BObjectImp* release() { return value_.release(); }
+
+  bool set_null()
+  {
+    value_.reset( UninitObject::create() );
+    return true;
+  }
+  bool set_bool( bool b )
   {
-    return new String( v.get<std::string>() );
+    value_.reset( new BBoolean( b ) );
+    return true;
   }
-  else if ( v.is<double>() )
+  bool set_number( double f )
   {
     // Possible improvement: separate into BLong and Double
-    return new Double( v.get<double>() );
+    value_.reset( new Double( f ) );
+    return true;
   }
-  else if ( v.is<bool>() )
+  template <typename Iter>
+  bool parse_string( picojson::input<Iter>& in )
   {
-    return new BBoolean( v.get<bool>() );
+    std::string str;
+    if ( !picojson::_parse_string( str, in ) )
+      return false;
+    value_.reset( new String( str ) );
+    return true;
   }
-  else if ( v.is<picojson::array>() )
+  bool parse_array_start()
   {
-    std::unique_ptr<ObjArray> objarr( new ObjArray );
-    const picojson::array& arr = v.get<picojson::array>();
-    for ( const auto& elem : arr )
-    {
-      objarr->addElement( recurseJ2E( elem ) );
-    }
-    return objarr.release();
+    if ( depth_ == 0 )
+      return false;
+    value_.reset( new ObjArray );
+    return true;
   }
-  else if ( v.is<picojson::object>() )
+  template <typename Iter>
+  bool parse_array_item( picojson::input<Iter>& in, size_t )
   {
-    std::unique_ptr<BStruct> objstruct( new BStruct );
-    for ( const auto& content : v.get<picojson::object>() )
-    {
-      objstruct->addMember( content.first.c_str(), recurseJ2E( content.second ) );
-    }
-    return objstruct.release();
+    ScriptParseContext item( depth_ - 1 );
+    if ( !picojson::_parse( item, in ) )
+      return false;
+    static_cast<ObjArray*>( value_.get() )->addElement( item.release() );
+    return true;
   }
-  else
-    return UninitObject::create();
+  bool parse_array_stop( size_t ) { return true; }
+  bool parse_object_start()
+  {
+    if ( depth_ == 0 )
+      return false;
+    value_.reset( new BStruct );
+    return true;
+  }
+  template <typename Iter>
+  bool parse_object_item( picojson::input<Iter>& in, const std::string& key )
+  {
+    ScriptParseContext item( depth_ - 1 );
+    if ( !picojson::_parse( item, in ) )
+      return false;
+    static_cast<BStruct*>( value_.get() )->addMember( key.c_str(), item.release() );
+    return true;
+  }
+  bool parse_object_stop() { return true; }
+
+private:
+  std::unique_ptr<BObjectImp, ImpDeleter> value_;
+  size_t depth_;
+};
+}  // namespace
+
+Bscript::BObjectImp* BasicExecutorModule::mf_PackJSON()
+{
+  BObjectImp* imp = exec.getParamImp( 0 );
+  auto prettify = exec.getParamImp( 1 )->isTrue();
+
+  // reused between calls, big results would otherwise regrow it every time
+  static thread_local std::string buffer;
+  buffer.clear();
+  JsonWriter( buffer, prettify ).write( imp );
+  auto* result = new String( buffer );
+  if ( buffer.capacity() > 0x100000 )
+  {
+    buffer.clear();
+    buffer.shrink_to_fit();
+  }
+  return result;
 }
 
 Bscript::BObjectImp* BasicExecutorModule::mf_UnpackJSON()
@@ -627,13 +835,14 @@ Bscript::BObjectImp* BasicExecutorModule::mf_UnpackJSON()
 
   if ( exec.getStringParam( 0, str ) )
   {
-    picojson::value v;
-    std::string err = picojson::parse( v, str->data() );
+    ScriptParseContext ctx;
+    std::string err;
+    picojson::_parse( ctx, str->value().cbegin(), str->value().cend(), &err );
     if ( !err.empty() )
     {
       return new BError( err );
     }
-    return recurseJ2E( v );
+    return ctx.release();
   }
   else
   {
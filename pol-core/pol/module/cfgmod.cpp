@@ -465,7 +465,7 @@ Bscript::BObjectImp* ConfigFileExecutorModule::mf_GetConfigStringArray()
     std::unique_ptr<Bscript::ObjArray> ar( new Bscript::ObjArray );
     for ( ; itr != end; ++itr )
     {
-      Bscript::BObjectImp* imp = ( *itr ).second.get();
+      Bscript::BObjectImp* imp = itr->imp.get();
       // Added 9-03-2005  Austin
       // Will no longer place the string right into the array.
       // Instead a check is done to make sure something is there.
@@ -495,7 +495,7 @@ Bscript::BObjectImp* ConfigFileExecutorModule::mf_GetConfigStringDictionary()
     std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
     for ( ; itr != end; ++itr )
     {
-      Bscript::BObjectImp* line = ( *itr ).second.get();
+      Bscript::BObjectImp* line = itr->imp.get();
 
       std::string line_str = line->getStringRep();
       if ( line_str.length() < 1 )
@@ -578,7 +578,7 @@ Bscript::BObjectImp* ConfigFileExecutorModule::mf_GetConfigIntArray()
     std::unique_ptr<Bscript::ObjArray> ar( new Bscript::ObjArray );
     for ( ; itr != end; ++itr )
     {
-      Bscript::BObjectImp* imp = ( *itr ).second.get();
+      Bscript::BObjectImp* imp = itr->imp.get();
       // Will no longer place the string right into the array.
       // Instead a check is done to make sure something is there.
 
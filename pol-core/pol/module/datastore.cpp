@@ -11,8 +11,12 @@
 #include "datastore.h"
 #include <exception>
 #include <filesystem>
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "../../bscript/berror.h"
 #include "../../bscript/bobject.h"
@@ -23,9 +27,11 @@
 #include "../../clib/cfgelem.h"
 #include "../../clib/cfgfile.h"
 #include "../../clib/fileutil.h"
+#include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
 #include "../../clib/stlutil.h"
 #include "../../clib/streamsaver.h"
+#include "../../clib/strutil.h"
 #include "../../plib/pkg.h"
 #include "../../plib/systemstate.h"
 #include "../globals/ucfg.h"
@@ -44,12 +50,51 @@ namespace Module
 ///  datastore files are stored in
 ///     config.world_data_path + ds/fname.txt
 ///     config.world_data_path + ds/{pkgname}/fname.txt
+///  changes since the file was written are appended to fname.journal.txt next to it
 ///
 
 Bscript::BApplicObjType datafileref_type;
 Bscript::BApplicObjType datafileelem_type;
 
-DataFileContents::DataFileContents( DataStoreFile* dsf ) : dsf( dsf ), dirty( false ) {}
+namespace
+{
+// reads one line without its line break, offset advances by the bytes consumed
+bool read_line( FILE* fp, std::string& line, size_t& offset )
+{
+  char buffer[1024];
+  line.clear();
+  while ( fgets( buffer, sizeof buffer, fp ) )
+  {
+    size_t len = strlen( buffer );
+    offset += len;
+    if ( buffer[len - 1] == '\n' )
+    {
+      line.append( buffer, len - 1 );
+      if ( !line.empty() && line.back() == '\r' )
+        line.pop_back();
+      return true;
+    }
+    line.append( buffer, len );
+  }
+  return !line.empty();
+}
+
+bool ends_element( const std::string& line )
+{
+  size_t start = line.find_first_not_of( " \t" );
+  return start != std::string::npos && line[start] == '}' &&
+         ( start + 1 == line.size() || isspace( static_cast<unsigned char>( line[start + 1] ) ) );
+}
+}  // namespace
+
+DataFileContents::DataFileContents( DataStoreFile* dsf )
+    : dsf( dsf ),
+      dirty( false ),
+      source_version( dsf->version ),
+      base_written( false ),
+      journal_records( 0 )
+{
+}
 
 DataFileContents::~DataFileContents()
 {
@@ -60,52 +105,239 @@ DataFileContents::~DataFileContents()
 size_t DataFileContents::estimateSize() const
 {
   size_t size = sizeof( DataStoreFile* ) /*dsf*/
-                + sizeof( bool );        /*dirty*/
+                + sizeof( bool )         /*dirty*/
+                + sizeof( unsigned )     /*source_version*/
+                + sizeof( readers ) + sizeof( bool ) /*base_written*/
+                + sizeof( size_t );                  /*journal_records*/
 
   size += Clib::memsize( elements_by_string );
   for ( const auto& ele : elements_by_string )
   {
-    if ( ele.second.get() != nullptr )
-      size += ele.second->proplist.estimatedSize();
+    if ( ele.second.elem.get() != nullptr )
+      size += ele.second.elem->proplist.estimatedSize();
   }
   size += Clib::memsize( elements_by_integer );
+  for ( const auto& ele : elements_by_integer )
+  {
+    if ( ele.second.elem.get() != nullptr )
+      size += ele.second.elem->proplist.estimatedSize();
+  }
+  size += Clib::memsize( deleted_strings ) + Clib::memsize( deleted_integers );
   return size;
 }
 
-void DataFileContents::load( Clib::ConfigFile& cf )
+/**
+ * Indexes the elements of the base file or the journal up to limit, without reading their
+ * properties. Journal records replace or delete the elements found before.
+ * Returns the offset the scan stopped at.
+ */
+size_t DataFileContents::scan( Source source, size_t limit )
 {
-  Clib::ConfigElem elem;
-
-  while ( cf.read( elem ) )
+  std::string fn = source_filename( source );
+  std::unique_ptr<FILE, decltype( &fclose )> fp( fopen( fn.c_str(), "rb" ), &fclose );
+  if ( !fp )
+    throw std::runtime_error( "Unable to open " + fn );
+
+  std::string line, type, rest;
+  size_t offset = 0;
+  while ( offset < limit )
   {
-    DataFileElement* delem = new DataFileElement( elem );
-
+    size_t start = offset;
+    if ( !read_line( fp.get(), line, offset ) )
+      break;
+    if ( start == 0 )
+      Clib::remove_bom( &line );
+    Clib::sanitizeUnicodeWithIso( &line );
+    Clib::splitnamevalue( line, type, rest );
+    if ( type.empty() || type[0] == '#' || type.compare( 0, 2, "//" ) == 0 )
+      continue;
+
+    bool deleted = source == JOURNAL && type == "Deleted";
+    if ( !deleted && type != "Element" )
+      throw std::runtime_error( fmt::format( "{}: Unexpected type '{}'", fn, type ) );
+    if ( !read_line( fp.get(), line, offset ) || line.empty() || line[0] != '{' )
+      throw std::runtime_error( fmt::format( "{}: Expected '{{' after element type", fn ) );
+    do
+    {
+      if ( !read_line( fp.get(), line, offset ) )
+        throw std::runtime_error( fmt::format( "{}: Expected '}}' after element properties", fn ) );
+    } while ( !ends_element( line ) );
+    if ( offset > limit )
+      return start;
+
+    if ( source == JOURNAL )
+      ++journal_records;
     if ( dsf->flags & DF_KEYTYPE_INTEGER )
     {
-      elements_by_integer[atol( elem.rest() )].set( delem );
+      int key = atol( rest.c_str() );
+      if ( deleted )
+        elements_by_integer.erase( key );
+      else
+        elements_by_integer[key] = Entry{ DataFileElementRef(), start, source };
     }
     else
     {
-      elements_by_string[elem.rest()].set( delem );
+      if ( deleted )
+        elements_by_string.erase( rest );
+      else
+        elements_by_string[rest] = Entry{ DataFileElementRef(), start, source };
     }
   }
+  return offset;
+}
+
+void DataFileContents::load()
+{
+  source_version = dsf->version;
+  scan( BASE, std::numeric_limits<size_t>::max() );
+  base_written = true;
+
+  if ( dsf->journal_size == 0 )
+    return;
+  size_t journal_size = 0;
+  if ( Clib::FileExists( source_filename( JOURNAL ) ) )
+    journal_size = scan( JOURNAL, dsf->journal_size );
+  if ( journal_size != dsf->journal_size )
+  {
+    POLLOG_ERRORLN( "Datafile {}: journal is shorter than the expected {} bytes, using {} bytes",
+                    dsf->descriptor, dsf->journal_size, journal_size );
+    dsf->journal_size = journal_size;
+  }
+}
+
+std::string DataFileContents::source_filename( Source source ) const
+{
+  if ( source == BASE )
+    return dsf->filename( source_version );
+  return dsf->journal_filename( source_version );
+}
+
+DataFileElementRef DataFileContents::read_element( const Entry& entry )
+{
+  auto& reader = readers[entry.source];
+  if ( !reader )
+    reader.reset( new Clib::ConfigFile( source_filename( entry.source ), "Element" ) );
+  reader->seek( entry.offset );
+  Clib::ConfigElem elem;
+  if ( !reader->read( elem ) )
+    throw std::runtime_error( fmt::format( "{}: element at offset {} vanished",
+                                           reader->filename(), entry.offset ) );
+  return DataFileElementRef( new DataFileElement( elem ) );
 }
 
-void DataFileContents::save( Clib::StreamWriter& sw )
+DataFileElementRef DataFileContents::element( Entry& entry )
 {
-  for ( const auto& element : elements_by_string )
+  if ( entry.elem.get() == nullptr )
+    entry.elem = read_element( entry );
+  return entry.elem;
+}
+
+// the journal would need more reading on load than the elements themselves
+bool DataFileContents::needs_full_save() const
+{
+  size_t count = elements_by_string.size() + elements_by_integer.size();
+  return !base_written || journal_records >= std::max<size_t>( 1024, count );
+}
+
+template <class Elements>
+void DataFileContents::write_elements( Clib::StreamWriter& sw, Elements& elements,
+                                       std::vector<size_t>& offsets )
+{
+  for ( auto& element : elements )
   {
+    offsets.push_back( sw.tell() );
+    // elements which are not loaded only pass through
+    DataFileElementRef elem = element.second.elem;
+    if ( elem.get() == nullptr )
+      elem = read_element( element.second );
     sw.begin( "Element", element.first );
-    element.second->printOn( sw );
+    elem->printOn( sw );
     sw.end();
   }
+}
 
-  for ( const auto& element : elements_by_integer )
+void DataFileContents::save( const std::string& filename )
+{
+  std::vector<size_t> offsets;
+  offsets.reserve( elements_by_string.size() + elements_by_integer.size() );
+  Clib::StreamWriter sw( filename );
+  write_elements( sw, elements_by_string, offsets );
+  write_elements( sw, elements_by_integer, offsets );
+  sw.flush_close();
+
+  // written completely, the entries refer to the new file from now on
+  auto offset = offsets.cbegin();
+  auto update = [&]( Entry& entry )
+  {
+    entry.offset = *offset++;
+    entry.source = BASE;
+    if ( entry.elem.get() != nullptr )
+      entry.elem->dirty = false;
+  };
+  for ( auto& element : elements_by_string )
+    update( element.second );
+  for ( auto& element : elements_by_integer )
+    update( element.second );
+  readers[BASE].reset();
+  readers[JOURNAL].reset();
+  source_version = dsf->version;
+  deleted_strings.clear();
+  deleted_integers.clear();
+  base_written = true;
+  journal_records = 0;
+}
+
+template <class Elements>
+size_t DataFileContents::write_changed_elements( Clib::StreamWriter& sw, Elements& elements )
+{
+  size_t records = 0;
+  for ( auto& element : elements )
   {
+    const DataFileElementRef& elem = element.second.elem;
+    if ( elem.get() == nullptr || !elem->dirty )
+      continue;
     sw.begin( "Element", element.first );
-    element.second->printOn( sw );
+    elem->printOn( sw );
+    sw.end();
+    ++records;
+  }
+  return records;
+}
+
+size_t DataFileContents::save_journal( const std::string& filename, size_t journal_size )
+{
+  // starts at the committed size, dropping whatever a failed save left behind
+  Clib::StreamWriter sw( filename, journal_size );
+  for ( const auto& key : deleted_strings )
+  {
+    sw.begin( "Deleted", key );
     sw.end();
   }
+  for ( const auto& key : deleted_integers )
+  {
+    sw.begin( "Deleted", key );
+    sw.end();
+  }
+  size_t records = deleted_strings.size() + deleted_integers.size();
+  records += write_changed_elements( sw, elements_by_string );
+  records += write_changed_elements( sw, elements_by_integer );
+  sw.flush_close();
+
+  // the records stay at their place in the journal, the elements remain loaded
+  for ( auto& element : elements_by_string )
+  {
+    if ( element.second.elem.get() != nullptr )
+      element.second.elem->dirty = false;
+  }
+  for ( auto& element : elements_by_integer )
+  {
+    if ( element.second.elem.get() != nullptr )
+      element.second.elem->dirty = false;
+  }
+  deleted_strings.clear();
+  deleted_integers.clear();
+  journal_records += records;
+  return sw.tell();
 }
 
 Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
@@ -115,12 +347,19 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
   if ( itr == elements_by_integer.end() )
   {
     dfelem.set( new DataFileElement );
-    elements_by_integer[key] = dfelem;
+    elements_by_integer[key] = Entry{ dfelem, 0, BASE };
     dirty = true;
   }
   else
   {
-    dfelem = ( *itr ).second;
+    try
+    {
+      dfelem = element( ( *itr ).second );
+    }
+    catch ( std::exception& ex )
+    {
+      return new Bscript::BError( std::string( "An exception occurred: " ) + ex.what() );
+    }
   }
   return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
 }
@@ -132,12 +371,19 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( const std::string& k
   if ( itr == elements_by_string.end() )
   {
     dfelem.set( new DataFileElement );
-    elements_by_string[key] = dfelem;
+    elements_by_string[key] = Entry{ dfelem, 0, BASE };
     dirty = true;
   }
   else
   {
-    dfelem = ( *itr ).second;
+    try
+    {
+      dfelem = element( ( *itr ).second );
+    }
+    catch ( std::exception& ex )
+    {
+      return new Bscript::BError( std::string( "An exception occurred: " ) + ex.what() );
+    }
   }
   return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
 }
@@ -148,8 +394,15 @@ Bscript::BObjectImp* DataFileContents::methodFindElement( int key )
   ElementsByInteger::iterator itr = elements_by_integer.find( key );
   if ( itr != elements_by_integer.end() )
   {
-    DataFileElementRef dfelem = ( *itr ).second;
-    return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
+    try
+    {
+      DataFileElementRef dfelem = element( ( *itr ).second );
+      return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
+    }
+    catch ( std::exception& ex )
+    {
+      return new Bscript::BError( std::string( "An exception occurred: " ) + ex.what() );
+    }
   }
   else
   {
@@ -162,8 +415,15 @@ Bscript::BObjectImp* DataFileContents::methodFindElement( const std::string& key
   ElementsByString::iterator itr = elements_by_string.find( key );
   if ( itr != elements_by_string.end() )
   {
-    DataFileElementRef dfelem = ( *itr ).second;
-    return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
+    try
+    {
+      DataFileElementRef dfelem = element( ( *itr ).second );
+      return new DataElemRefObjImp( DataFileContentsRef( this ), dfelem );
+    }
+    catch ( std::exception& ex )
+    {
+      return new Bscript::BError( std::string( "An exception occurred: " ) + ex.what() );
+    }
   }
   else
   {
@@ -176,6 +436,7 @@ Bscript::BObjectImp* DataFileContents::methodDeleteElement( int key )
 {
   if ( elements_by_integer.erase( key ) )
   {
+    deleted_integers.push_back( key );
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -187,6 +448,7 @@ Bscript::BObjectImp* DataFileContents::methodDeleteElement( const std::string& k
 {
   if ( elements_by_string.erase( key ) )
   {
+    deleted_strings.push_back( key );
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -350,7 +612,10 @@ Bscript::BObjectImp* DataElemRefObjImp::call_method_id( const int id, Bscript::E
   bool changed = false;
   Bscript::BObjectImp* res = CallPropertyListMethod_id( obj_.dfelem->proplist, id, ex, changed );
   if ( changed )
+  {
+    obj_.dfelem->dirty = true;
     obj_.dfcontents->dirty = true;
+  }
   return res;
 }
 
@@ -360,7 +625,10 @@ Bscript::BObjectImp* DataElemRefObjImp::call_method( const char* methodname, Bsc
   Bscript::BObjectImp* res =
       CallPropertyListMethod( obj_.dfelem->proplist, methodname, ex, changed );
   if ( changed )
+  {
+    obj_.dfelem->dirty = true;
     obj_.dfcontents->dirty = true;
+  }
   return res;
 }
 
@@ -570,7 +838,8 @@ DataStoreFile::DataStoreFile( Clib::ConfigElem& elem )
       oldversion( elem.remove_ushort( "OldVersion" ) ),
       flags( elem.remove_ulong( "Flags" ) ),
       unload( false ),
-      delversion( 0 )
+      delversion( 0 ),
+      journal_size( elem.remove_ulong( "JournalSize", 0 ) )
 {
 }
 
@@ -584,7 +853,8 @@ DataStoreFile::DataStoreFile( const std::string& descriptor, const Plib::Package
       oldversion( 0 ),
       flags( flags ),
       unload( false ),
-      delversion( 0 )
+      delversion( 0 ),
+      journal_size( 0 )
 {
   if ( pkg != nullptr )
     pkgname = pkg->name();
@@ -605,8 +875,7 @@ void DataStoreFile::load()
   std::string fn = filename();
   if ( Clib::FileExists( fn.c_str() ) )
   {
-    Clib::ConfigFile cf( filename().c_str(), "Element" );
-    dfcontents->load( cf );
+    dfcontents->load();
   }
   else
   {
@@ -632,6 +901,8 @@ void DataStoreFile::printOn( Clib::StreamWriter& sw ) const
   sw.add( "Flags", flags );
   sw.add( "Version", version );
   sw.add( "OldVersion", oldversion );
+  if ( journal_size )
+    sw.add( "JournalSize", journal_size );
   sw.end();
 }
 
@@ -644,20 +915,34 @@ std::string DataStoreFile::filename( unsigned ver ) const
   return tmp;
 }
 
+std::string DataStoreFile::journal_filename( unsigned ver ) const
+{
+  std::string tmp = Plib::systemstate.config.world_data_path + "ds/";
+  if ( pkg != nullptr )
+    tmp += pkg->name() + "/";
+  tmp += name + "." + Clib::tostring( ver % 10 ) + ".journal.txt";
+  return tmp;
+}
+
 std::string DataStoreFile::filename() const
 {
   return filename( version );
 }
 
-void DataStoreFile::save() const
+void DataStoreFile::save()
 {
   auto path = std::filesystem::path( filename() );
   path.remove_filename();
   if ( !std::filesystem::exists( path ) )
     std::filesystem::create_directories( path );
 
-  Clib::StreamWriter sw( filename() );
-  dfcontents->save( sw );
+  dfcontents->save( filename() );
+  journal_size = 0;
+}
+
+void DataStoreFile::save_journal()
+{
+  journal_size = dfcontents->save_journal( journal_filename( version ), journal_size );
 }
 
 size_t DataStoreFile::estimateSize() const
@@ -667,6 +952,7 @@ size_t DataStoreFile::estimateSize() const
                 + 3 * sizeof( unsigned ) /*version oldversion delversion*/
                 + sizeof( int )          /*flags*/
                 + sizeof( bool )         /*unload*/
+                + sizeof( size_t )       /*journal_size*/
                 + sizeof( DataFileContentsRef );
   if ( dfcontents.get() )
     size += dfcontents->estimateSize();
@@ -674,10 +960,13 @@ size_t DataStoreFile::estimateSize() const
 }
 
 
-DataFileElement::DataFileElement() : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ) {}
+DataFileElement::DataFileElement()
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), dirty( true )
+{
+}
 
 DataFileElement::DataFileElement( Clib::ConfigElem& elem )
-    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT )
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), dirty( false )
 {
   proplist.readRemainingPropertiesAsStrings( elem );
 }
@@ -721,10 +1010,17 @@ void write_datastore( Clib::StreamWriter& sw )
 
     if ( dsf->dfcontents.get() && dsf->dfcontents->dirty )
     {
-      // make a new generation of file and write it.
-      ++dsf->version;
-
-      dsf->save();
+      if ( dsf->dfcontents->needs_full_save() )
+      {
+        // make a new generation of file and write it.
+        ++dsf->version;
+        dsf->save();
+      }
+      else
+      {
+        // only append the changes, datastore.txt commits the new journal size
+        dsf->save_journal();
+      }
 
       dsf->dfcontents->dirty = false;
     }
@@ -743,6 +1039,7 @@ void commit_datastore()
     if ( dsf->delversion != dsf->version && dsf->delversion != dsf->oldversion )
     {
       Clib::RemoveFile( dsf->filename( dsf->delversion ) );
+      Clib::RemoveFile( dsf->journal_filename( dsf->delversion ) );
     }
 
     if ( dsf->unload )
@@ -12,7 +12,9 @@
 #include "../proplist.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Pol
 {
@@ -36,12 +38,21 @@ public:
   void printOn( Clib::StreamWriter& sw ) const;
 
   Core::PropertyList proplist;
+  // changed since the last save
+  bool dirty;
 };
 typedef ref_ptr<DataFileElement> DataFileElementRef;
 
 // const int DF_KEYTYPE_STRING = 0x00; // currently unneeded
 const int DF_KEYTYPE_INTEGER = 0x01;
 
+/**
+ * Elements of a datafile.
+ * Loading only indexes the elements of the file and its journal, an element is read when a
+ * script accesses it the first time. Saves append the changed and deleted elements to the
+ * journal, until it holds as many records as there are elements. Then the whole file gets
+ * written again and the journal starts over.
+ */
 class DataFileContents final : public ref_counted
 {
 public:
@@ -49,8 +60,11 @@ public:
   virtual ~DataFileContents();
   size_t estimateSize() const;
 
-  void load( Clib::ConfigFile& cf );
-  void save( Clib::StreamWriter& sw );
+  void load();
+  bool needs_full_save() const;
+  void save( const std::string& filename );
+  // returns the new size of the journal
+  size_t save_journal( const std::string& filename, size_t journal_size );
 
   Bscript::BObjectImp* methodCreateElement( int key );
   Bscript::BObjectImp* methodCreateElement( const std::string& key );
@@ -67,11 +81,40 @@ public:
   bool dirty;
 
 private:
-  typedef std::map<std::string, DataFileElementRef, Clib::ci_cmp_pred> ElementsByString;
-  typedef std::map<int, DataFileElementRef> ElementsByInteger;
+  enum Source : u8
+  {
+    BASE,
+    JOURNAL
+  };
+  struct Entry
+  {
+    // not loaded yet if empty, the element is then found at offset of source
+    DataFileElementRef elem;
+    size_t offset;
+    Source source;
+  };
+  typedef std::map<std::string, Entry, Clib::ci_cmp_pred> ElementsByString;
+  typedef std::map<int, Entry> ElementsByInteger;
+
+  size_t scan( Source source, size_t limit );
+  std::string source_filename( Source source ) const;
+  DataFileElementRef read_element( const Entry& entry );
+  DataFileElementRef element( Entry& entry );
+  template <class Elements>
+  void write_elements( Clib::StreamWriter& sw, Elements& elements, std::vector<size_t>& offsets );
+  template <class Elements>
+  size_t write_changed_elements( Clib::StreamWriter& sw, Elements& elements );
 
   ElementsByString elements_by_string;
   ElementsByInteger elements_by_integer;
+  std::vector<std::string> deleted_strings;
+  std::vector<int> deleted_integers;
+
+  // version of the files the entries refer to
+  unsigned source_version;
+  std::unique_ptr<Clib::ConfigFile> readers[2];
+  bool base_written;
+  size_t journal_records;
 };
 typedef ref_ptr<DataFileContents> DataFileContentsRef;
 
@@ -132,9 +175,11 @@ public:
   size_t estimateSize() const;
   bool loaded() const;
   void load();
-  void save() const;
+  void save();
+  void save_journal();
   std::string filename() const;
   std::string filename( unsigned ver ) const;
+  std::string journal_filename( unsigned ver ) const;
   void printOn( Clib::StreamWriter& sw ) const;
 
   std::string descriptor;
@@ -148,6 +193,8 @@ public:
   bool unload;
 
   unsigned delversion;
+  // committed length of the journal of version
+  size_t journal_size;
 
   DataFileContentsRef dfcontents;
 };
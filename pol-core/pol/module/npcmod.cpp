@@ -30,6 +30,7 @@
 #include "../network/packets.h"
 #include "../network/pktdef.h"
 #include "../polobject.h"
+#include "../proplist.h"
 #include "../uoscrobj.h"
 #include "../uworld.h"
 #include "osmod.h"
@@ -53,7 +54,10 @@ NPCExecutorModule::NPCExecutorModule( Executor& ex, Mobile::NPC& npc )
 NPCExecutorModule::~NPCExecutorModule()
 {
   if ( npc.ex == &exec )
+  {
     npc.ex = nullptr;
+    Core::unregister_area_event_listener( &npc );
+  }
 }
 
 BApplicObjType bounding_box_type;
@@ -811,10 +815,10 @@ BObjectImp* NPCExecutorModule::mf_GetProperty()
   const String* propname_str;
   if ( exec.getStringParam( 0, propname_str ) )
   {
-    std::string val;
-    if ( npc.getprop( propname_str->value(), val ) )
+    BObjectImp* val = npc.getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -833,7 +837,7 @@ BObjectImp* NPCExecutorModule::mf_SetProperty()
   if ( exec.getStringParam( 0, propname_str ) )
   {
     BObjectImp* propval = getParamImp( 1 );
-    npc.setprop( propname_str->value(), propval->pack() );
+    npc.setprop( propname_str->value(), Core::pack_property( *propval ) );
     return new BLong( 1 );
   }
   else
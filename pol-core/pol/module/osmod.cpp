@@ -882,6 +882,11 @@ BObjectImp* OSExecutorModule::mf_HTTPRequest()
 // signal_event() takes ownership of the pointer which is passed to it.
 // Objects must not be touched or deleted after being sent here!
 // TODO: Find a better way to enforce this in the codebase.
+bool OSExecutorModule::event_queue_full() const
+{
+  return events_.size() >= max_eventqueue_size;
+}
+
 bool OSExecutorModule::signal_event( BObjectImp* imp )
 {
   INC_PROFILEVAR( events );
@@ -68,6 +68,7 @@ public:
   bool in_debugger_holdlist() const;
   void revive_debugged();
   Bscript::BObjectImp* clear_event_queue();  // DAVE
+  bool event_queue_full() const;
 
   virtual size_t sizeEstimate() const override;
 
@@ -106,6 +106,8 @@ Bscript::BObjectImp* SQLExecutorModule::background_select( weak_ptr<Core::UOExec
 {
   // The BSQLConnection shouldn't be destroyed before the lambda runs
   ref_ptr<Core::BSQLConnection> sqlRef( sql );
+  // calls on the same connection are executed in order
+  const void* affinity = sql->getConnection().get();
   auto msg = [uoexec, sqlRef, db]()
   {
     if ( sqlRef == nullptr )
@@ -153,7 +155,7 @@ Bscript::BObjectImp* SQLExecutorModule::background_select( weak_ptr<Core::UOExec
         uoexec->scriptname(), uoexec->PC );
     return new Bscript::BError( "Script can't be blocked" );
   }
-  Core::networkManager.sql_service->push( std::move( msg ) );
+  Core::networkManager.sql_service->push( affinity, std::move( msg ) );
   return new BLong( 0 );
 }
 
@@ -179,6 +181,8 @@ Bscript::BObjectImp* SQLExecutorModule::background_query( weak_ptr<Core::UOExecu
 
   // The BSQLConnection shouldn't be destroyed before the lambda runs
   ref_ptr<Core::BSQLConnection> sqlRef( sql );
+  // calls on the same connection are executed in order
+  const void* affinity = sql->getConnection().get();
   auto msg = [uoexec, sqlRef, query, sharedParams]()
   {
     if ( sqlRef == nullptr )  // TODO: this doesn't make any sense and should be checked before the
@@ -228,7 +232,7 @@ Bscript::BObjectImp* SQLExecutorModule::background_query( weak_ptr<Core::UOExecu
     return new Bscript::BError( "Script can't be blocked" );
   }
 
-  Core::networkManager.sql_service->push( std::move( msg ) );
+  Core::networkManager.sql_service->push( affinity, std::move( msg ) );
   return new BLong( 0 );
 }
 
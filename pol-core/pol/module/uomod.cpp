@@ -136,6 +136,7 @@
 #include "../polsem.h"
 #include "../polsig.h"
 #include "../profile.h"
+#include "../proplist.h"
 #include "../savedata.h"
 #include "../scrdef.h"
 #include "../scrsched.h"
@@ -285,6 +286,7 @@ UOExecutorModule::~UOExecutorModule()
   }
   if ( attached_item_.get() )
   {
+    unregister_area_event_listener( attached_item_.get() );
     attached_item_->process( nullptr );
     attached_item_.clear();
   }
@@ -1696,6 +1698,7 @@ BObjectImp* UOExecutorModule::mf_ApplyConstraint()
        getStringParam( 2, propname_str ) && getParam( 3, amthave ) )
   {
     std::unique_ptr<ObjArray> newarr( new ObjArray );
+    const StoredConfigElem::PropKey propkey( propname_str->value() );
 
     for ( unsigned i = 0; i < arr->ref_arr.size(); i++ )
     {
@@ -1713,7 +1716,7 @@ BObjectImp* UOExecutorModule::mf_ApplyConstraint()
       if ( celem.get() == nullptr )
         continue;
 
-      BObjectImp* propval = celem->getimp( propname_str->value() );
+      BObjectImp* propval = celem->getimp( propkey );
       if ( propval == nullptr )
         continue;
       if ( !propval->isa( BObjectImp::OTLong ) )
@@ -1773,10 +1776,10 @@ BObjectImp* UOExecutorModule::mf_GetObjProperty()
   const String* propname_str;
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
-    std::string val;
-    if ( uobj->getprop( propname_str->value(), val ) )
+    BObjectImp* val = uobj->getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -1796,7 +1799,7 @@ BObjectImp* UOExecutorModule::mf_SetObjProperty()
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
     BObjectImp* propval = getParamImp( 2 );
-    uobj->setprop( propname_str->value(), propval->pack() );
+    uobj->setprop( propname_str->value(), pack_property( *propval ) );
     return new BLong( 1 );
   }
   else
@@ -1845,10 +1848,10 @@ BObjectImp* UOExecutorModule::mf_GetGlobalProperty()
   const String* propname_str;
   if ( getStringParam( 0, propname_str ) )
   {
-    std::string val;
-    if ( gamestate.global_properties->getprop( propname_str->value(), val ) )
+    BObjectImp* val = gamestate.global_properties->getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -1867,7 +1870,7 @@ BObjectImp* UOExecutorModule::mf_SetGlobalProperty()
   if ( exec.getStringParam( 0, propname_str ) )
   {
     BObjectImp* propval = exec.getParamImp( 1 );
-    gamestate.global_properties->setprop( propname_str->value(), propval->pack() );
+    gamestate.global_properties->setprop( propname_str->value(), pack_property( *propval ) );
     return new BLong( 1 );
   }
   else
@@ -2905,6 +2908,13 @@ BObjectImp* UOExecutorModule::mf_EnableEvents()
       }
     }
     uoex.eventmask |= eventmask;
+    if ( eventmask & ( EVID_ENTEREDAREA | EVID_LEFTAREA ) )
+    {
+      if ( attached_npc_ != nullptr )
+        register_area_event_listener( attached_npc_ );
+      else if ( attached_item_.get() )
+        register_area_event_listener( attached_item_.get() );
+    }
     return new BLong( uoex.eventmask );
   }
   else
@@ -2920,6 +2930,13 @@ BObjectImp* UOExecutorModule::mf_DisableEvents()
   {
     auto& uoex = uoexec();
     uoex.eventmask &= ~eventmask;
+    if ( !uoex.listens_to( EVID_ENTEREDAREA | EVID_LEFTAREA ) )
+    {
+      if ( attached_npc_ != nullptr )
+        unregister_area_event_listener( attached_npc_ );
+      else if ( attached_item_.get() )
+        unregister_area_event_listener( attached_item_.get() );
+    }
 
     return new BLong( uoex.eventmask );
   }
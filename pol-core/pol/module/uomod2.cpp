@@ -80,6 +80,7 @@
 #include "../network/client.h"
 #include "../network/packethelper.h"
 #include "../network/packetinterface.h"
+#include "../network/packetrules.h"
 #include "../network/packets.h"
 #include "../network/pktboth.h"
 #include "../network/pktdef.h"
@@ -92,6 +93,7 @@
 #include "../savedata.h"
 #include "../scrstore.h"
 #include "../sngclick.h"
+#include "../sqlscrobj.h"
 #include "../statmsg.h"
 #include "../tooltips.h"
 #include "../ufunc.h"
@@ -1812,6 +1814,22 @@ BObjectImp* GetIoStatsObj( const IOStats& stats )
     received->addElement( elem.release() );
   }
 
+  BStruct* tooltip_cache = new BStruct;
+  tooltip_cache->addMember( "hits", new BLong( stats.tooltip_cache.hits ) );
+  tooltip_cache->addMember( "misses", new BLong( stats.tooltip_cache.misses ) );
+  arr->addMember( "tooltip_cache", tooltip_cache );
+
+  BStruct* priority = new BStruct;
+  for ( unsigned i = 0; i < PACKET_PRIORITY_COUNT; ++i )
+  {
+    std::unique_ptr<BStruct> elem( new BStruct );
+    elem->addMember( "queued", new BLong( stats.priority[i].queued ) );
+    elem->addMember( "delayed", new BLong( stats.priority[i].delayed ) );
+    priority->addMember( packet_priority_name( static_cast<PacketPriority>( i ) ),
+                         elem.release() );
+  }
+  arr->addMember( "priority", priority );
+
   return arr.release();
 }
 
@@ -1825,6 +1843,38 @@ BObjectImp* GetQueuedIoStats()
   return GetIoStatsObj( Core::networkManager.queuedmode_iostats );
 }
 
+#ifdef HAVE_MYSQL
+BObjectImp* GetSqlStatsObj()
+{
+  const auto stats = Core::networkManager.sql_service->stats();
+  std::unique_ptr<BStruct> arr = std::make_unique<BStruct>();
+  arr->addMember( "workers", new BLong( Plib::systemstate.config.sql_worker_threads ) );
+  arr->addMember( "queued", new BLong( static_cast<int>( stats.queued ) ) );
+  arr->addMember( "running", new BLong( static_cast<int>( stats.running ) ) );
+  arr->addMember( "executed", new Double( static_cast<double>( stats.executed ) ) );
+  arr->addMember( "wait_total_ms", new Double( static_cast<double>( stats.wait_total_ms ) ) );
+  arr->addMember( "wait_max_ms", new Double( static_cast<double>( stats.wait_max_ms ) ) );
+  arr->addMember( "idle_connections", new BLong( static_cast<int>( stats.idle_connections ) ) );
+  arr->addMember( "reused_connections",
+                  new Double( static_cast<double>( stats.reused_connections ) ) );
+  return arr.release();
+}
+#endif
+
+BObjectImp* GetPacketRulesObj()
+{
+  std::unique_ptr<ObjArray> arr = std::make_unique<ObjArray>();
+  for ( const auto* rule : networkManager.packet_rules.rules() )
+  {
+    std::unique_ptr<BStruct> elem = std::make_unique<BStruct>();
+    elem->addMember( "name", new String( rule->name() ) );
+    elem->addMember( "packet", new BLong( rule->msgid() ) );
+    elem->addMember( "hits", new Double( static_cast<double>( rule->hits() ) ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
 BObjectImp* GetPktStatusObj()
 {
   using namespace PacketWriterDefs;
@@ -1914,6 +1964,14 @@ BObjectImp* GetCoreVariable( const char* corevar )
     return GetQueuedIoStats();
   if ( stricmp( corevar, "pkt_status" ) == 0 )
     return GetPktStatusObj();
+  if ( stricmp( corevar, "packet_rules" ) == 0 )
+    return GetPacketRulesObj();
+  if ( stricmp( corevar, "sql_stats" ) == 0 )
+#ifdef HAVE_MYSQL
+    return GetSqlStatsObj();
+#else
+    return new BError( "POL was not compiled with MySQL support." );
+#endif
   if ( stricmp( corevar, "memory_usage" ) == 0 )
     return new BLong( static_cast<int>( Clib::getCurrentMemoryUsage() / 1024 ) );
   if ( stricmp( corevar, "poldir" ) == 0 )
@@ -724,6 +724,8 @@ bool UBoat::on_ship( const BoatContext& bc, const UObject* obj )
 void UBoat::move_travellers( const BoatContext& oldlocation )
 {
   bool any_orphans = false;
+  ItemMoves item_moves;
+  MobileMoves mobile_moves;
 
   for ( auto& travellerRef : travellers_ )
   {
@@ -744,57 +746,97 @@ void UBoat::move_travellers( const BoatContext& oldlocation )
     if ( obj->ismobile() )
     {
       auto* chr = static_cast<Mobile::Character*>( obj );
-      move_boat_mobile( chr, newtravellerpos );
+      mobile_moves.emplace_back( chr, newtravellerpos );
     }
     else
     {
       auto* item = static_cast<Items::Item*>( obj );
-      move_boat_item( item, newtravellerpos );
+      item_moves.emplace_back( item, newtravellerpos );
 
       if ( Core::settingsManager.ssopt.refresh_decay_after_boat_moves )
         item->restart_decay_timer();
     }
   }
+  move_components( item_moves );
+
+  // items first, so the mobiles already see the deck at its new location
+  move_boat_items( item_moves );
+  for ( const auto& [chr, newpos] : mobile_moves )
+    move_boat_mobile( chr, newpos );
 
   if ( any_orphans )
     remove_orphans();
 }
 
-void UBoat::move_boat_item( Items::Item* item, const Core::Pos4d& newpos )
+// Relocates all items of one boat movement together: the world zones are updated
+// (MoveItemsWorldPosition) and every viewer around the old and new location is visited once for
+// all items, instead of two range sweeps per item.
+void UBoat::move_boat_items( const ItemMoves& moves )
 {
-  item->set_dirty();
-  const Core::Pos4d oldpos = item->pos();
-  item->setposition( newpos );
-  MoveItemWorldPosition( oldpos, item );
-  // TODO POS should be removed
-  if ( oldpos.realm() != newpos.realm() && item->isa( Core::UOBJ_CLASS::CLASS_CONTAINER ) )
+  if ( moves.empty() )
+    return;
+
+  std::vector<Core::Pos4d> oldpos;
+  oldpos.reserve( moves.size() );
+  for ( const auto& [item, newpos] : moves )
   {
-    auto* cont = static_cast<Core::UContainer*>( item );
-    cont->for_each_item( Core::setrealm, (void*)realm() );
+    item->set_dirty();
+    oldpos.push_back( item->pos() );
   }
 
-  Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
-      item,
-      [&]( Mobile::Character* zonechr )
-      {
-        if ( !zonechr->in_visual_range( item ) )
-          return;
-        Network::Client* client = zonechr->client;
+  Core::MoveItemsWorldPosition( moves );
 
+  Core::Pos2d old_nw = oldpos.front().xy();
+  Core::Pos2d old_se = old_nw;
+  Core::Pos2d new_nw = moves.front().second.xy();
+  Core::Pos2d new_se = new_nw;
+  for ( size_t i = 0; i < moves.size(); ++i )
+  {
+    Items::Item* item = moves[i].first;
+    // TODO POS should be removed
+    if ( oldpos[i].realm() != item->realm() && item->isa( Core::UOBJ_CLASS::CLASS_CONTAINER ) )
+    {
+      auto* cont = static_cast<Core::UContainer*>( item );
+      cont->for_each_item( Core::setrealm, (void*)realm() );
+    }
+    old_nw = old_nw.min( oldpos[i].xy() );
+    old_se = old_se.max( oldpos[i].xy() );
+    new_nw = new_nw.min( item->pos2d() );
+    new_se = new_se.max( item->pos2d() );
+  }
+
+  auto update_viewer = [&]( Mobile::Character* zonechr )
+  {
+    Network::Client* client = zonechr->client;
+    for ( size_t i = 0; i < moves.size(); ++i )
+    {
+      Items::Item* item = moves[i].first;
+      if ( zonechr->in_visual_range( item ) )
+      {
         if ( !( client->ClientType & Network::CLIENTTYPE_7090 ) )
           send_item( client, item );
-      } );
+      }
+      // not in range.  If old loc was in range, send a delete.
+      else if ( zonechr->in_visual_range( item, oldpos[i] ) )
+        send_remove_object( client, item );
+    }
+  };
 
-  Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
-      oldpos,
-      [&]( Mobile::Character* zonechr )
-      {
-        if ( !zonechr->in_visual_range( item, oldpos ) )
-          return;
-        if ( !zonechr->in_visual_range(
-                 item ) )  // not in range.  If old loc was in range, send a delete.
-          send_remove_object( zonechr->client, item );
-      } );
+  const Core::Vec2d range( Core::gamestate.max_update_range, Core::gamestate.max_update_range );
+  const Realms::Realm* oldrealm = oldpos.front().realm();
+  if ( oldrealm == realm() )
+  {
+    Core::WorldIterator<Core::OnlinePlayerFilter>::InBox(
+        Core::Range2d( old_nw.min( new_nw ) - range, old_se.max( new_se ) + range, realm() ),
+        realm(), update_viewer );
+  }
+  else
+  {
+    Core::WorldIterator<Core::OnlinePlayerFilter>::InBox(
+        Core::Range2d( new_nw - range, new_se + range, realm() ), realm(), update_viewer );
+    Core::WorldIterator<Core::OnlinePlayerFilter>::InBox(
+        Core::Range2d( old_nw - range, old_se + range, oldrealm ), oldrealm, update_viewer );
+  }
 }
 
 void UBoat::move_boat_mobile( Mobile::Character* chr, const Core::Pos4d& newpos )
@@ -871,9 +913,12 @@ u8 UBoat::turn_facing( u8 oldfacing, RELATIVE_DIR dir ) const
   return ( ( dir * 2 ) + oldfacing ) & 7;
 }
 
-void UBoat::turn_travellers( RELATIVE_DIR dir, const BoatContext& oldlocation )
+void UBoat::turn_travellers( RELATIVE_DIR dir, const BoatContext& oldlocation,
+                             const BoatShape& old_boatshape )
 {
   bool any_orphans = false;
+  ItemMoves item_moves;
+  MobileMoves mobile_moves;
 
   for ( auto& travellerRef : travellers_ )
   {
@@ -893,17 +938,22 @@ void UBoat::turn_travellers( RELATIVE_DIR dir, const BoatContext& oldlocation )
     {
       Mobile::Character* chr = static_cast<Mobile::Character*>( obj );
       chr->setfacing( turn_facing( chr->facing, dir ) );
-      move_boat_mobile( chr, newpos );
+      mobile_moves.emplace_back( chr, newpos );
     }
     else
     {
       Items::Item* item = static_cast<Items::Item*>( obj );
 
-      move_boat_item( item, newpos );
+      item_moves.emplace_back( item, newpos );
       if ( Core::settingsManager.ssopt.refresh_decay_after_boat_moves )
         item->restart_decay_timer();
     }
   }
+  transform_components( old_boatshape, item_moves );
+
+  move_boat_items( item_moves );
+  for ( const auto& [chr, newpos] : mobile_moves )
+    move_boat_mobile( chr, newpos );
 
   if ( any_orphans )
     remove_orphans();
@@ -1049,7 +1099,6 @@ bool UBoat::move_to( const Core::Pos4d& newpos, int flags )
     move_multi_in_world( this, bc.oldpos );
 
     move_travellers( bc );
-    move_components();
     send_display_boat_to_inrange( bc.oldpos );
     do_tellmoves();
     unpause_paused();
@@ -1082,7 +1131,6 @@ bool UBoat::move( Core::UFACING dir, u8 speed, bool relative )
   setposition( newpos );
   move_multi_in_world( this, bc.oldpos );
   move_travellers( bc );
-  move_components();
 
   Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
       this,
@@ -1145,7 +1193,7 @@ const BoatShape& UBoat::boatshape() const
 }
 
 
-void UBoat::transform_components( const BoatShape& old_boatshape )
+void UBoat::transform_components( const BoatShape& old_boatshape, ItemMoves& item_moves )
 {
   const BoatShape& bshape = boatshape();
   auto end = Components.end();
@@ -1186,12 +1234,12 @@ void UBoat::transform_components( const BoatShape& old_boatshape )
       else
         item->graphic = itr2->graphic;
 
-      move_boat_item( item, pos() + itr2->delta );
+      item_moves.emplace_back( item, pos() + itr2->delta );
     }
   }
 }
 
-void UBoat::move_components()
+void UBoat::move_components( ItemMoves& item_moves )
 {
   const BoatShape& bshape = boatshape();
   auto itr = Components.begin();
@@ -1221,7 +1269,7 @@ void UBoat::move_components()
             item->serial, item->graphic, containerSerial );
         continue;
       }
-      move_boat_item( item, pos() + itr2->delta );
+      item_moves.emplace_back( item, pos() + itr2->delta );
     }
   }
 }
@@ -1240,8 +1288,7 @@ bool UBoat::turn( RELATIVE_DIR dir )
   set_dirty();
   multiid_ = multiid_ifturn( dir );
 
-  turn_travellers( dir, bc );
-  transform_components( old_boatshape );
+  turn_travellers( dir, bc, old_boatshape );
   send_display_boat_to_inrange( {} );
   do_tellmoves();
   unpause_paused();
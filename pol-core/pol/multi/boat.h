@@ -14,6 +14,7 @@
 #include <optional>
 #include <stddef.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/position.h"
@@ -104,6 +105,9 @@ class UBoat final : public UMulti
     friend class UBoat;
     BoatContext& operator=( const BoatContext& ) { return *this; }
   };
+  // objects of one boat movement with their new position
+  typedef std::vector<std::pair<Items::Item*, Core::Pos4d>> ItemMoves;
+  typedef std::vector<std::pair<Mobile::Character*, Core::Pos4d>> MobileMoves;
 
 public:
   struct BoatMoveGuard
@@ -185,7 +189,8 @@ public:
 protected:
   Core::ItemRef mountpiece;
   void move_travellers( const BoatContext& oldlocation );
-  void turn_travellers( RELATIVE_DIR dir, const BoatContext& oldlocation );
+  void turn_travellers( RELATIVE_DIR dir, const BoatContext& oldlocation,
+                        const BoatShape& old_boatshape );
   static bool on_ship( const BoatContext& bc, const Core::UObject* obj );
   void move_offline_mobiles( const Core::Pos4d& newpos );
   const MultiDef& multi_ifturn( RELATIVE_DIR dir );
@@ -196,8 +201,9 @@ protected:
   const BoatShape& boatshape() const;
   void rescan_components();
   void reread_components();
-  void transform_components( const BoatShape& old_boatshape );
-  void move_components();
+  // components are collected into item_moves and relocated together with the deck
+  void transform_components( const BoatShape& old_boatshape, ItemMoves& item_moves );
+  void move_components( ItemMoves& item_moves );
 
   explicit UBoat( const Items::ItemDesc& descriptor );
   virtual void fixInvalidGraphic() override;
@@ -223,7 +229,7 @@ private:
   Core::Pos4d turn_coords( const Core::Pos4d& oldpos, RELATIVE_DIR dir ) const;
   u8 turn_facing( u8 oldfacing, RELATIVE_DIR dir ) const;
   void create_components();
-  void move_boat_item( Items::Item* item, const Core::Pos4d& newpos );
+  void move_boat_items( const ItemMoves& moves );
   void move_boat_mobile( Mobile::Character* chr, const Core::Pos4d& newpos );
   typedef Core::UObjectRef Traveller;
   typedef std::vector<Traveller> Travellers;
@@ -21,6 +21,7 @@
 
 #include "customhouses.h"
 
+#include <chrono>
 #include <cstddef>
 #include <stdlib.h>
 #include <string.h>
@@ -287,18 +288,11 @@ void CustomHouseDesign::Clear()
   }
 }
 
-// caller must delete, assume type 0
-unsigned char* CustomHouseDesign::Compress( int floor, u32* uncompr_length, u32* compr_length )
+// assume type 0
+void CustomHouseDesign::SerializePlane( int floor, std::vector<u8>& buffer ) const
 {
   int numtiles = floor_sizes[floor];
-  int nextindex = 0;
-  unsigned int ubuflen = numtiles * BYTES_PER_TILE;
-  unsigned long cbuflen =
-      ( ( (unsigned long)( ( (float)( ubuflen ) ) * 1.001f ) ) + 12 );  // as per zlib spec
-  unsigned char* uncompressed = new unsigned char[ubuflen];
-  memset( uncompressed, 0, ubuflen );
-  unsigned char* compressed = new unsigned char[cbuflen];
-  memset( compressed, 0, cbuflen );
+  buffer.reserve( buffer.size() + numtiles * BYTES_PER_TILE );
 
   int i = 0;
   for ( HouseFloor::const_iterator xitr = Elements[floor].data.begin(),
@@ -317,33 +311,16 @@ unsigned char* CustomHouseDesign::Compress( int floor, u32* uncompr_length, u32*
         // to make that work (but they compress very well)
         if ( i < numtiles )
         {
-          uncompressed[nextindex++] = (u8)( ( zitr->graphic >> 8 ) & 0xFF );
-          uncompressed[nextindex++] = (u8)( zitr->graphic & 0xFF );
+          buffer.push_back( (u8)( ( zitr->graphic >> 8 ) & 0xFF ) );
+          buffer.push_back( (u8)( zitr->graphic & 0xFF ) );
 
-          uncompressed[nextindex++] = (u8)zitr->xoffset;
-          uncompressed[nextindex++] = (u8)zitr->yoffset;
-          uncompressed[nextindex++] = (u8)zitr->z;
+          buffer.push_back( (u8)zitr->xoffset );
+          buffer.push_back( (u8)zitr->yoffset );
+          buffer.push_back( (u8)zitr->z );
         }
       }
     }
   }
-  *uncompr_length = nextindex;
-
-  int ret = compress2( compressed, &cbuflen, uncompressed, nextindex, Z_DEFAULT_COMPRESSION );
-  if ( ret == Z_OK )
-  {
-    delete[] uncompressed;
-    *compr_length = cbuflen;
-    return compressed;
-  }
-  else
-  {
-    *uncompr_length = 0;
-    *compr_length = 0;
-    delete[] compressed;
-    delete[] uncompressed;
-    return nullptr;
-  }
 }
 
 bool CustomHouseDesign::IsEmpty() const
@@ -1015,103 +992,161 @@ void CustomHousesRoofRemove( Core::PKTBI_D7* msg )
   house->revision++;
 }
 
-void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
+namespace
 {
-  u32 clen;
-  u32 ulen;
-  unsigned char* data;
-  // unsigned char** stored_packet;
-  std::vector<u8>* stored_packet;
+// uncompressed planes of a design, copied so that compression needs no access to the house
+struct DesignPlanes
+{
+  u32 serial_ext;
+  u32 revision;
+  u16 numtiles;
+  std::vector<std::vector<u8>> planes;
+};
 
-  u32 planeheader = 0;
-  u32 buffer_len = 0;
-  CustomHouseDesign* pdesign;
+DesignPlanes snapshot_design( const UHouse* house, const CustomHouseDesign& design )
+{
+  DesignPlanes snapshot;
+  snapshot.serial_ext = house->serial_ext;
+  snapshot.revision = house->revision;
+  snapshot.numtiles = static_cast<u16>( design.TotalSize() );
+  snapshot.planes.resize( design.NumUsedPlanes() );
+  for ( size_t i = 0; i < snapshot.planes.size(); ++i )
+    design.SerializePlane( static_cast<int>( i ), snapshot.planes[i] );
+  return snapshot;
+}
+
+// builds the compressed 0xD8 packet, compressing every plane directly into the packet buffer
+bool build_design_packet( const DesignPlanes& design, std::vector<u8>& packet )
+{
   const unsigned int data_offset = 17;
   const u32 mode = 0;  // we only know how to do mode 0 at this point.
 
-  // choose between sending working or current designs
-  switch ( design )
-  {
-  case HOUSE_DESIGN_CURRENT:
-    if ( house->CurrentCompressed.empty() )  // no design stored, create below
-    {
-      pdesign = &house->CurrentDesign;
-      stored_packet = &house->CurrentCompressed;
-    }
-    else  // send stored packet
-    {
-      Core::networkManager.clientTransmit->AddToQueue(
-          client, &house->CurrentCompressed[0],
-          ctBEu16( *( reinterpret_cast<u16*>( &house->CurrentCompressed[1] ) ) ) );
-      return;
-    }
-    break;
-  case HOUSE_DESIGN_WORKING:
-    if ( house->WorkingCompressed.empty() )  // no design stored, create below
-    {
-      pdesign = &house->WorkingDesign;
-      stored_packet = &house->WorkingCompressed;
-    }
-    else  // send stored packet
-    {
-      Core::networkManager.clientTransmit->AddToQueue(
-          client, &house->WorkingCompressed[0],
-          ctBEu16( *( reinterpret_cast<u16*>( &house->WorkingCompressed[1] ) ) ) );
-      return;
-    }
-    break;
-  default:
-    return;
-  }
-
-  // create compressed house message
-
-  unsigned char planes = pdesign->NumUsedPlanes();
-  unsigned long sbuflen =
-      ( (unsigned long)( ( (float)( pdesign->TotalSize() * BYTES_PER_TILE ) ) * 1.001f ) + 12 );
-  sbuflen += planes * BYTES_PER_TILE;  // for plane header dword
-  sbuflen += 17;                       // for packet header
-
-  std::vector<u8> packet( sbuflen );
-
+  size_t sbuflen = data_offset + 1;
+  for ( const auto& plane : design.planes )
+    sbuflen += 4 + compressBound( static_cast<uLong>( plane.size() ) );
+  packet.assign( sbuflen, 0 );
 
   Core::PKTOUT_D8* msg = reinterpret_cast<Core::PKTOUT_D8*>( &packet[0] );
   msg->msgtype = Core::PKTOUT_D8_ID;
   msg->compressiontype = 0x3;
   msg->unk = 0;
-  msg->serial = house->serial_ext;
-  msg->revision = ctBEu32( house->revision );
-  msg->numtiles = ctBEu16( static_cast<u16>( pdesign->TotalSize() ) );
+  msg->serial = design.serial_ext;
+  msg->revision = ctBEu32( design.revision );
+  msg->numtiles = ctBEu16( design.numtiles );
+  msg->buffer->planecount = static_cast<u8>( design.planes.size() );
 
-  msg->buffer->planecount = planes;
-  buffer_len = 1;
-  for ( int i = 0; i < planes; i++ )
+  u32 buffer_len = 1;
+  for ( size_t i = 0; i < design.planes.size(); ++i )
   {
-    planeheader = 0;
-    data = pdesign->Compress( i, &ulen, &clen );
-    if ( data == nullptr )  // compression error
-    {
-      return;
-    }
+    const auto& plane = design.planes[i];
+    u32 ulen = static_cast<u32>( plane.size() );
+    uLongf clen = static_cast<uLongf>( sbuflen - ( data_offset + buffer_len + 4 ) );
+    if ( compress2( &packet[data_offset + buffer_len + 4], &clen, plane.data(), ulen,
+                    Z_DEFAULT_COMPRESSION ) != Z_OK )
+      return false;
     if ( ulen == 0 )
       clen = 0;
+    u32 planeheader = 0;
     planeheader |= ( ( mode << 4 ) << 24 );
     planeheader |= ( ( i & 0xF ) << 24 );
     planeheader |= ( ( ulen & 0xFF ) << 16 );
     planeheader |= ( ( clen & 0xFF ) << 8 );
     planeheader |= ( ( ( ulen >> 4 ) & 0xF0 ) | ( ( clen >> 8 ) & 0xF ) );
-    u32* p_planeheader = reinterpret_cast<u32*>( &( packet[buffer_len + data_offset] ) );
-    *p_planeheader = ctBEu32( planeheader );
-    buffer_len += 4;
-    memcpy( &( packet[buffer_len + data_offset] ), data, clen );
-    buffer_len += clen;
-    delete[] data;
+    u32 be_planeheader = ctBEu32( planeheader );
+    memcpy( &packet[data_offset + buffer_len], &be_planeheader, sizeof( be_planeheader ) );
+    buffer_len += 4 + static_cast<u32>( clen );
   }
   msg->msglen = ctBEu16( static_cast<u16>( buffer_len ) + data_offset );
   msg->planebuffer_len = ctBEu16( static_cast<u16>( buffer_len ) );
+  packet.resize( buffer_len + data_offset );
+  return true;
+}
 
-  Core::networkManager.clientTransmit->AddToQueue( client, &packet[0], cfBEu16( msg->msglen ) );
-  stored_packet->swap( packet );
+// moves a finished background packet of the current revision into CurrentCompressed.
+// Waiting for a worker which is not done would block under the PolLock, such a packet is dropped
+// and the caller builds it itself.
+void take_pending_packet( UHouse* house )
+{
+  auto pending = std::move( house->PendingCompressed );
+  if ( !pending )
+    return;
+  if ( pending->done.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+    return;
+  try
+  {
+    pending->done.get();
+  }
+  catch ( std::exception& ex )
+  {
+    POLLOG_ERRORLN( "Failed to compress design of house {:#x}: {}", house->serial, ex.what() );
+    return;
+  }
+  if ( pending->revision == house->revision && !pending->packet->empty() )
+    house->CurrentCompressed.swap( *pending->packet );
+}
+}  // namespace
+
+void CustomHousesQueueCompress( UHouse* house )
+{
+  house->PendingCompressed.reset();
+  // without workers the packet is built on the first request
+  if ( Core::gamestate.task_thread_pool.size() == 0 )
+    return;
+
+  auto planes =
+      std::make_shared<const DesignPlanes>( snapshot_design( house, house->CurrentDesign ) );
+  auto packet = std::make_shared<std::vector<u8>>();
+  auto pending = std::make_unique<CustomHousePendingPacket>();
+  pending->revision = house->revision;
+  pending->packet = packet;
+  pending->done = Core::gamestate.task_thread_pool.checked_push(
+      [planes, packet]()
+      {
+        if ( !build_design_packet( *planes, *packet ) )
+          packet->clear();
+      } );
+  house->PendingCompressed = std::move( pending );
+}
+
+void UHouse::ClearCurrentCompressed()
+{
+  std::vector<u8> newvec;
+  CurrentCompressed.swap( newvec );
+  PendingCompressed.reset();
+}
+
+void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
+{
+  CustomHouseDesign* pdesign;
+  std::vector<u8>* stored_packet;
+
+  // choose between sending working or current designs
+  switch ( design )
+  {
+  case HOUSE_DESIGN_CURRENT:
+    if ( house->CurrentCompressed.empty() )
+      take_pending_packet( house );
+    pdesign = &house->CurrentDesign;
+    stored_packet = &house->CurrentCompressed;
+    break;
+  case HOUSE_DESIGN_WORKING:
+    pdesign = &house->WorkingDesign;
+    stored_packet = &house->WorkingCompressed;
+    break;
+  default:
+    return;
+  }
+
+  if ( stored_packet->empty() )  // no design stored, create it
+  {
+    if ( !build_design_packet( snapshot_design( house, *pdesign ), *stored_packet ) )
+    {
+      stored_packet->clear();  // compression error
+      return;
+    }
+  }
+  Core::networkManager.clientTransmit->AddToQueue( client, stored_packet->data(),
+                                                   static_cast<int>( stored_packet->size() ) );
 }
 
 void CustomHousesSendFullToInRange( UHouse* house, int design )
@@ -1135,6 +1170,22 @@ void CustomHousesSendShort( UHouse* house, Network::Client* client )
   msg.Send( client );
 }
 
+void CustomHousesSendShortToInRange( UHouse* house )
+{
+  Network::PktHelper::PacketOut<Network::PktOut_BF_Sub1D> msg;
+  msg->WriteFlipped<u16>( 13u );
+  msg->offset += 2;
+  msg->Write<u32>( house->serial_ext );
+  msg->WriteFlipped<u32>( house->revision );
+  Core::WorldIterator<Core::OnlinePlayerFilter>::InMaxVisualRange(
+      house,
+      [&]( Mobile::Character* chr )
+      {
+        if ( chr->in_visual_range( house ) )
+          msg.Send( chr->client );
+      } );
+}
+
 void UHouse::SetCustom( bool _custom )
 {
   if ( custom == false && _custom == true )
@@ -1164,8 +1215,7 @@ void UHouse::CustomHouseSetInitialState()
   std::vector<u8> newvec;
   WorkingCompressed.swap( newvec );
 
-  std::vector<u8> newvec2;
-  CurrentCompressed.swap( newvec2 );
+  ClearCurrentCompressed();
 }
 
 void UHouse::CustomHousesQuit( Mobile::Character* chr, bool drop_changes, bool send_pkts )
@@ -1183,8 +1233,7 @@ void UHouse::CustomHousesQuit( Mobile::Character* chr, bool drop_changes, bool s
   std::vector<u8> newvec;
   WorkingCompressed.swap( newvec );
 
-  std::vector<u8> newvec2;
-  CurrentCompressed.swap( newvec2 );
+  ClearCurrentCompressed();
   if ( chr )
   {
     CustomHouseStopEditing( chr, this, itemlist, send_pkts );
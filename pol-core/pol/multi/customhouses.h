@@ -9,8 +9,10 @@
 #define _CUSTOMHOUSES_H
 
 #include <cstddef>  // for size_t
-#include <iosfwd>   // for testprint()
+#include <future>
+#include <iosfwd>  // for testprint()
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -122,7 +124,8 @@ public:
   void Clear();
   bool IsEmpty() const;
 
-  unsigned char* Compress( int floor, u32* uncompr_length, u32* compr_length );
+  // appends the tiles of the plane as uncompressed mode 0 data
+  void SerializePlane( int floor, std::vector<u8>& buffer ) const;
 
   unsigned int TotalSize() const;
   unsigned char NumUsedPlanes() const;
@@ -157,6 +160,15 @@ private:
   static char z_to_custom_house_table( char z );
 };
 
+// Current design packet which is compressed by a worker thread after a commit.
+// Only valid as long as the house revision did not change.
+struct CustomHousePendingPacket
+{
+  u32 revision;
+  std::shared_ptr<std::vector<u8>> packet;
+  std::future<bool> done;
+};
+
 // House Tool Command Implementations:
 void CustomHousesAdd( Core::PKTBI_D7* msg );
 void CustomHousesAddMulti( Core::PKTBI_D7* msg );
@@ -175,6 +187,8 @@ void CustomHousesSendFull( UHouse* house, Network::Client* client,
                            int design = HOUSE_DESIGN_CURRENT );
 void CustomHousesSendFullToInRange( UHouse* house, int design );
 void CustomHousesSendShort( UHouse* house, Network::Client* client );
+void CustomHousesSendShortToInRange( UHouse* house );
+void CustomHousesQueueCompress( UHouse* house );
 void CustomHouseStopEditing( Mobile::Character* chr, UHouse* house, ItemList& itemlist,
                              bool send_pkts = true );
 }  // namespace Multi
@@ -122,7 +122,7 @@ size_t UHouse::estimatedSize() const
   size_t size = base::estimatedSize() + CurrentDesign.estimatedSize() +
                 WorkingDesign.estimatedSize() + BackupDesign.estimatedSize() +
                 Clib::memsize( CurrentCompressed ) + Clib::memsize( WorkingCompressed ) +
-                sizeof( bool )   /*editing*/
+                sizeof( PendingCompressed ) + sizeof( bool ) /*editing*/
                 + sizeof( bool ) /*waiting_for_accept*/
                 + sizeof( int )  /*editing_floor_num*/
                 + sizeof( u32 )  /*revision*/
@@ -402,8 +402,7 @@ Bscript::BObjectImp* UHouse::script_method_id( const int id, Core::UOExecutor& e
       WorkingDesign = CurrentDesign;
       std::vector<u8> newvec;
       WorkingCompressed.swap( newvec );
-      std::vector<u8> newvec2;
-      CurrentCompressed.swap( newvec2 );
+      ClearCurrentCompressed();
       revision++;
       CustomHousesSendFullToInRange( this, HOUSE_DESIGN_CURRENT );
       return new BLong( 1 );
@@ -431,8 +430,7 @@ Bscript::BObjectImp* UHouse::script_method_id( const int id, Core::UOExecutor& e
         WorkingDesign = CurrentDesign;
         std::vector<u8> newvec;
         WorkingCompressed.swap( newvec );
-        std::vector<u8> newvec2;
-        CurrentCompressed.swap( newvec2 );
+        ClearCurrentCompressed();
         CustomHousesSendFullToInRange( this, HOUSE_DESIGN_CURRENT );
       }
       return new BLong( ret ? 1 : 0 );
@@ -1118,13 +1116,14 @@ void UHouse::AcceptHouseCommit( Mobile::Character* chr, bool accept )
     CurrentDesign = WorkingDesign;
 
     // invalidate old packet
-    std::vector<u8> newvec;
-    CurrentCompressed.swap( newvec );
+    ClearCurrentCompressed();
 
     CustomHouseStopEditing( chr, this, itemlist );
 
-    // send full house
-    CustomHousesSendFullToInRange( this, HOUSE_DESIGN_CURRENT );
+    // compress the new design in the background, clients in range request it after they got
+    // the new revision
+    CustomHousesQueueCompress( this );
+    CustomHousesSendShortToInRange( this );
   }
   else
   {
@@ -86,6 +86,8 @@ public:
   CustomHouseDesign BackupDesign;
   std::vector<u8> CurrentCompressed;
   std::vector<u8> WorkingCompressed;
+  std::unique_ptr<CustomHousePendingPacket> PendingCompressed;
+  void ClearCurrentCompressed();
 
   bool IsCustom() const { return custom; };
   void SetCustom( bool custom );
@@ -9,8 +9,11 @@
 
 #include "auxclient.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iosfwd>
+#include <sstream>
+#include <thread>
 
 #include "../../bscript/berror.h"
 #include "../../bscript/bobject.h"
@@ -22,6 +25,7 @@
 #include "../../clib/esignal.h"
 #include "../../clib/logfacility.h"
 #include "../../clib/network/sckutil.h"
+#include "../../clib/network/singlepollers/pollingwithpoll.h"
 #include "../../clib/network/socketsvc.h"
 #include "../../clib/network/wnsckt.h"
 #include "../../clib/stlutil.h"
@@ -33,11 +37,25 @@
 #include "../scrdef.h"
 #include "../scrsched.h"
 #include "../uoexec.h"
+#include "sockio.h"
 
 namespace Pol
 {
 namespace Network
 {
+namespace
+{
+// limits of the SharedIO mode
+const size_t AUX_MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+const int AUX_POLL_INTERVAL_MS = 50;
+
+bool aux_would_block()
+{
+  int err = socket_errno;
+  return err == SOCKET_ERRNO( EWOULDBLOCK ) || err == SOCKET_ERRNO( EINTR );
+}
+}  // namespace
+
 Bscript::BObjectImp* AuxConnection::copy() const
 {
   return const_cast<AuxConnection*>( this );
@@ -55,7 +73,7 @@ size_t AuxConnection::sizeEstimate() const
 
 bool AuxConnection::isTrue() const
 {
-  return ( _auxclientthread != nullptr );
+  return ( _transmitter != nullptr );
 }
 
 Bscript::BObjectRef AuxConnection::get_member( const char* membername )
@@ -73,10 +91,11 @@ Bscript::BObjectImp* AuxConnection::call_polmethod( const char* methodname, Core
   {
     if ( ex.numParams() == 1 )
     {
-      if ( _auxclientthread != nullptr )
+      if ( _transmitter != nullptr )
       {
         Bscript::BObjectImp* value = ex.getParamImp( 0 );
-        _auxclientthread->transmit( value );
+        if ( Bscript::BObjectImp* error = _transmitter->transmit( value ) )
+          return error;
       }
       else
       {
@@ -93,7 +112,7 @@ Bscript::BObjectImp* AuxConnection::call_polmethod( const char* methodname, Core
 
 void AuxConnection::disconnect()
 {
-  _auxclientthread = nullptr;
+  _transmitter = nullptr;
 }
 
 AuxClientThread::AuxClientThread( AuxService* auxsvc, Clib::Socket&& sock )
@@ -131,7 +150,7 @@ bool AuxClientThread::init()
 {
   Core::PolLock lock;
   struct sockaddr ConnectingIP = _sck.peer_address();
-  if ( ipAllowed( ConnectingIP ) )
+  if ( !_auxservice || _auxservice->ip_allowed( ConnectingIP ) )
   {
     _auxconnection.set( new AuxConnection( this, _sck.getpeername() ) );
     Module::UOExecutorModule* uoemod;
@@ -155,28 +174,6 @@ bool AuxClientThread::init()
   }
 }
 
-bool AuxClientThread::ipAllowed( sockaddr MyPeer )
-{
-  if ( !_auxservice || _auxservice->_aux_ip_match.empty() )
-  {
-    return true;
-  }
-  for ( unsigned j = 0; j < _auxservice->_aux_ip_match.size(); ++j )
-  {
-    unsigned int addr1part, addr2part;
-    struct sockaddr_in* sockin = reinterpret_cast<struct sockaddr_in*>( &MyPeer );
-
-    addr1part = _auxservice->_aux_ip_match[j] & _auxservice->_aux_ip_match_mask[j];
-#ifdef _WIN32
-    addr2part = sockin->sin_addr.S_un.S_addr & _auxservice->_aux_ip_match_mask[j];
-#else
-    addr2part = sockin->sin_addr.s_addr & _auxservice->_aux_ip_match_mask[j];
-#endif
-    if ( addr1part == addr2part )
-      return true;
-  }
-  return false;
-}
 void AuxClientThread::run()
 {
   if ( !init() )
@@ -253,12 +250,19 @@ void AuxClientThread::run()
   _auxconnection.clear();
 }
 
-void AuxClientThread::transmit( const Bscript::BObjectImp* value )
+Bscript::BObjectImp* AuxClientThread::transmit( const Bscript::BObjectImp* value )
 {
   // defer transmit to not block server
-  std::string tmp = _uoexec->auxsvc_assume_string ? value->getStringRep() : value->pack();
+  std::string tmp;
+  if ( _uoexec->auxsvc_assume_string )
+    tmp = value->getStringRep();
+  else if ( _auxservice != nullptr )
+    tmp = Bscript::pack( *value, _auxservice->pack_format() );
+  else
+    tmp = value->pack();
   ++_transmit_counter;
   Core::networkManager.auxthreadpool->push( [tmp, this]() { transmit( tmp ); } );
+  return nullptr;
 }
 
 void AuxClientThread::transmit( const std::string& msg )
@@ -276,11 +280,231 @@ void AuxClientThread::transmit( const std::string& msg )
   --_transmit_counter;
 }
 
+AuxIOClient::AuxIOClient( AuxService* auxsvc, Clib::Socket&& sock )
+    : _auxservice( auxsvc ),
+      _sck( std::move( sock ) ),
+      _auxconnection(),
+      _uoexec( nullptr ),
+      _in(),
+      _received(),
+      _eof( false ),
+      _out_mutex(),
+      _out(),
+      _out_pos( 0 )
+{
+}
+
+bool AuxIOClient::init()
+{
+  if ( !_auxservice->ip_allowed( _sck.peer_address() ) )
+    return false;
+  _auxconnection.set( new AuxConnection( this, _sck.getpeername() ) );
+  Module::UOExecutorModule* uoemod =
+      Core::start_script( _auxservice->scriptdef(), _auxconnection.get() );
+  if ( uoemod == nullptr )
+    return false;
+  _uoexec = uoemod->uoexec().weakptr;
+  return true;
+}
+
+bool AuxIOClient::read()
+{
+  char buffer[16 * 1024];
+  // limited, so a single fast sender cannot starve the other connections
+  for ( int i = 0; i < 16; ++i )
+  {
+    int res = ::recv( _sck.handle(), buffer, sizeof buffer, 0 );
+    if ( res > 0 )
+    {
+      _in.append( buffer, res );
+      if ( static_cast<size_t>( res ) < sizeof buffer )
+        break;
+      continue;
+    }
+    // the messages received so far are still delivered before the connection is closed
+    if ( res == 0 || !aux_would_block() )
+      _eof = true;
+    break;
+  }
+  if ( !parse_messages() )
+    return false;
+  if ( _received.empty() )
+    return true;
+
+  Core::PolLock lock;
+  return deliver();
+}
+
+bool AuxIOClient::parse_messages()
+{
+  size_t pos = 0;
+  for ( ;; )
+  {
+    if ( _auxservice->length_framing() )
+    {
+      if ( _in.size() - pos < 4 )
+        break;
+      const auto* p = reinterpret_cast<const unsigned char*>( _in.data() + pos );
+      const size_t len = ( static_cast<size_t>( p[0] ) << 24 ) |
+                         ( static_cast<size_t>( p[1] ) << 16 ) |
+                         ( static_cast<size_t>( p[2] ) << 8 ) | p[3];
+      if ( len > AUX_MAX_MESSAGE_SIZE )
+        return false;
+      if ( _in.size() - pos - 4 < len )
+        break;
+      _received.emplace_back( _in, pos + 4, len );
+      pos += 4 + len;
+    }
+    else
+    {
+      const size_t end = _in.find( '\n', pos );
+      if ( end == std::string::npos )
+        break;
+      size_t len = end - pos;
+      if ( len > 0 && _in[end - 1] == '\r' )
+        --len;
+      _received.emplace_back( _in, pos, len );
+      pos = end + 1;
+    }
+  }
+  _in.erase( 0, pos );
+  return _in.size() <= AUX_MAX_MESSAGE_SIZE;
+}
+
+Bscript::BObjectImp* AuxIOClient::unpack( const std::string& msg ) const
+{
+  if ( _uoexec->auxsvc_assume_string )
+    return new Bscript::String( msg );
+  return Bscript::BObjectImp::unpack( msg.c_str() );
+}
+
+bool AuxIOClient::deliver()
+{
+  if ( !_uoexec.exists() )
+    return false;
+  while ( !_received.empty() && !_uoexec->event_queue_full() )
+  {
+    std::unique_ptr<Bscript::BStruct> event( new Bscript::BStruct );
+    if ( _auxservice->batch_events() )
+    {
+      // everything received so far as one event
+      std::unique_ptr<Bscript::ObjArray> values( new Bscript::ObjArray );
+      for ( const auto& msg : _received )
+        values->addElement( unpack( msg ) );
+      _received.clear();
+      event->addMember( "type", new Bscript::String( "recv_batch" ) );
+      event->addMember( "values", values.release() );
+    }
+    else
+    {
+      event->addMember( "type", new Bscript::String( "recv" ) );
+      event->addMember( "value", unpack( _received.front() ) );
+      _received.pop_front();
+    }
+    _uoexec->signal_event( event.release() );
+  }
+  return true;
+}
+
+bool AuxIOClient::send_pending() const
+{
+  std::lock_guard<std::mutex> lock( _out_mutex );
+  return _out_pos < _out.size();
+}
+
+bool AuxIOClient::flush()
+{
+  std::lock_guard<std::mutex> lock( _out_mutex );
+  return flush_locked();
+}
+
+bool AuxIOClient::flush_locked()
+{
+  while ( _out_pos < _out.size() )
+  {
+    int res = ::send( _sck.handle(), _out.data() + _out_pos,
+                      static_cast<int>( _out.size() - _out_pos ), 0 );
+    if ( res < 0 )
+      return aux_would_block();
+    _out_pos += res;
+  }
+  _out.clear();
+  _out_pos = 0;
+  return true;
+}
+
+void AuxIOClient::close( bool notify_script )
+{
+  if ( notify_script && _uoexec.exists() )
+    _uoexec->signal_event( new Bscript::BError( "connection closed" ) );
+  {
+    std::lock_guard<std::mutex> lock( _out_mutex );
+    _sck.close();
+  }
+  if ( _auxconnection.get() != nullptr )
+  {
+    _auxconnection->disconnect();
+    _auxconnection.clear();
+  }
+}
+
+Bscript::BObjectImp* AuxIOClient::transmit( const Bscript::BObjectImp* value )
+{
+  const bool assume_string = _uoexec.exists() && _uoexec->auxsvc_assume_string;
+  std::string msg = assume_string ? value->getStringRep()
+                                  : Bscript::pack( *value, _auxservice->pack_format() );
+
+  std::lock_guard<std::mutex> lock( _out_mutex );
+  // backpressure: the script has to slow down if the peer does not keep up
+  if ( _out.size() - _out_pos + msg.size() + 4 > _auxservice->max_send_buffer() )
+    return new Bscript::BError( "Send buffer is full" );
+  if ( _out_pos > 0 )
+  {
+    _out.erase( 0, _out_pos );
+    _out_pos = 0;
+  }
+  if ( _auxservice->length_framing() )
+  {
+    const auto len = static_cast<u32>( msg.size() );
+    const char prefix[4] = { static_cast<char>( len >> 24 ), static_cast<char>( len >> 16 ),
+                             static_cast<char>( len >> 8 ), static_cast<char>( len ) };
+    _out.append( prefix, sizeof prefix );
+    _out += msg;
+  }
+  else
+  {
+    _out += msg;
+    _out += "\r\n";
+  }
+  // send right away without blocking, the rest is sent by the service thread
+  flush_locked();
+  return nullptr;
+}
+
 AuxService::AuxService( const Plib::Package* pkg, Clib::ConfigElem& elem )
     : _pkg( pkg ),
       _scriptdef( elem.remove_string( "SCRIPT" ), _pkg ),
-      _port( elem.remove_ushort( "PORT" ) )
+      _port( elem.remove_ushort( "PORT" ) ),
+      _shared_io( elem.remove_bool( "SHAREDIO", false ) ),
+      _length_framing( false ),
+      _batch_events( elem.remove_bool( "BATCHEVENTS", false ) ),
+      _max_send_buffer( elem.remove_unsigned( "MAXSENDBUFFER", 1024 * 1024 ) ),
+      _pack_format( Bscript::PackFormat::TEXT )
 {
+  std::string pack_format = elem.remove_string( "PACKFORMAT", "text" );
+  if ( stricmp( pack_format.c_str(), "binary" ) == 0 )
+    _pack_format = Bscript::PackFormat::BINARY;
+  else if ( stricmp( pack_format.c_str(), "text" ) != 0 )
+    elem.throw_error( "PackFormat must be 'text' or 'binary'" );
+  std::string framing = elem.remove_string( "FRAMING", "line" );
+  if ( stricmp( framing.c_str(), "length" ) == 0 )
+    _length_framing = true;
+  else if ( stricmp( framing.c_str(), "line" ) != 0 )
+    elem.throw_error( "Framing must be 'line' or 'length'" );
+  // framing and batching are only supported by the shared io mode
+  if ( _length_framing || _batch_events )
+    _shared_io = true;
+
   std::string iptext;
   while ( elem.remove_prop( "IPMATCH", &iptext ) )
   {
@@ -303,11 +527,37 @@ AuxService::AuxService( const Plib::Package* pkg, Clib::ConfigElem& elem )
   }
 }
 
+bool AuxService::ip_allowed( sockaddr peer ) const
+{
+  if ( _aux_ip_match.empty() )
+    return true;
+  for ( unsigned j = 0; j < _aux_ip_match.size(); ++j )
+  {
+    unsigned int addr1part, addr2part;
+    struct sockaddr_in* sockin = reinterpret_cast<struct sockaddr_in*>( &peer );
+
+    addr1part = _aux_ip_match[j] & _aux_ip_match_mask[j];
+#ifdef _WIN32
+    addr2part = sockin->sin_addr.S_un.S_addr & _aux_ip_match_mask[j];
+#else
+    addr2part = sockin->sin_addr.s_addr & _aux_ip_match_mask[j];
+#endif
+    if ( addr1part == addr2part )
+      return true;
+  }
+  return false;
+}
+
 void AuxService::run()
 {
   INFO_PRINTLN( "Starting Aux Listener ({}, port {})", _scriptdef.relativename(), _port );
 
   Clib::SocketListener listener( _port );
+  if ( _shared_io )
+  {
+    run_shared_io( listener );
+    return;
+  }
   while ( !Clib::exit_signalled )
   {
     Clib::Socket sock;
@@ -325,6 +575,114 @@ void AuxService::run()
   }
 }
 
+// SharedIO mode: all connections of the service are served non-blocking from this thread instead
+// of a thread per connection
+void AuxService::run_shared_io( Clib::SocketListener& listener )
+{
+  std::vector<std::unique_ptr<AuxIOClient>> conns;
+  std::vector<pollfd> fds;
+  // index into conns of every entry in fds
+  std::vector<size_t> polled;
+  auto last_check = std::chrono::steady_clock::now();
+  auto remove_closed = [&]()
+  { conns.erase( std::remove( conns.begin(), conns.end(), nullptr ), conns.end() ); };
+
+  while ( !Clib::exit_signalled )
+  {
+    Clib::Socket sock;
+    // only block for new connections if there is nothing else to serve
+    if ( listener.GetConnection( &sock, conns.empty() ? 5000 : 0 ) && sock.connected() )
+    {
+      apply_socket_options( sock.handle() );
+      auto conn = std::make_unique<AuxIOClient>( this, std::move( sock ) );
+      Core::PolLock lock;
+      if ( conn->init() )
+        conns.push_back( std::move( conn ) );
+      else
+        conn->close( false );
+    }
+    if ( conns.empty() )
+      continue;
+
+    fds.clear();
+    polled.clear();
+    for ( size_t i = 0; i < conns.size(); ++i )
+    {
+      // a closed peer would report POLLHUP on every poll until its messages are delivered
+      if ( conns[i]->eof() )
+        continue;
+      short events = conns[i]->paused() ? 0 : POLLIN;
+      if ( conns[i]->send_pending() )
+        events |= POLLOUT;
+      fds.push_back( pollfd{ conns[i]->handle(), events, 0 } );
+      polled.push_back( i );
+    }
+    int res = 0;
+    if ( fds.empty() )
+      std::this_thread::sleep_for( std::chrono::milliseconds( AUX_POLL_INTERVAL_MS ) );
+    else
+      res = poll( fds.data(), static_cast<decltype( fds.size() )>( fds.size() ),
+                  AUX_POLL_INTERVAL_MS );
+    if ( res < 0 && socket_errno != SOCKET_ERRNO( EINTR ) )
+    {
+      ERROR_PRINTLN( "Aux Listener ({}) poll failed: {}", _scriptdef.relativename(),
+                     socket_errno );
+      break;
+    }
+
+    for ( size_t f = 0; res > 0 && f < fds.size(); ++f )
+    {
+      const short revents = fds[f].revents;
+      auto& conn = conns[polled[f]];
+      bool keep = true;
+      // after a hangup the rest of the data is read even if reading is paused, the messages
+      // already received are delivered before the connection is closed
+      if ( revents & ( POLLIN | POLLHUP ) )
+        keep = conn->read();
+      else if ( revents & ( POLLERR | POLLNVAL ) )
+        keep = false;
+      if ( keep && !conn->eof() && ( revents & POLLOUT ) )
+        keep = conn->flush();
+      if ( !keep || conn->finished() )
+      {
+        Core::PolLock lock;
+        conn->close( true );
+        conn.reset();
+      }
+    }
+    remove_closed();
+
+    // messages which did not fit into the event queue and connections dropped by their script
+    auto now = std::chrono::steady_clock::now();
+    bool any_paused = std::any_of( conns.begin(), conns.end(),
+                                   []( const auto& conn ) { return conn->paused(); } );
+    if ( any_paused || now - last_check >= std::chrono::seconds( 1 ) )
+    {
+      last_check = now;
+      Core::PolLock lock;
+      for ( auto& conn : conns )
+      {
+        if ( !conn->deliver() )
+        {
+          conn->flush();
+          conn->close( false );
+          conn.reset();
+        }
+        else if ( conn->finished() )
+        {
+          conn->close( true );
+          conn.reset();
+        }
+      }
+      remove_closed();
+    }
+  }
+
+  Core::PolLock lock;
+  for ( auto& conn : conns )
+    conn->close( false );
+}
+
 size_t AuxService::estimateSize() const
 {
   size_t size = sizeof( Plib::Package* ) + _scriptdef.estimatedSize() +
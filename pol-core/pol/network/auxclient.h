@@ -9,10 +9,12 @@
 #define AUXCLIENT_H_
 
 #include <atomic>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include "../../bscript/binpack.h"
 #include "../../bscript/bobject.h"
 #include "../../clib/network/socketsvc.h"
 #include "../../clib/refptr.h"
@@ -51,15 +53,20 @@ class ConfigElem;
 
 namespace Network
 {
-class AuxClientThread;
+// sending side of an aux connection, called by the script under the PolLock
+class AuxTransmitter
+{
+public:
+  virtual ~AuxTransmitter() = default;
+  // returns nullptr or an error for the script
+  virtual Bscript::BObjectImp* transmit( const Bscript::BObjectImp* value ) = 0;
+};
 
 class AuxConnection final : public Core::PolObjectImp
 {
 public:
-  AuxConnection( AuxClientThread* auxclientthread, std::string ip )
-      : PolObjectImp( Bscript::BObjectImp::OTUnknown ),
-        _auxclientthread( auxclientthread ),
-        _ip( ip )
+  AuxConnection( AuxTransmitter* transmitter, std::string ip )
+      : PolObjectImp( Bscript::BObjectImp::OTUnknown ), _transmitter( transmitter ), _ip( ip )
   {
   }
 
@@ -75,7 +82,7 @@ public:
   void disconnect();
 
 private:
-  AuxClientThread* _auxclientthread;
+  AuxTransmitter* _transmitter;
   std::string _ip;
 };
 
@@ -87,28 +94,40 @@ public:
   size_t estimateSize() const;
 
   const Core::ScriptDef& scriptdef() const { return _scriptdef; }
+  bool ip_allowed( sockaddr peer ) const;
+  bool length_framing() const { return _length_framing; }
+  bool batch_events() const { return _batch_events; }
+  size_t max_send_buffer() const { return _max_send_buffer; }
+  Bscript::PackFormat pack_format() const { return _pack_format; }
   std::vector<unsigned int> _aux_ip_match;
   std::vector<unsigned int> _aux_ip_match_mask;
 
 private:
+  void run_shared_io( Clib::SocketListener& listener );
+
   const Plib::Package* _pkg;
   Core::ScriptDef _scriptdef;
   unsigned short _port;
+  // SharedIO: all connections are served non-blocking by the listener thread
+  bool _shared_io;
+  bool _length_framing;
+  bool _batch_events;
+  size_t _max_send_buffer;
+  Bscript::PackFormat _pack_format;
 };
 
-class AuxClientThread final : public Clib::SocketClientThread
+class AuxClientThread final : public Clib::SocketClientThread, public AuxTransmitter
 {
 public:
   AuxClientThread( AuxService* auxsvc, Clib::Socket&& sock );
   AuxClientThread( Core::ScriptDef scriptdef, Clib::Socket&& sock, Bscript::BObjectImp* params,
                    bool assume_string, bool keep_alive, bool ignore_line_breaks );
   virtual void run() override;
-  void transmit( const Bscript::BObjectImp* imp );
+  virtual Bscript::BObjectImp* transmit( const Bscript::BObjectImp* imp ) override;
   Bscript::BObjectImp* get_ip();
 
 private:
   bool init();
-  bool ipAllowed( sockaddr MyPeer );
   void transmit( const std::string& msg );
   AuxService* _auxservice;
   ref_ptr<AuxConnection> _auxconnection;
@@ -121,6 +140,54 @@ private:
   bool _ignore_line_breaks;
   std::mutex _transmit_mutex;
 };
+
+// Connection of an AuxService with SharedIO. It has no thread of its own, reading and sending is
+// done non-blocking by the thread of the service. Messages are either separated by line breaks
+// or prefixed by their length (4 bytes, big endian).
+class AuxIOClient final : public AuxTransmitter
+{
+public:
+  AuxIOClient( AuxService* auxsvc, Clib::Socket&& sock );
+
+  // starts the script, needs the PolLock
+  bool init();
+  // reads what is available and delivers the complete messages, false on errors
+  bool read();
+  // delivers received messages as long as the event queue of the script has room, needs the
+  // PolLock. False if the script dropped the connection.
+  bool deliver();
+  // messages wait for room in the event queue, nothing is read meanwhile
+  bool paused() const { return !_received.empty(); }
+  // the peer is gone, the socket is no longer polled
+  bool eof() const { return _eof; }
+  // the peer is gone and every message it sent was delivered
+  bool finished() const { return _eof && _received.empty(); }
+  // sends as much of the buffered output as possible, false on errors
+  bool flush();
+  bool send_pending() const;
+  // closes the socket and disconnects the script, needs the PolLock
+  void close( bool notify_script );
+  SOCKET handle() const { return _sck.handle(); }
+
+  virtual Bscript::BObjectImp* transmit( const Bscript::BObjectImp* value ) override;
+
+private:
+  bool flush_locked();
+  bool parse_messages();
+  Bscript::BObjectImp* unpack( const std::string& msg ) const;
+
+  AuxService* _auxservice;
+  Clib::Socket _sck;
+  ref_ptr<AuxConnection> _auxconnection;
+  weak_ptr<Core::UOExecutor> _uoexec;
+  std::string _in;
+  std::deque<std::string> _received;
+  bool _eof;
+  // written by the script thread, sent by the service thread
+  mutable std::mutex _out_mutex;
+  std::string _out;
+  size_t _out_pos;
+};
 }  // namespace Network
 }  // namespace Pol
 
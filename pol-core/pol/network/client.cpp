@@ -18,6 +18,7 @@
 
 #include "client.h"
 
+#include <algorithm>
 #include <errno.h>
 #include <stdlib.h>
 #include <time.h>
@@ -30,9 +31,11 @@
 #include "../../clib/stlutil.h"
 #include "../../clib/strutil.h"  //CNXBUG
 #include "../../clib/wallclock.h"
+#include "../../plib/systemstate.h"
 #include "../accounts/account.h"
 #include "../crypt/cryptbase.h"
 #include "../crypt/cryptengine.h"
+#include "../fnsearch.h"
 #include "../globals/network.h"
 #include "../globals/settings.h"
 #include "../globals/state.h"
@@ -48,6 +51,7 @@
 #include "cliface.h"
 #include "packethelper.h"
 #include "packets.h"
+#include "pktboth.h"
 #include "pktdef.h"
 #include "pktin.h"
 #include "xbuffer.h"
@@ -74,6 +78,12 @@ namespace Network
 {
 unsigned int Client::instance_counter_;
 
+namespace
+{
+// size of the known mobiles set from which on mobiles out of range get dropped
+const size_t KNOWN_MOBILES_PRUNE_MIN = 64;
+}  // namespace
+
 ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient,
                                 sockaddr& client_addr,
                                 std::vector<boost::asio::ip::network_v4>& allowed_proxies )
@@ -102,7 +112,15 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient,
       first_xmit_buffer( nullptr ),
       last_xmit_buffer( nullptr ),
       n_queued( 0 ),
-      queued_bytes_counter( 0 )
+      queued_bytes_counter( 0 ),
+      held_packets(),
+      n_held(),
+      n_held_total( 0 ),
+      n_held_ahead( 0 ),
+      bandwidth_limit_( -1 ),
+      send_budget( 0 ),
+      send_budget_at( 0 ),
+      send_blocked_until( 0 )
 {
   memset( &counters, 0, sizeof counters );
   memcpy( &ipaddr, &client_addr, sizeof ipaddr );
@@ -146,7 +164,9 @@ Client::Client( ClientInterface& aInterface, Crypt::TCryptInfo& encryption, sock
       ClientType( 0 ),
       next_movement( 0 ),
       movementsequence( 0 ),
-      paused_( false )
+      paused_( false ),
+      known_mobiles_(),
+      known_mobiles_prune_at_( KNOWN_MOBILES_PRUNE_MIN )
 {
   weakptr.set( this );  // store weakptr for usage in scripts (see EClientRefObjImp)
 
@@ -232,6 +252,7 @@ void Client::PreDelete()
     --n_queued;
   }
   last_xmit_buffer = nullptr;
+  clear_held_packets();
 
   // while (!movementqueue.empty())
   //  movementqueue.pop();
@@ -600,6 +621,204 @@ void ThreadedClient::send_queued_data()
       }
     }
   }
+  send_held_packets();
+}
+
+namespace
+{
+bool is_content( const std::vector<u8>& pkt )
+{
+  return packet_priority( pkt[0] ) >= PacketPriority::WORLD;
+}
+
+// objects a movement or combat packet refers to, false if its layout is unknown
+bool object_refs( const u8* pkt, int len, std::vector<u32>& serials )
+{
+  auto serial_at = [&]( int offset )
+  {
+    if ( offset + 4 > len )
+      return false;
+    u32 serial = static_cast<u32>( ( pkt[offset] << 24 ) | ( pkt[offset + 1] << 16 ) |
+                                   ( pkt[offset + 2] << 8 ) | pkt[offset + 3] );
+    if ( serial != 0 )
+      serials.push_back( serial );
+    return true;
+  };
+  switch ( pkt[0] )
+  {
+  case Core::PKTBI_22_APPROVED_ID:
+  case Core::PKTOUT_21_ID:
+  case Core::PKTOUT_97_ID:
+  case Core::PKTBI_73_ID:
+  case Core::PKTBI_72_ID:
+    return true;
+  case Core::PKTOUT_0B_ID:
+  case Core::PKTOUT_A1_ID:
+  case Core::PKTOUT_A2_ID:
+  case Core::PKTOUT_A3_ID:
+  case Core::PKTOUT_AA_ID:
+    return serial_at( 1 );
+  case Core::PKTOUT_17_ID:
+    return serial_at( 3 );
+  case Core::PKTOUT_2F_ID:
+    return serial_at( 2 ) && serial_at( 6 );
+  default:
+    return false;
+  }
+}
+
+// whether a held world or bulk packet may refer to one of the serials. Speech has a single
+// object, other packets are searched as a whole, at worst a packet needlessly keeps its place.
+bool refers_to( const std::vector<u8>& pkt, const std::vector<u32>& serials )
+{
+  for ( u32 serial : serials )
+  {
+    const u8 bytes[4] = { static_cast<u8>( serial >> 24 ), static_cast<u8>( serial >> 16 ),
+                          static_cast<u8>( serial >> 8 ), static_cast<u8>( serial ) };
+    switch ( pkt[0] )
+    {
+    case Core::PKTOUT_1C_ID:
+    case Core::PKTOUT_AE_ID:
+    case Core::PKTOUT_C1_ID:
+    case Core::PKTOUT_CC_ID:
+      if ( pkt.size() >= 7 && std::equal( bytes, bytes + 4, pkt.begin() + 3 ) )
+        return true;
+      break;
+    default:
+      if ( std::search( pkt.begin(), pkt.end(), bytes, bytes + 4 ) != pkt.end() )
+        return true;
+      break;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+// called with _socketMutex locked
+bool ThreadedClient::hold_packet( PacketPriority priority, const void* data, int len )
+{
+  // the login stream is neither prioritized nor limited
+  if ( !encrypt_server_stream )
+    return false;
+  // without a bandwidth limit a backlog is queued as a whole in the order it was sent. Packets
+  // still held back from a former limit keep new ones waiting until they are sent.
+  if ( !bandwidth_limit() && n_held_total == 0 )
+    return false;
+  const u8* pkt = static_cast<const u8*>( data );
+  const bool content = priority >= PacketPriority::WORLD;
+
+  // movement and combat go in front of the held content, unless one of them already had to
+  // stay behind it or the content refers to their objects, like the world packet introducing a
+  // mobile whose hits are sent
+  auto pos = held_packets.end();
+  const unsigned int held_urgent = n_held[static_cast<unsigned>( PacketPriority::MOVEMENT )] +
+                                   n_held[static_cast<unsigned>( PacketPriority::COMBAT )];
+  std::vector<u32> serials;
+  if ( !content && n_held_ahead == held_urgent && object_refs( pkt, len, serials ) )
+  {
+    auto first = held_packets.begin() + n_held_ahead;
+    if ( std::none_of( first, held_packets.end(), [&]( const std::vector<u8>& held )
+                       { return refers_to( held, serials ); } ) )
+      pos = first;
+  }
+  if ( pos == held_packets.begin() && first_xmit_buffer == nullptr &&
+       consume_send_budget( len, !content ) )
+    return false;
+
+  const bool ahead = !content && pos - held_packets.begin() == n_held_ahead;
+  held_packets.emplace( pos, pkt, pkt + len );
+  ++n_held_total;
+  if ( ahead )
+    ++n_held_ahead;
+  ++n_held[static_cast<unsigned>( priority )];
+  auto& stats = Core::networkManager.iostats.priority[static_cast<unsigned>( priority )];
+  ++stats.queued;
+  ++stats.delayed;
+  return true;
+}
+
+// called with _socketMutex locked, hands held packets in queue order to the socket until it is
+// backlogged again or the bandwidth limit is reached
+void ThreadedClient::send_held_packets()
+{
+  while ( first_xmit_buffer == nullptr && !disconnect && !held_packets.empty() )
+  {
+    const bool content = n_held_ahead == 0;
+    if ( !consume_send_budget( static_cast<int>( held_packets.front().size() ), !content ) )
+      return;
+
+    std::vector<u8> pkt = std::move( held_packets.front() );
+    held_packets.pop_front();
+    --n_held_total;
+    if ( !content )
+      --n_held_ahead;
+    else
+    {
+      // movement and combat which had to wait behind this packet are now in front
+      while ( n_held_ahead < held_packets.size() && !is_content( held_packets[n_held_ahead] ) )
+        ++n_held_ahead;
+    }
+    const auto priority = packet_priority( pkt[0] );
+    --n_held[static_cast<unsigned>( priority )];
+    --Core::networkManager.iostats.priority[static_cast<unsigned>( priority )].queued;
+    send_encoded( pkt.data(), static_cast<int>( pkt.size() ) );
+  }
+}
+
+void ThreadedClient::clear_held_packets()
+{
+  for ( unsigned i = 0; i < PACKET_PRIORITY_COUNT; ++i )
+  {
+    Core::networkManager.iostats.priority[i].queued -= n_held[i];
+    n_held[i] = 0;
+  }
+  held_packets.clear();
+  n_held_total = 0;
+  n_held_ahead = 0;
+}
+
+// token bucket of the bandwidth limit in bytes per second, bursts up to one second.
+// force takes the bytes even from an empty bucket, movement and combat are never delayed by it.
+// Their debt is capped at one second, so content waits at most that long after a burst.
+bool ThreadedClient::consume_send_budget( int len, bool force )
+{
+  const unsigned int limit = bandwidth_limit();
+  if ( !limit )
+    return true;
+  const Core::polclock_t now = Core::polclock();
+  send_budget = std::min<double>(
+      limit, send_budget + static_cast<double>( limit ) * ( now - send_budget_at ) /
+                               Core::POLCLOCKS_PER_SEC );
+  send_budget_at = now;
+  if ( send_budget <= 0 && !force )
+  {
+    send_blocked_until =
+        now + 1 + static_cast<Core::polclock_t>( -send_budget * Core::POLCLOCKS_PER_SEC / limit );
+    return false;
+  }
+  send_budget = std::max<double>( send_budget - len, -static_cast<double>( limit ) );
+  return true;
+}
+
+// Pol.cfg ClientBandwidthLimit unless set for this client
+unsigned int ThreadedClient::bandwidth_limit() const
+{
+  const int limit = bandwidth_limit_;
+  if ( limit < 0 )
+    return Plib::systemstate.config.client_bandwidth_limit;
+  return static_cast<unsigned int>( limit );
+}
+
+// a negative limit goes back to Pol.cfg ClientBandwidthLimit
+void ThreadedClient::bandwidth_limit( int limit )
+{
+  bandwidth_limit_ = limit < 0 ? -1 : limit;
+}
+
+unsigned int ThreadedClient::held_packet_count( PacketPriority priority ) const
+{
+  std::lock_guard<std::mutex> lock( _socketMutex );
+  return n_held[static_cast<unsigned>( priority )];
 }
 
 // 33 01 "encrypted": 4F FA
@@ -796,13 +1015,71 @@ size_t Client::estimatedSize() const
           + sizeof( bool )                                 /* paused_ */
           + sizeof( VersionDetailStruct )                  /* versiondetail_ */
           + sizeof( weak_ptr_owner<Client> )               /*weakptr*/
+          + sizeof( size_t )                               /* known_mobiles_prune_at_ */
       ;
   size += Clib::memsize( movementqueue );
+  size += Clib::memsize( known_mobiles_ );
   if ( gd != nullptr )
     size += gd->estimatedSize();
   return size;
 }
 
+bool Client::knows_mobile( u32 serial ) const
+{
+  return known_mobiles_.count( serial ) != 0;
+}
+
+// Called with the PolLock held for every packet queued for this client
+void Client::note_sent_packet( const u8* data, int len )
+{
+  auto serial_at = [data]( int offset )
+  {
+    return static_cast<u32>( ( data[offset] << 24 ) | ( data[offset + 1] << 16 ) |
+                             ( data[offset + 2] << 8 ) | data[offset + 3] );
+  };
+  switch ( data[0] )
+  {
+  case Core::PKTOUT_78_ID:
+    if ( len >= 7 )
+    {
+      known_mobiles_.insert( serial_at( 3 ) );
+      if ( known_mobiles_.size() >= known_mobiles_prune_at_ )
+        prune_known_mobiles();
+    }
+    break;
+  case Core::PKTOUT_1D_ID:
+    if ( len >= 5 )
+      known_mobiles_.erase( serial_at( 1 ) );
+    break;
+  case Core::PKTOUT_1B_ID:
+    known_mobiles_.clear();
+    break;
+  case Core::PKTBI_BF_ID:
+    // map change, the client drops all objects
+    if ( len >= 5 && data[3] == 0 && data[4] == Core::PKTBI_BF::TYPE_CURSOR_HUE )
+      known_mobiles_.clear();
+    break;
+  default:
+    break;
+  }
+}
+
+// The client drops mobiles which left its update range without a remove packet, their serials
+// would stay forever. Keeping a serial only costs a redundant remove, dropping one the client
+// still shows would leave a ghost, so only mobiles out of range or gone are dropped.
+void Client::prune_known_mobiles()
+{
+  for ( auto itr = known_mobiles_.begin(); itr != known_mobiles_.end(); )
+  {
+    const Mobile::Character* mob = Core::system_find_mobile( *itr );
+    if ( mob == nullptr || ( chr != nullptr && !chr->in_visual_range( mob ) ) )
+      itr = known_mobiles_.erase( itr );
+    else
+      ++itr;
+  }
+  known_mobiles_prune_at_ = std::max( KNOWN_MOBILES_PRUNE_MIN, 2 * known_mobiles_.size() );
+}
+
 // Threaded client stuff
 
 size_t ThreadedClient::estimatedSize() const
@@ -814,6 +1091,8 @@ size_t ThreadedClient::estimatedSize() const
     size += sizeof( buffer_size ) + buffer_size->lenleft;
     buffer_size = buffer_size->next;
   }
+  for ( const auto& pkt : held_packets )
+    size += Clib::memsize( pkt );
   return size;
 }
 void ThreadedClient::closeConnection()
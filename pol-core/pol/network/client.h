@@ -22,13 +22,17 @@
 #ifndef __CLIENT_H
 #define __CLIENT_H
 
+#include <array>
 #include <atomic>
 #include <boost/asio/ip/network_v4.hpp>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "../../clib/network/sockets.h"
 #include "../../clib/rawtypes.h"
@@ -39,6 +43,7 @@
 #include "../../plib/uoexpansion.h"
 #include "../crypt/cryptkey.h"
 #include "../polclock.h"
+#include "packetpriority.h"
 #include "pktdef.h"
 #include "pktin.h"
 
@@ -141,7 +146,12 @@ public:
 
   // methods below should be protected?
   bool have_queued_data() const;
+  bool backlogged() const { return first_xmit_buffer != nullptr; }
+  bool send_throttled() const;
   void send_queued_data();
+  unsigned int held_packet_count( PacketPriority priority ) const;
+  unsigned int bandwidth_limit() const;
+  void bandwidth_limit( int limit );
 
   void recv_remaining( int total_expected );
   void recv_remaining_nocrypt( int total_expected );
@@ -221,6 +231,25 @@ protected:
   void queue_data( const void* data, unsigned short datalen );
   void transmit_encrypted( const void* data, int len );
   void xmit( const void* data, unsigned short datalen );
+  void send_encoded( const void* data, int len );
+
+  // plain packets held back while a bandwidth limit is set and the client is backlogged or over
+  // the limit. They wait in one queue in the order they were sent, only movement and combat
+  // packets may move ahead of world and bulk content which does not refer to their objects.
+  // Without a limit nothing is held.
+  bool hold_packet( PacketPriority priority, const void* data, int len );
+  void send_held_packets();
+  void clear_held_packets();
+  bool consume_send_budget( int len, bool force );
+
+  std::deque<std::vector<u8>> held_packets;
+  std::array<unsigned int, PACKET_PRIORITY_COUNT> n_held;
+  std::atomic<unsigned int> n_held_total;
+  std::atomic<unsigned int> n_held_ahead;  // movement and combat packets in front of the queue
+  std::atomic<int> bandwidth_limit_;       // -1 uses Pol.cfg ClientBandwidthLimit
+  double send_budget;  // bytes, refilled by the bandwidth limit per second
+  Core::polclock_t send_budget_at;
+  std::atomic<Core::polclock_t> send_blocked_until;
 
 private:
   struct
@@ -357,8 +386,17 @@ public:
   Clib::wallclock_t next_movement;
   u8 movementsequence;
 
+  // Whether the client got a create (0x78) for the mobile and no remove (0x1D) since. Kept up to
+  // date by note_sent_packet for every queued packet, so it also covers packets sent by scripts.
+  bool knows_mobile( u32 serial ) const;
+  void note_sent_packet( const u8* data, int len );
+
 private:
   void set_update_range( u8 range );
+  void prune_known_mobiles();
+
+  std::unordered_set<u32> known_mobiles_;
+  size_t known_mobiles_prune_at_;
 
   std::string version_;
   Core::PKTIN_D9 clientinfo_;
@@ -369,7 +407,14 @@ private:
 
 inline bool ThreadedClient::have_queued_data() const
 {
-  return ( first_xmit_buffer != nullptr );
+  return ( first_xmit_buffer != nullptr ) || n_held_ahead > 0 ||
+         ( n_held_total > 0 && !send_throttled() );
+}
+
+// held back content waits for the bandwidth limit
+inline bool ThreadedClient::send_throttled() const
+{
+  return n_held_ahead == 0 && n_held_total > 0 && Core::polclock() < send_blocked_until;
 }
 
 
@@ -10,6 +10,7 @@
 #include <mutex>
 #include <stddef.h>
 #include <string>
+#include <vector>
 
 #include "../../clib/fdump.h"
 #include "../../clib/logfacility.h"
@@ -255,6 +256,13 @@ void Client::transmit( const void* data, int len )
   //
   // If there is no outgoing packet script, handled will be false, and the passed params will be
   // unchanged.
+  //
+  // Declarative packet rules run first and without the PolLock. A patched packet is copied into
+  // patched, which data then points to.
+  std::vector<u8> patched;
+  if ( !Core::networkManager.packet_rules.empty( *static_cast<const u8*>( data ) ) &&
+       !Core::networkManager.packet_rules.apply( this, data, len, patched ) )
+    return;
   {
     PacketHookData* phd = nullptr;
     handled = GetAndCheckPacketHooked( this, data, phd );
@@ -298,9 +306,16 @@ void Client::transmit( const void* data, int len )
   Core::networkManager.iostats.sent[msgtype].count++;
   Core::networkManager.iostats.sent[msgtype].bytes += len;
 
+  if ( hold_packet( packet_priority( msgtype ), data, len ) )
+    return;
+  send_encoded( data, len );
+}
+
+void ThreadedClient::send_encoded( const void* data, int len )
+{
   if ( encrypt_server_stream )
   {
-    pause();
+    myClient.pause();
     transmit_encrypted( data, len );
   }
   else
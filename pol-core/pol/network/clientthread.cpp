@@ -65,6 +65,10 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
                              int& nidle )
 {
   SESSION_CHECKPOINT( 1 );
+  // wake up in time to continue sending the packets held back by the bandwidth limit
+  const bool throttled = session->send_throttled();
+  if ( throttled )
+    clientpoller.set_timeout( 50 );
   if ( !clientpoller.prepare( session->have_queued_data() ) )
   {
     POLLOG_INFO( "Client#{}: ERROR - couldn't poll socket={}\n", session->myClient.instance_,
@@ -83,6 +87,8 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
     res = clientpoller.wait_for_events();
     SESSION_CHECKPOINT( 3 );
   } while ( res < 0 && !Clib::exit_signalled && socket_errno == SOCKET_ERRNO( EINTR ) );
+  if ( throttled )
+    set_polling_timeouts( clientpoller, false );
 
   if ( res < 0 )
   {
@@ -90,7 +96,7 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
     POLLOGLN( "Client#{}: select res={}, sckerr={}", session->myClient.instance_, res, sckerr );
     return false;
   }
-  else if ( res == 0 )
+  else if ( res == 0 && !throttled )
   {
     if ( session->myClient.should_check_idle() )
     {
@@ -156,7 +162,8 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
     return false;
   }
 
-  if ( session->have_queued_data() && clientpoller.writable() )
+  // held packets do not need a writable socket, they are queued again if it would block
+  if ( session->have_queued_data() && ( clientpoller.writable() || !session->backlogged() ) )
   {
     PolLock lck;
     SESSION_CHECKPOINT( 8 );
@@ -21,6 +21,7 @@ void ClientTransmit::Cancel()
 void ClientTransmit::AddToQueue( Client* client, const void* data, int len )
 {
   const u8* message = static_cast<const u8*>( data );
+  client->note_sent_packet( message, len );
   auto transmitdata = TransmitDataSPtr( new TransmitData );
   transmitdata->client = client->getWeakPtr();
   transmitdata->len = len;
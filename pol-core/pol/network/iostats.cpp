@@ -16,6 +16,13 @@ IOStats::IOStats()
 {
   memset( &sent, 0, sizeof sent );
   memset( &received, 0, sizeof received );
+  tooltip_cache.hits = 0;
+  tooltip_cache.misses = 0;
+  for ( auto& prio : priority )
+  {
+    prio.queued = 0;
+    prio.delayed = 0;
+  }
 }
 }
 }
@@ -7,6 +7,9 @@
 #define __IOSTATS_H
 
 #include <atomic>
+
+#include "packetpriority.h"
+
 namespace Pol
 {
 namespace Network
@@ -24,6 +27,23 @@ public:
 
   Packet sent[256];
   Packet received[256];
+
+  struct Cache
+  {
+    std::atomic<unsigned int> hits;
+    std::atomic<unsigned int> misses;
+  };
+
+  Cache tooltip_cache;
+
+  // outgoing packets held back per priority class, see ThreadedClient::hold_packet
+  struct Priority
+  {
+    std::atomic<unsigned int> queued;   // currently waiting
+    std::atomic<unsigned int> delayed;  // total held back
+  };
+
+  Priority priority[PACKET_PRIORITY_COUNT];
 };
 }
 }
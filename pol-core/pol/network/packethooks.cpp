@@ -37,6 +37,7 @@
 #include "../packetscrobj.h"
 #include "../syshook.h"
 #include "client.h"
+#include "packetrules.h"
 
 namespace Pol
 {
@@ -440,8 +441,10 @@ void load_subpacket_entries( const Plib::Package* pkg, Clib::ConfigElem& elem )
 // loads "uopacket.cfg" entries from packages
 void load_packet_hooks()
 {
-  Plib::load_packaged_cfgs( "uopacket.cfg", "packet subpacket", load_packet_entries );
-  Plib::load_packaged_cfgs( "uopacket.cfg", "packet subpacket", load_subpacket_entries );
+  Plib::load_packaged_cfgs( "uopacket.cfg", "packet subpacket packetrule", load_packet_entries );
+  Plib::load_packaged_cfgs( "uopacket.cfg", "packet subpacket packetrule",
+                            load_subpacket_entries );
+  Plib::load_packaged_cfgs( "uopacket.cfg", "packet subpacket packetrule", load_packet_rules );
 }
 
 PacketHookData::PacketHookData()
@@ -496,6 +499,7 @@ void clean_packethooks()
 {
   Core::networkManager.packet_hook_data.clear();
   Core::networkManager.packet_hook_data_v2.clear();
+  Core::networkManager.packet_rules.clear();
 }
 
 void SetVersionDetailStruct( const std::string& ver, VersionDetailStruct& detail )
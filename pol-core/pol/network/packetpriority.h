@@ -0,0 +1,80 @@
+/** @file
+ *
+ * @par History
+ */
+
+#ifndef __PACKETPRIORITY_H
+#define __PACKETPRIORITY_H
+
+#include "../../clib/rawtypes.h"
+#include "pktbothid.h"
+#include "pktoutid.h"
+
+namespace Pol
+{
+namespace Network
+{
+// Priority classes of outgoing packets, in the order a backlogged client gets them.
+enum class PacketPriority : u8
+{
+  MOVEMENT,
+  COMBAT,
+  WORLD,
+  BULK
+};
+const unsigned PACKET_PRIORITY_COUNT = 4;
+
+inline const char* packet_priority_name( PacketPriority priority )
+{
+  switch ( priority )
+  {
+  case PacketPriority::MOVEMENT:
+    return "movement";
+  case PacketPriority::COMBAT:
+    return "combat";
+  case PacketPriority::WORLD:
+    return "world";
+  case PacketPriority::BULK:
+    return "bulk";
+  }
+  return "";
+}
+
+inline PacketPriority packet_priority( u8 msgtype )
+{
+  switch ( msgtype )
+  {
+  case Core::PKTBI_22_APPROVED_ID:
+  case Core::PKTOUT_21_ID:
+  case Core::PKTOUT_97_ID:
+  case Core::PKTBI_73_ID:
+    return PacketPriority::MOVEMENT;
+
+  case Core::PKTOUT_0B_ID:
+  case Core::PKTOUT_17_ID:
+  case Core::PKTOUT_2F_ID:
+  case Core::PKTBI_72_ID:
+  case Core::PKTOUT_A1_ID:
+  case Core::PKTOUT_A2_ID:
+  case Core::PKTOUT_A3_ID:
+  case Core::PKTOUT_AA_ID:
+    return PacketPriority::COMBAT;
+
+  case Core::PKTOUT_3C_ID:
+  case Core::PKTBI_66_ID:
+  case Core::PKTOUT_74_ID:
+  case Core::PKTOUT_9E_ID:
+  case Core::PKTOUT_A6_ID:
+  case Core::PKTOUT_B0_ID:
+  case Core::PKTBI_D6_OUT_ID:
+  case Core::PKTOUT_D8_ID:
+  case Core::PKTOUT_DD_ID:
+    return PacketPriority::BULK;
+
+  default:
+    return PacketPriority::WORLD;
+  }
+}
+}  // namespace Network
+}  // namespace Pol
+#endif
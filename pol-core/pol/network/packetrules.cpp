@@ -0,0 +1,272 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "packetrules.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../clib/cfgelem.h"
+#include "../../clib/clib.h"
+#include "../../clib/stlutil.h"
+#include "../../clib/strutil.h"
+#include "../globals/network.h"
+#include "packethooks.h"
+
+namespace Pol
+{
+namespace Network
+{
+static u32 parse_number( Clib::ConfigElem& elem, const std::string& str, const char* propname )
+{
+  char* endptr = nullptr;
+  unsigned long value = strtoul( str.c_str(), &endptr, 0 );
+  if ( str.empty() || ( endptr != nullptr && *endptr != '\0' && !isspace( *endptr ) ) )
+    elem.throw_error( std::string( propname ) + " value '" + str + "' is poorly formed" );
+  return static_cast<u32>( value );
+}
+
+PacketRule::PacketRule( Clib::ConfigElem& elem )
+    : name_( elem.rest() ),
+      msgid_( 0 ),
+      drop_( elem.remove_bool( "Drop", false ) ),
+      min_length_( 1 ),
+      client_ver_(),
+      matches_(),
+      patches_(),
+      hits_( 0 )
+{
+  if ( name_.empty() )
+    elem.throw_error( "PacketRule name missing" );
+
+  unsigned int idlong = elem.remove_ulong( "Packet" );
+  if ( idlong > 0xFF )
+    elem.throw_error( "Packet ID must be between 0x0 and 0xFF" );
+  msgid_ = static_cast<u8>( idlong );
+
+  SetVersionDetailStruct( elem.remove_string( "Client", "1.25.25.0" ), client_ver_ );
+
+  read_ops( elem, "Match", Op::Type::MATCH, matches_ );
+  read_ops( elem, "Set", Op::Type::SET, patches_ );
+  read_ops( elem, "Or", Op::Type::OR, patches_ );
+  read_ops( elem, "And", Op::Type::AND, patches_ );
+  read_ops( elem, "Xor", Op::Type::XOR, patches_ );
+
+  if ( !drop_ && patches_.empty() )
+    elem.throw_error( "PacketRule needs at least one of Set, Or, And, Xor or Drop" );
+}
+
+void PacketRule::read_ops( Clib::ConfigElem& elem, const char* propname, Op::Type type,
+                           std::vector<Op>& ops )
+{
+  std::string line;
+  while ( elem.remove_prop( propname, &line ) )
+  {
+    ISTRINGSTREAM is( line );
+    std::string offset_str, size_str, value_str, mask_str;
+    if ( !( is >> offset_str >> size_str >> value_str ) )
+      elem.throw_error( std::string( propname ) + " expects 'offset size value': " + line );
+    Op op;
+    op.type = type;
+    u32 offset = parse_number( elem, offset_str, propname );
+    u32 size = parse_number( elem, size_str, propname );
+    op.value = parse_number( elem, value_str, propname );
+    if ( size != 1 && size != 2 && size != 4 )
+      elem.throw_error( std::string( propname ) + " size must be 1, 2 or 4: " + line );
+    if ( offset > 0xFFFF - size )
+      elem.throw_error( std::string( propname ) + " offset is out of range: " + line );
+    if ( type != Op::Type::MATCH && offset == 0 )
+      elem.throw_error( std::string( propname ) + " must not change the packet id: " + line );
+    op.size = static_cast<u8>( size );
+    op.offset = static_cast<u16>( offset );
+    op.mask = size == 4 ? 0xFFFFFFFFu : ( ( 1u << ( size * 8 ) ) - 1 );
+    if ( type == Op::Type::MATCH && ( is >> mask_str ) )
+      op.mask &= parse_number( elem, mask_str, propname );
+    if ( op.value & ~op.mask )
+      elem.throw_error( std::string( propname ) + " value does not fit into size: " + line );
+    min_length_ = std::max( min_length_, static_cast<int>( offset + size ) );
+    ops.push_back( op );
+  }
+}
+
+u32 PacketRule::read( const u8* data, const Op& op )
+{
+  const u8* p = data + op.offset;
+  switch ( op.size )
+  {
+  case 1:
+    return p[0];
+  case 2:
+    return ( static_cast<u32>( p[0] ) << 8 ) | p[1];
+  default:
+    return ( static_cast<u32>( p[0] ) << 24 ) | ( static_cast<u32>( p[1] ) << 16 ) |
+           ( static_cast<u32>( p[2] ) << 8 ) | p[3];
+  }
+}
+
+void PacketRule::write( u8* data, const Op& op, u32 value )
+{
+  u8* p = data + op.offset;
+  for ( int i = op.size - 1; i >= 0; --i )
+  {
+    p[i] = static_cast<u8>( value & 0xFF );
+    value >>= 8;
+  }
+}
+
+bool PacketRule::matches( const Client* client, const u8* data, int len ) const
+{
+  if ( len < min_length_ )
+    return false;
+  for ( const auto& op : matches_ )
+  {
+    if ( ( read( data, op ) & op.mask ) != op.value )
+      return false;
+  }
+  if ( client != nullptr && !CompareVersionDetail( client->getversiondetail(), client_ver_ ) )
+    return false;
+  ++hits_;
+  return true;
+}
+
+bool PacketRule::apply( u8* data ) const
+{
+  if ( drop_ )
+    return false;
+  for ( const auto& op : patches_ )
+  {
+    switch ( op.type )
+    {
+    case Op::Type::SET:
+      write( data, op, op.value );
+      break;
+    case Op::Type::OR:
+      write( data, op, read( data, op ) | op.value );
+      break;
+    case Op::Type::AND:
+      write( data, op, read( data, op ) & op.value );
+      break;
+    case Op::Type::XOR:
+      write( data, op, read( data, op ) ^ op.value );
+      break;
+    default:
+      break;
+    }
+  }
+  return true;
+}
+
+bool PacketRule::drops() const
+{
+  return drop_;
+}
+
+bool PacketRule::patches() const
+{
+  return !patches_.empty();
+}
+
+const std::string& PacketRule::name() const
+{
+  return name_;
+}
+
+u8 PacketRule::msgid() const
+{
+  return msgid_;
+}
+
+u64 PacketRule::hits() const
+{
+  return hits_;
+}
+
+size_t PacketRule::estimateSize() const
+{
+  return sizeof( PacketRule ) + name_.capacity() + Clib::memsize( matches_ ) +
+         Clib::memsize( patches_ );
+}
+
+
+PacketRules::PacketRules() : rules_() {}
+
+void PacketRules::load( Clib::ConfigElem& elem )
+{
+  auto rule = std::make_unique<PacketRule>( elem );
+  for ( const auto& existing : rules() )
+  {
+    if ( existing->name() == rule->name() )
+      elem.throw_error( "PacketRule " + rule->name() + " multiply defined!" );
+  }
+  rules_[rule->msgid()].push_back( std::move( rule ) );
+}
+
+void PacketRules::clear()
+{
+  for ( auto& rules : rules_ )
+    rules.clear();
+}
+
+bool PacketRules::empty( u8 msgid ) const
+{
+  return rules_[msgid].empty();
+}
+
+bool PacketRules::apply( const Client* client, const void*& data, int len,
+                         std::vector<u8>& buffer ) const
+{
+  const u8* message = static_cast<const u8*>( data );
+  for ( const auto& rule : rules_[message[0]] )
+  {
+    if ( !rule->matches( client, message, len ) )
+      continue;
+    if ( rule->drops() )
+      return false;
+    // the caller keeps its buffer, patches work on a copy
+    if ( message != buffer.data() )
+    {
+      buffer.assign( message, message + len );
+      message = buffer.data();
+      data = message;
+    }
+    rule->apply( buffer.data() );
+  }
+  return true;
+}
+
+std::vector<const PacketRule*> PacketRules::rules() const
+{
+  std::vector<const PacketRule*> all;
+  for ( const auto& rules : rules_ )
+  {
+    for ( const auto& rule : rules )
+      all.push_back( rule.get() );
+  }
+  return all;
+}
+
+size_t PacketRules::estimateSize() const
+{
+  size_t size = 0;
+  for ( const auto& rules : rules_ )
+  {
+    size += Clib::memsize( rules );
+    for ( const auto& rule : rules )
+      size += rule->estimateSize();
+  }
+  return size;
+}
+
+void load_packet_rules( const Plib::Package* /*pkg*/, Clib::ConfigElem& elem )
+{
+  if ( stricmp( elem.type(), "PacketRule" ) != 0 )
+    return;
+  Core::networkManager.packet_rules.load( elem );
+}
+}  // namespace Network
+}  // namespace Pol
@@ -0,0 +1,111 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef PACKETRULES_H
+#define PACKETRULES_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../clib/rawtypes.h"
+#include "client.h"
+
+namespace Pol
+{
+namespace Clib
+{
+class ConfigElem;
+}
+namespace Plib
+{
+class Package;
+}
+namespace Network
+{
+/**
+ * Declarative rule for outgoing packets, read from "PacketRule" entries in uopacket.cfg.
+ * A rule is compiled into a list of big endian compares and patches at fixed offsets, which are
+ * executed in Client::transmit without PolLock and without the script VM.
+ */
+class PacketRule
+{
+public:
+  explicit PacketRule( Clib::ConfigElem& elem );
+  PacketRule( const PacketRule& ) = delete;
+  PacketRule& operator=( const PacketRule& ) = delete;
+
+  bool matches( const Client* client, const u8* data, int len ) const;
+  // returns false if the packet has to be dropped
+  bool apply( u8* data ) const;
+  bool drops() const;
+  bool patches() const;
+
+  const std::string& name() const;
+  u8 msgid() const;
+  u64 hits() const;
+  size_t estimateSize() const;
+
+private:
+  struct Op
+  {
+    enum class Type : u8
+    {
+      MATCH,
+      SET,
+      OR,
+      AND,
+      XOR
+    };
+    Type type;
+    u8 size;
+    u16 offset;
+    u32 value;
+    u32 mask;
+  };
+  void read_ops( Clib::ConfigElem& elem, const char* propname, Op::Type type,
+                 std::vector<Op>& ops );
+  static u32 read( const u8* data, const Op& op );
+  static void write( u8* data, const Op& op, u32 value );
+
+  std::string name_;
+  u8 msgid_;
+  bool drop_;
+  int min_length_;
+  VersionDetailStruct client_ver_;
+  std::vector<Op> matches_;
+  std::vector<Op> patches_;
+  mutable std::atomic<u64> hits_;
+};
+
+class PacketRules
+{
+public:
+  PacketRules();
+
+  void load( Clib::ConfigElem& elem );
+  void clear();
+  bool empty( u8 msgid ) const;
+  /**
+   * Applies the rules of the packet in order of their definition.
+   * If a rule patches the packet data gets redirected into buffer.
+   * Returns false if the packet has to be dropped.
+   */
+  bool apply( const Client* client, const void*& data, int len, std::vector<u8>& buffer ) const;
+
+  std::vector<const PacketRule*> rules() const;
+  size_t estimateSize() const;
+
+private:
+  std::array<std::vector<std::unique_ptr<PacketRule>>, 256> rules_;
+};
+
+void load_packet_rules( const Plib::Package* pkg, Clib::ConfigElem& elem );
+}  // namespace Network
+}  // namespace Pol
+#endif
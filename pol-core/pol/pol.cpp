@@ -697,7 +697,7 @@ void threadstatus_thread( void )
                       "Number of clients: {}\n",
                       stateManager.polsig.scripts_thread_checkpoint, Clib::scripts_thread_script,
                       Clib::scripts_thread_scriptPC, Bscript::escript_instr_cycles,
-                      stateManager.polsig.tasks_thread_checkpoint,
+                      stateManager.polsig.tasks_thread_checkpoint.load(),
                       stateManager.polsig.active_client_thread_checkpoint,
                       Core::networkManager.clients.size() );
       for ( const auto& client : Core::networkManager.clients )
@@ -981,6 +981,8 @@ int xmain_inner( bool testing )
   // gamestate :(
   Core::gamestate.task_thread_pool.init_pool(
       std::max( 2u, std::thread::hardware_concurrency() / 2 ), "generic_task_thread" );
+  Core::gamestate.realm_thread_pool.init_pool(
+      std::max( 2u, std::thread::hardware_concurrency() / 2 ), "realm_task_thread" );
 
   int res;
 
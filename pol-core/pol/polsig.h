@@ -6,6 +6,9 @@
 
 #ifndef __POLSIG_H
 #define __POLSIG_H
+
+#include <atomic>
+
 namespace Pol
 {
 namespace Core
@@ -35,7 +38,8 @@ struct PolSig
   // 800-899: swing_task_func
   // 900-999: SpellTask::on_run
   // 1000-1099: RepSystem::repsys_task
-  unsigned tasks_thread_checkpoint;
+  // also set from the realm tasks of regen_stats
+  std::atomic<unsigned> tasks_thread_checkpoint;
 
   // 100-199: transmit_encrypted
   // 200-299: Client::xmit
@@ -14,18 +14,26 @@
 
 #include "polwww.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
 #include <ctype.h>
 #include <errno.h>
 #include <iosfwd>
+#include <map>
+#include <memory>
 #include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include <time.h>
+#include <vector>
 
 #include "../clib/cfgelem.h"
 #include "../clib/cfgfile.h"
 #include "../clib/esignal.h"
 #include "../clib/fileutil.h"
 #include "../clib/logfacility.h"
+#include "../clib/network/singlepollers/pollingwithpoll.h"
 #include "../clib/network/sockets.h"
 #include "../clib/network/wnsckt.h"
 #include "../clib/passert.h"
@@ -51,7 +59,12 @@
 #ifdef _WIN32
 #include <process.h>
 #else
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
 #endif
 
 
@@ -137,7 +150,14 @@ void http_writeline( Clib::Socket& sck, const std::string& s )
   sck.send( "\r\n", 2 );
 }
 
-void http_forbidden( Clib::Socket& sck )
+void http_writeline( std::string& out, const std::string& s )
+{
+  out += s;
+  out += "\r\n";
+}
+
+template <class Out>
+void http_forbidden( Out& sck )
 {
   http_writeline( sck, "HTTP/1.1 403 Forbidden" );
   http_writeline( sck, "Content-Type: text/html" );
@@ -148,7 +168,8 @@ void http_forbidden( Clib::Socket& sck )
   http_writeline( sck, "</BODY></HTML>" );
 }
 
-void http_forbidden( Clib::Socket& sck, const std::string& filename )
+template <class Out>
+void http_forbidden( Out& sck, const std::string& filename )
 {
   http_writeline( sck, "HTTP/1.1 403 Forbidden" );
   http_writeline( sck, "Content-Type: text/html" );
@@ -159,7 +180,8 @@ void http_forbidden( Clib::Socket& sck, const std::string& filename )
   http_writeline( sck, "</BODY></HTML>" );
 }
 
-void http_not_authorized( Clib::Socket& sck, const std::string& /*filename*/ )
+template <class Out>
+void http_not_authorized( Out& sck, const std::string& /*filename*/ )
 {
   http_writeline( sck, "HTTP/1.1 401 Unauthorized" );
   http_writeline( sck, "WWW-Authenticate: Basic realm=\"pol\"" );
@@ -171,7 +193,8 @@ void http_not_authorized( Clib::Socket& sck, const std::string& /*filename*/ )
   http_writeline( sck, "</BODY></HTML>" );
 }
 
-void http_internal_error( Clib::Socket& sck, const std::string& filename )
+template <class Out>
+void http_internal_error( Out& sck, const std::string& filename )
 {
   http_writeline( sck, "HTTP/1.1 500 Internal Sever Error" );
   http_writeline( sck, "Content-Type: text/html" );
@@ -182,7 +205,8 @@ void http_internal_error( Clib::Socket& sck, const std::string& filename )
   http_writeline( sck, "</BODY></HTML>" );
 }
 
-void http_not_found( Clib::Socket& sck, const std::string& filename )
+template <class Out>
+void http_not_found( Out& sck, const std::string& filename )
 {
   http_writeline( sck, "HTTP/1.1 404 Not Found" );
   http_writeline( sck, "Content-Type: text/html" );
@@ -193,7 +217,8 @@ void http_not_found( Clib::Socket& sck, const std::string& filename )
   http_writeline( sck, "</BODY></HTML>" );
 }
 
-void http_redirect( Clib::Socket& sck, const std::string& new_url )
+template <class Out>
+void http_redirect( Out& sck, const std::string& new_url )
 {
   // cerr << "http: redirecting to " << new_url << endl;
 
@@ -742,61 +767,29 @@ void send_binary( Clib::Socket& sck, const std::string& page, const std::string&
   }
 }
 
-void http_func( SOCKET client_socket )
+struct HttpRoute
 {
-  Clib::Socket sck( client_socket );
-  Clib::SocketLineReader lineReader( sck, 5, 3000,
-                                     false );  // we take care of disconnecting at timeout
-
-  std::string get;
-  std::string auth;
-  std::string tmpstr;
-  std::string host;
-
-  if ( Plib::systemstate.config.web_server_local_only && !sck.is_local() )
-  {
-    http_forbidden( sck );
-    return;
-  }
-
-  bool timed_out = false;
-  Tools::HighPerfTimer requestTimer;
-  while ( sck.connected() && lineReader.read( tmpstr, &timed_out ) )
-  {
-    if ( Plib::systemstate.config.web_server_debug )
-      INFO_PRINTLN( "http({}): '{}'", sck.handle(), tmpstr );
-    if ( tmpstr.empty() )
-      break;
-    if ( strncmp( tmpstr.c_str(), "GET", 3 ) == 0 )
-      get = tmpstr;
-    if ( strncmp( tmpstr.c_str(), "Authorization:", 14 ) == 0 )
-      auth = tmpstr;
-    if ( strncmp( tmpstr.c_str(), "Host: ", 5 ) == 0 )
-      host = tmpstr.substr( 6 );
-  }
-
-  if ( timed_out )
-  {
-    INFO_PRINTLN( "HTTP connection {} timed out", sck.getpeername() );
-    sck.close();
-  }
-
-  if ( !sck.connected() )
-    return;
-
-  if ( Plib::systemstate.config.web_server_debug )
-  {
-    INFO_PRINTLN( "[{} msec] finished reading header",
-                  double( requestTimer.ellapsed().count() / 1000.0 ) );
-  }
+  std::string proto;
+  std::string page;
+  std::string query_string;
+  Plib::Package* pkg = nullptr;
+  std::string filename;
+  std::string pagetype;
+};
 
+// Decodes the request line, checks the authorization and resolves the page.
+// Writes the response and returns false if there is nothing left to serve.
+template <class Out>
+bool http_route( Out& sck, const std::string& get, const std::string& auth,
+                 const std::string& host, HttpRoute& route )
+{
   ISTRINGSTREAM is( get );
 
-  std::string cmd;           // GET, POST  (we only handle GET)
-  std::string url;           // The whole URL (xx.ecl?a=b&c=d)
-  std::string proto;         // HTTP/1.1
-  std::string page;          // xx.ecl
-  std::string query_string;  // a=b&c=d
+  std::string cmd;  // GET, POST  (we only handle GET)
+  std::string url;  // The whole URL (xx.ecl?a=b&c=d)
+  std::string& proto = route.proto;
+  std::string& page = route.page;
+  std::string& query_string = route.query_string;
 
   is >> cmd >> url >> proto;
 
@@ -854,13 +847,13 @@ void http_func( SOCKET client_socket )
       if ( Plib::systemstate.config.web_server_password != unpw )
       {
         http_not_authorized( sck, url );
-        return;
+        return false;
       }
     }
     else
     {
       http_not_authorized( sck, url );
-      return;
+      return false;
     }
   }
 
@@ -868,51 +861,517 @@ void http_func( SOCKET client_socket )
   {
     // FIXME should probably be access denied
     http_forbidden( sck, page );
-    return;
+    return false;
   }
 
 
-  Plib::Package* pkg = nullptr;
-  std::string filename;
-  std::string pagetype;
   std::string redirect_to;
-  if ( !decode_page( page, &pkg, &filename, &pagetype, &redirect_to ) )
+  if ( !decode_page( page, &route.pkg, &route.filename, &route.pagetype, &redirect_to ) )
   {
     http_not_found( sck, page );
-    return;
+    return false;
   }
   if ( !redirect_to.empty() )
   {
     http_redirect( sck, /*"http://" + host +*/ redirect_to );
+    return false;
+  }
+
+  if ( Plib::systemstate.config.web_server_debug )
+    INFO_PRINTLN( "Page type: {}", route.pagetype );
+  return true;
+}
+
+void http_func( SOCKET client_socket )
+{
+  Clib::Socket sck( client_socket );
+  Clib::SocketLineReader lineReader( sck, 5, 3000,
+                                     false );  // we take care of disconnecting at timeout
+
+  std::string get;
+  std::string auth;
+  std::string tmpstr;
+  std::string host;
+
+  if ( Plib::systemstate.config.web_server_local_only && !sck.is_local() )
+  {
+    http_forbidden( sck );
     return;
   }
 
+  bool timed_out = false;
+  Tools::HighPerfTimer requestTimer;
+  while ( sck.connected() && lineReader.read( tmpstr, &timed_out ) )
+  {
+    if ( Plib::systemstate.config.web_server_debug )
+      INFO_PRINTLN( "http({}): '{}'", sck.handle(), tmpstr );
+    if ( tmpstr.empty() )
+      break;
+    if ( strncmp( tmpstr.c_str(), "GET", 3 ) == 0 )
+      get = tmpstr;
+    if ( strncmp( tmpstr.c_str(), "Authorization:", 14 ) == 0 )
+      auth = tmpstr;
+    if ( strncmp( tmpstr.c_str(), "Host: ", 5 ) == 0 )
+      host = tmpstr.substr( 6 );
+  }
+
+  if ( timed_out )
+  {
+    INFO_PRINTLN( "HTTP connection {} timed out", sck.getpeername() );
+    sck.close();
+  }
+
+  if ( !sck.connected() )
+    return;
+
   if ( Plib::systemstate.config.web_server_debug )
-    INFO_PRINTLN( "Page type: {}", pagetype );
+  {
+    INFO_PRINTLN( "[{} msec] finished reading header",
+                  double( requestTimer.ellapsed().count() / 1000.0 ) );
+  }
 
-  if ( pagetype == "ecl" )
+  HttpRoute route;
+  if ( !http_route( sck, get, auth, host, route ) )
+    return;
+
+  if ( route.pagetype == "ecl" )
   {
     // Note it takes ownership of the socket
-    start_http_script( sck, page, pkg, filename, query_string );
+    start_http_script( sck, route.page, route.pkg, route.filename, route.query_string );
+  }
+  else if ( route.pagetype == "htm" || route.pagetype == "html" )
+  {
+    send_html( sck, route.page, route.filename );
+  }
+  else
+  {
+    std::string type = gamestate.mime_types[route.pagetype];
+    if ( type.length() > 0 )
+    {
+      send_binary( sck, route.page, route.filename, type );
+    }
+    else
+    {
+      POLLOG_INFOLN( "HTTP server: I can't handle pagetype '{}'", route.pagetype );
+      http_internal_error( sck, route.page );
+    }
+  }
+}
+
+
+namespace
+{
+// limits of the keep-alive mode
+const size_t HTTP_MAX_CONNECTIONS = 64;
+const size_t HTTP_MAX_HEADER_SIZE = 8 * 1024;
+const size_t HTTP_CACHE_MAX_FILESIZE = 256 * 1024;
+const size_t HTTP_CACHE_MAX_SIZE = 32 * 1024 * 1024;
+const size_t HTTP_FILE_CHUNK = 64 * 1024;
+
+bool http_set_blocking( SOCKET sck, bool blocking )
+{
+#ifdef _WIN32
+  u_long nonblocking = blocking ? 0 : 1;
+  return ioctlsocket( sck, FIONBIO, &nonblocking ) == 0;
+#else
+  int flags = fcntl( sck, F_GETFL );
+  if ( flags == -1 )
+    return false;
+  flags = blocking ? ( flags & ~O_NONBLOCK ) : ( flags | O_NONBLOCK );
+  return fcntl( sck, F_SETFL, flags ) == 0;
+#endif
+}
+
+// Content of the small static files, an entry is reloaded if the modification time or size of
+// the file changed. Only used by the http thread.
+class StaticFileCache
+{
+public:
+  std::shared_ptr<const std::string> get( const std::string& filename, time_t mtime,
+                                          size_t size );
+
+private:
+  struct Entry
+  {
+    time_t mtime;
+    std::shared_ptr<const std::string> data;
+  };
+  std::map<std::string, Entry> _entries;
+  size_t _size = 0;
+};
+
+std::shared_ptr<const std::string> StaticFileCache::get( const std::string& filename,
+                                                         time_t mtime, size_t size )
+{
+  auto itr = _entries.find( filename );
+  if ( itr != _entries.end() )
+  {
+    if ( itr->second.mtime == mtime && itr->second.data->size() == size )
+      return itr->second.data;
+    _size -= itr->second.data->size();
+    _entries.erase( itr );
+  }
+  if ( size > HTTP_CACHE_MAX_FILESIZE )
+    return nullptr;
+
+  std::ifstream ifs( filename.c_str(), std::ios::binary );
+  if ( !ifs.is_open() )
+    return nullptr;
+  auto data = std::make_shared<std::string>( size, '\0' );
+  ifs.read( &( *data )[0], size );
+  if ( static_cast<size_t>( ifs.gcount() ) != size )
+    return nullptr;  // changed while reading, serve it uncached
+
+  if ( _size + size > HTTP_CACHE_MAX_SIZE )
+  {
+    _entries.clear();
+    _size = 0;
+  }
+  _size += size;
+  _entries.emplace( filename, Entry{ mtime, data } );
+  return data;
+}
+
+struct HttpConnection
+{
+  explicit HttpConnection( SOCKET sock ) : sck( sock ) {}
+
+  bool pending() const { return out_pos < out.size() || cached || file_remaining > 0; }
+  void reset_file();
+
+  Clib::Socket sck;
+  std::string in;
+  std::string out;
+  size_t out_pos = 0;
+  std::shared_ptr<const std::string> cached;
+  size_t cached_pos = 0;
+#ifdef __linux__
+  int file_fd = -1;
+  off_t file_offset = 0;
+#else
+  std::ifstream file;
+#endif
+  size_t file_remaining = 0;
+  bool close_after = false;
+  std::chrono::steady_clock::time_point last_activity = std::chrono::steady_clock::now();
+};
+
+void HttpConnection::reset_file()
+{
+  file_remaining = 0;
+#ifdef __linux__
+  if ( file_fd != -1 )
+    ::close( file_fd );
+  file_fd = -1;
+  file_offset = 0;
+#else
+  file.close();
+#endif
+}
+
+bool http_would_block()
+{
+  int err = socket_errno;
+  return err == SOCKET_ERRNO( EWOULDBLOCK ) || err == SOCKET_ERRNO( EINTR );
+}
+
+bool http_send_buffer( HttpConnection& conn, const char* data, size_t len, size_t& pos )
+{
+  while ( pos < len )
+  {
+    int res = ::send( conn.sck.handle(), data + pos, static_cast<int>( len - pos ), 0 );
+    if ( res < 0 )
+      return http_would_block();
+    pos += res;
   }
-  else if ( pagetype == "htm" || pagetype == "html" )
+  return true;
+}
+
+// Sends as much as the socket accepts, returns false if the connection has to be closed
+bool http_flush( HttpConnection& conn )
+{
+  if ( !http_send_buffer( conn, conn.out.data(), conn.out.size(), conn.out_pos ) )
+    return false;
+  if ( conn.out_pos < conn.out.size() )
+    return true;
+  conn.out.clear();
+  conn.out_pos = 0;
+
+  if ( conn.cached )
   {
-    send_html( sck, page, filename );
+    if ( !http_send_buffer( conn, conn.cached->data(), conn.cached->size(), conn.cached_pos ) )
+      return false;
+    if ( conn.cached_pos < conn.cached->size() )
+      return true;
+    conn.cached.reset();
+    conn.cached_pos = 0;
+  }
+
+  while ( conn.file_remaining > 0 )
+  {
+#ifdef __linux__
+    ssize_t res = ::sendfile( conn.sck.handle(), conn.file_fd, &conn.file_offset,
+                              std::min( conn.file_remaining, HTTP_FILE_CHUNK * 16 ) );
+    if ( res < 0 )
+      return http_would_block();
+    if ( res == 0 )
+      return false;  // file got truncated
+    conn.file_remaining -= res;
+#else
+    conn.out.resize( std::min( conn.file_remaining, HTTP_FILE_CHUNK ) );
+    conn.file.read( &conn.out[0], conn.out.size() );
+    if ( static_cast<size_t>( conn.file.gcount() ) != conn.out.size() )
+      return false;
+    conn.file_remaining -= conn.out.size();
+    if ( !http_send_buffer( conn, conn.out.data(), conn.out.size(), conn.out_pos ) )
+      return false;
+    if ( conn.out_pos < conn.out.size() )
+      return true;
+    conn.out.clear();
+    conn.out_pos = 0;
+#endif
+  }
+  conn.reset_file();
+  return !conn.close_after;
+}
+
+// Queues a static file: small files from the cache, larger ones get streamed
+void http_send_file( HttpConnection& conn, StaticFileCache& cache, const HttpRoute& route,
+                     const std::string& content_type, bool keep_alive )
+{
+  struct stat st;
+  if ( stat( route.filename.c_str(), &st ) != 0 || ( st.st_mode & S_IFMT ) != S_IFREG )
+  {
+    http_not_found( conn.out, route.page );
+    conn.close_after = true;
+    return;
+  }
+  size_t size = static_cast<size_t>( st.st_size );
+
+  conn.cached = cache.get( route.filename, st.st_mtime, size );
+  if ( !conn.cached )
+  {
+#ifdef __linux__
+    conn.file_fd = ::open( route.filename.c_str(), O_RDONLY );
+    bool opened = conn.file_fd != -1;
+#else
+    conn.file.open( route.filename.c_str(), std::ios::binary );
+    bool opened = conn.file.is_open();
+#endif
+    if ( !opened )
+    {
+      http_not_found( conn.out, route.page );
+      conn.close_after = true;
+      return;
+    }
+  }
+  conn.file_remaining = conn.cached ? 0 : size;
+  conn.close_after = !keep_alive;
+
+  http_writeline( conn.out, "HTTP/1.1 200 OK" );
+  http_writeline( conn.out, "Content-Length: " + Clib::tostring( size ) );
+  http_writeline( conn.out, "Content-Type: " + content_type );
+  http_writeline( conn.out, keep_alive ? "Connection: keep-alive" : "Connection: close" );
+  http_writeline( conn.out, "" );
+}
+
+// Handles a complete request header. Returns false if the socket was handed to a script.
+bool http_handle_request( HttpConnection& conn, const std::string& header,
+                          StaticFileCache& cache, threadhelp::TaskThreadPool& script_threads )
+{
+  std::string get, auth, host, connection;
+  ISTRINGSTREAM is( header );
+  std::string tmpstr;
+  while ( getline( is, tmpstr ) )
+  {
+    if ( !tmpstr.empty() && tmpstr.back() == '\r' )
+      tmpstr.pop_back();
+    if ( Plib::systemstate.config.web_server_debug )
+      INFO_PRINTLN( "http({}): '{}'", conn.sck.handle(), tmpstr );
+    if ( strncmp( tmpstr.c_str(), "GET", 3 ) == 0 )
+      get = tmpstr;
+    else if ( strncmp( tmpstr.c_str(), "Authorization:", 14 ) == 0 )
+      auth = tmpstr;
+    else if ( strncmp( tmpstr.c_str(), "Host: ", 5 ) == 0 )
+      host = tmpstr.substr( 6 );
+    else if ( Clib::strlowerASCII( tmpstr.substr( 0, 11 ) ) == "connection:" )
+      connection = Clib::strlowerASCII( tmpstr.substr( 11 ) );
+  }
+
+  HttpRoute route;
+  if ( !http_route( conn.out, get, auth, host, route ) )
+  {
+    conn.close_after = true;
+    return true;
+  }
+
+  if ( route.pagetype == "ecl" )
+  {
+    // scripts own their socket and write blocking, same as the classic mode
+    http_set_blocking( conn.sck.handle(), true );
+    auto sck = std::make_shared<Clib::Socket>( std::move( conn.sck ) );
+    script_threads.push(
+        [sck, route]()
+        { start_http_script( *sck, route.page, route.pkg, route.filename, route.query_string ); } );
+    return false;
+  }
+
+  bool keep_alive = route.proto == "HTTP/1.1" ? connection.find( "close" ) == std::string::npos
+                                              : connection.find( "keep-alive" ) != std::string::npos;
+  if ( route.pagetype == "htm" || route.pagetype == "html" )
+  {
+    http_send_file( conn, cache, route, "text/html", keep_alive );
   }
   else
   {
-    std::string type = gamestate.mime_types[pagetype];
+    std::string type = gamestate.mime_types[route.pagetype];
     if ( type.length() > 0 )
     {
-      send_binary( sck, page, filename, type );
+      http_send_file( conn, cache, route, type, keep_alive );
     }
     else
     {
-      POLLOG_INFOLN( "HTTP server: I can't handle pagetype '{}'", pagetype );
-      http_internal_error( sck, page );
+      POLLOG_INFOLN( "HTTP server: I can't handle pagetype '{}'", route.pagetype );
+      http_internal_error( conn.out, route.page );
+      conn.close_after = true;
+    }
+  }
+  return true;
+}
+
+// Reads and answers on conn, returns false if the connection is finished
+bool http_process( HttpConnection& conn, short revents, StaticFileCache& cache,
+                   threadhelp::TaskThreadPool& script_threads )
+{
+  if ( revents & POLLIN )
+  {
+    char buffer[4096];
+    int res = ::recv( conn.sck.handle(), buffer, sizeof buffer, 0 );
+    if ( res == 0 || ( res < 0 && !http_would_block() ) )
+      return false;
+    if ( res > 0 )
+    {
+      conn.in.append( buffer, res );
+      conn.last_activity = std::chrono::steady_clock::now();
+    }
+  }
+  else if ( revents & ( POLLERR | POLLHUP | POLLNVAL ) )
+  {
+    return false;
+  }
+
+  if ( conn.pending() )
+  {
+    if ( !http_flush( conn ) )
+      return false;
+    conn.last_activity = std::chrono::steady_clock::now();
+  }
+
+  // answer the next request once the previous response is out
+  while ( !conn.pending() && !conn.close_after )
+  {
+    auto end = conn.in.find( "\r\n\r\n" );
+    size_t skip = 4;
+    if ( end == std::string::npos )
+    {
+      end = conn.in.find( "\n\n" );
+      skip = 2;
+    }
+    if ( end == std::string::npos )
+    {
+      if ( conn.in.size() > HTTP_MAX_HEADER_SIZE )
+      {
+        http_writeline( conn.out, "HTTP/1.1 431 " + reasonPhrase( 431 ) );
+        http_writeline( conn.out, "" );
+        conn.close_after = true;
+        return http_flush( conn );
+      }
+      break;
+    }
+    std::string header = conn.in.substr( 0, end );
+    conn.in.erase( 0, end + skip );
+    if ( !http_handle_request( conn, header, cache, script_threads ) )
+      return false;
+    if ( !http_flush( conn ) )
+      return false;
+  }
+  return !( conn.close_after && !conn.pending() );
+}
+
+// Non-blocking keep-alive mode, all connections are served from this thread. Only scripts are
+// started from the worker threads, since they need the PolLock.
+void http_event_loop( SOCKET http_socket )
+{
+  threadhelp::TaskThreadPool script_threads( 2, "http" );
+  StaticFileCache cache;
+  std::vector<std::unique_ptr<HttpConnection>> conns;
+  std::vector<pollfd> fds;
+  auto last_mime_check = std::chrono::steady_clock::now();
+  const std::chrono::seconds idle_timeout( Plib::systemstate.config.web_server_keep_alive_timeout );
+
+  while ( !Clib::exit_signalled )
+  {
+    fds.clear();
+    fds.push_back( pollfd{ http_socket, POLLIN, 0 } );
+    for ( const auto& conn : conns )
+      fds.push_back( pollfd{ conn->sck.handle(),
+                             static_cast<short>( conn->pending() ? POLLOUT : POLLIN ), 0 } );
+
+    int res = poll( fds.data(), static_cast<decltype( fds.size() )>( fds.size() ), 1000 );
+    if ( res < 0 && socket_errno != SOCKET_ERRNO( EINTR ) )
+    {
+      ERROR_PRINTLN( "HTTP server poll failed: {}", socket_errno );
+      break;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if ( now - last_mime_check > std::chrono::seconds( 5 ) )
+    {
+      load_mime_config();
+      last_mime_check = now;
+    }
+    // fds and conns share their index (offset by the listen socket), new connections get
+    // appended after the loop
+    for ( size_t i = 0; i < conns.size(); ++i )
+    {
+      auto& conn = conns[i];
+      bool keep = http_process( *conn, fds[i + 1].revents, cache, script_threads );
+      if ( keep && now - conn->last_activity > idle_timeout )
+      {
+        if ( Plib::systemstate.config.web_server_debug )
+          INFO_PRINTLN( "HTTP connection {} timed out", conn->sck.getpeername() );
+        keep = false;
+      }
+      if ( !keep )
+        conn.reset();
+    }
+    conns.erase( std::remove( conns.begin(), conns.end(), nullptr ), conns.end() );
+
+    if ( res > 0 && ( fds[0].revents & POLLIN ) )
+    {
+      struct sockaddr client_addr;  // inet_addr
+      socklen_t addrlen = sizeof client_addr;
+      SOCKET client_socket = accept( http_socket, &client_addr, &addrlen );
+      if ( client_socket == INVALID_SOCKET )
+        continue;
+      Network::apply_socket_options( client_socket );
+      if ( Plib::systemstate.config.web_server_debug )
+        INFO_PRINTLN( "HTTP client connected from {}",
+                      Network::AddressToString( &client_addr ) );
+
+      auto conn = std::make_unique<HttpConnection>( client_socket );
+      if ( conns.size() >= HTTP_MAX_CONNECTIONS || !http_set_blocking( client_socket, false ) )
+        continue;  // closed by the destructor
+      if ( Plib::systemstate.config.web_server_local_only && !conn->sck.is_local() )
+      {
+        http_forbidden( conn->out );
+        conn->close_after = true;
+      }
+      conns.push_back( std::move( conn ) );
     }
   }
 }
+}  // namespace
 
 
 #ifdef _WIN32
@@ -988,6 +1447,18 @@ void http_thread( void )
     ERROR_PRINTLN( "Unable to listen on socket: {}", http_socket );
     return;
   }
+  if ( Plib::systemstate.config.web_server_keep_alive )
+  {
+    http_event_loop( http_socket );
+    gamestate.mime_types.clear();  // cleanup on exit
+#ifdef _WIN32
+    closesocket( http_socket );
+#else
+    close( http_socket );
+#endif
+    return;
+  }
+
   fd_set listen_fd;
   struct timeval listen_timeout = { 0, 0 };
 
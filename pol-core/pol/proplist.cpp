@@ -10,12 +10,14 @@
 #include <stddef.h>
 
 #include "../bscript/berror.h"
+#include "../bscript/binpack.h"
 #include "../bscript/bobject.h"
 #include "../bscript/executor.h"
 #include "../bscript/impstr.h"
 #include "../bscript/objmethods.h"
 #include "../clib/cfgelem.h"
 #include "../clib/logfacility.h"
+#include "../clib/refptr.h"
 #include "../clib/stlutil.h"
 #include "../clib/streamsaver.h"
 #include "../clib/strutil.h"
@@ -27,7 +29,7 @@ namespace Pol
 {
 namespace Core
 {
-CPropProfiler::HitsCounter::HitsCounter() : hits( std::array<u64, 3>{ { 0, 0, 0 } } ) {}
+CPropProfiler::HitsCounter::HitsCounter() : hits( std::array<u64, 6>{ { 0, 0, 0, 0, 0, 0 } } ) {}
 
 u64& CPropProfiler::HitsCounter::operator[]( size_t idx )
 {
@@ -134,6 +136,29 @@ void CPropProfiler::cpropErase( const PropertyList* proplist, const std::string&
 {
   cpropAction( proplist, name, HitsCounter::ERASE );
 }
+/**
+ * Register a cprop value decode (unpack of the packed string)
+ *
+ * @param proplist Pointer to the registered list where this cprop resides
+ * @param name Name of the cprop
+ */
+void CPropProfiler::cpropDecode( const PropertyList* proplist, const std::string& name )
+{
+  cpropAction( proplist, name, HitsCounter::DECODE );
+}
+/**
+ * Register a cprop read served by the decoded value cache
+ *
+ * @param proplist Pointer to the registered list where this cprop resides
+ * @param name Name of the cprop
+ * @param packed_size Size of the packed value which did not need to be decoded
+ */
+void CPropProfiler::cpropCached( const PropertyList* proplist, const std::string& name,
+                                 size_t packed_size )
+{
+  cpropAction( proplist, name, HitsCounter::CACHED );
+  cpropAction( proplist, name, HitsCounter::SAVED_BYTES, packed_size );
+}
 
 /**
  * Registers a property list address
@@ -173,9 +198,10 @@ void CPropProfiler::unregisterProplist( const PropertyList* proplist )
  * @param proplist Pointer to the registered list where this cprop resides
  * @param name Name of the cprop
  * @param key Index of the array key to update
+ * @param amount Value to add
  */
 void CPropProfiler::cpropAction( const PropertyList* proplist, const std::string& name,
-                                 const size_t key )
+                                 const size_t key, const u64 amount )
 {
   Type type = getProplistType( proplist );
   if ( isIgnored( type ) )
@@ -184,8 +210,8 @@ void CPropProfiler::cpropAction( const PropertyList* proplist, const std::string
   {
     Clib::SpinLockGuard lock( _hitsLock );
     u64* cur = &( *_hits )[type][name][key];
-    if ( *cur < std::numeric_limits<u64>::max() )
-      ( *cur )++;
+    if ( *cur < std::numeric_limits<u64>::max() - amount )
+      ( *cur ) += amount;
   }
 }
 
@@ -212,6 +238,9 @@ void CPropProfiler::dumpProfile( std::ostream& os ) const
 
   // map<categoryname, map<typename, vector<lines> >>
   std::map<std::string, std::map<std::string, std::vector<std::string>>> outData;
+  u64 decodes = 0;
+  u64 cached = 0;
+  u64 saved_bytes = 0;
 
   {
     Clib::SpinLockGuard lock( _hitsLock );
@@ -258,7 +287,12 @@ void CPropProfiler::dumpProfile( std::ostream& os ) const
         line << pIter->first << " ";
         line << pIter->second[HitsCounter::READ] << "/";
         line << pIter->second[HitsCounter::WRITE] << "/";
-        line << pIter->second[HitsCounter::ERASE] << std::endl;
+        line << pIter->second[HitsCounter::ERASE] << "/";
+        line << pIter->second[HitsCounter::DECODE] << "/";
+        line << pIter->second[HitsCounter::CACHED] << std::endl;
+        decodes += pIter->second[HitsCounter::DECODE];
+        cached += pIter->second[HitsCounter::CACHED];
+        saved_bytes += pIter->second[HitsCounter::SAVED_BYTES];
 
         if ( !pIter->second[HitsCounter::READ] )
           outData["WRITTEN BUT NEVER READ"][typeName].push_back( line.str() );
@@ -279,7 +313,7 @@ void CPropProfiler::dumpProfile( std::ostream& os ) const
     for ( auto it2 = it1->second.begin(); it2 != it1->second.end(); ++it2 )
     {
       // 2nd level header
-      os << it2->first << " CProps summary (read/write/erase):" << std::endl;
+      os << it2->first << " CProps summary (read/write/erase/decode/cached):" << std::endl;
 
       std::sort( it2->second.begin(), it2->second.end() );
       for ( auto it3 = it2->second.begin(); it3 != it2->second.end(); ++it3 )
@@ -290,6 +324,9 @@ void CPropProfiler::dumpProfile( std::ostream& os ) const
 
     os << std::endl;
   }
+
+  os << "Decoded values: " << decodes << " decodes, " << cached
+     << " reads served from the cache, " << saved_bytes << " bytes not decoded again." << std::endl;
 }
 
 /**
@@ -334,6 +371,11 @@ PropertyList::PropertyList( CPropProfiler::Type type, bool force ) : properties(
     CPropProfiler::instance().registerProplist( this, type );
 }
 
+struct PropertyList::DecodedProps
+    : std::map<boost_utils::cprop_name_flystring, ref_ptr<Bscript::BObjectImp>>
+{
+};
+
 /**
  * Initialize by copying content and type from a given one
  */
@@ -345,10 +387,18 @@ PropertyList::PropertyList( const PropertyList& props ) : properties()
     CPropProfiler::instance().registerProplist( this, &props );
 }
 
+PropertyList::~PropertyList() = default;
+
 size_t PropertyList::estimatedSize() const
 {
   size_t size = sizeof( PropertyList );
   size += Clib::memsize( properties );
+  if ( decoded_props )
+  {
+    size += Clib::memsize( *decoded_props );
+    for ( const auto& prop : *decoded_props )
+      size += prop.second->sizeEstimate();
+  }
   return size;
 }
 
@@ -368,12 +418,62 @@ bool PropertyList::getprop( const std::string& propname, std::string& propval )
     return true;
   }
 }
+
+/**
+ * Returns the unpacked value of a property or nullptr if it does not exist.
+ * With Pol.cfg CacheCProps the decoded value is kept until the property changes, further reads
+ * return a copy of it instead of parsing the packed string again.
+ */
+Bscript::BObjectImp* PropertyList::getpropimp( const std::string& propname ) const
+{
+  const bool profile = Plib::systemstate.config.profile_cprops;
+  if ( profile )
+    CPropProfiler::instance().cpropRead( this, propname );
+
+  boost_utils::cprop_name_flystring name( propname );
+  Properties::const_iterator itr = properties.find( name );
+  if ( itr == properties.end() )
+    return nullptr;
+
+  const std::string& packed = itr->second;
+  if ( !Plib::systemstate.config.cache_cprops )
+  {
+    if ( profile )
+      CPropProfiler::instance().cpropDecode( this, propname );
+    return Bscript::BObjectImp::unpack( packed.c_str() );
+  }
+
+  if ( !decoded_props )
+    decoded_props.reset( new DecodedProps );
+  auto& decoded = ( *decoded_props )[name];
+  if ( decoded == nullptr )
+  {
+    if ( profile )
+      CPropProfiler::instance().cpropDecode( this, propname );
+    decoded.set( Bscript::BObjectImp::unpack( packed.c_str() ) );
+  }
+  else if ( profile )
+  {
+    CPropProfiler::instance().cpropCached( this, propname, packed.size() );
+  }
+  // the cached value is never handed out, scripts may modify what they get
+  return decoded->copy();
+}
+
+void PropertyList::forget_decoded( const boost_utils::cprop_name_flystring& propname )
+{
+  if ( decoded_props )
+    decoded_props->erase( propname );
+}
+
 void PropertyList::setprop( const std::string& propname, const std::string& propvalue )
 {
   if ( Plib::systemstate.config.profile_cprops )
     CPropProfiler::instance().cpropWrite( this, propname );
 
-  properties[boost_utils::cprop_name_flystring( propname )] = propvalue;
+  boost_utils::cprop_name_flystring name( propname );
+  forget_decoded( name );
+  properties[name] = propvalue;
 }
 
 void PropertyList::eraseprop( const std::string& propname )
@@ -381,7 +481,9 @@ void PropertyList::eraseprop( const std::string& propname )
   if ( Plib::systemstate.config.profile_cprops )
     CPropProfiler::instance().cpropErase( this, propname );
 
-  properties.erase( boost_utils::cprop_name_flystring( propname ) );
+  boost_utils::cprop_name_flystring name( propname );
+  forget_decoded( name );
+  properties.erase( name );
 }
 
 void PropertyList::copyprops( const PropertyList& from )
@@ -391,7 +493,10 @@ void PropertyList::copyprops( const PropertyList& from )
   if ( !properties.empty() )
   {
     for ( const auto& prop : from.properties )
+    {
+      forget_decoded( prop.first );
       properties.erase( prop.first );
+    }
   }
 
   properties.insert( from.properties.begin(), from.properties.end() );
@@ -400,6 +505,7 @@ void PropertyList::copyprops( const PropertyList& from )
 void PropertyList::clear()
 {
   properties.clear();
+  decoded_props.reset();
 }
 
 void PropertyList::getpropnames( std::vector<std::string>& propnames ) const
@@ -501,6 +607,12 @@ void PropertyList::operator-=( const std::set<std::string>& CPropNames )  // dav
   }
 }
 
+std::string pack_property( const Bscript::BObjectImp& imp )
+{
+  return Bscript::pack(
+      imp, static_cast<Bscript::PackFormat>( Plib::systemstate.config.cprop_pack_format ) );
+}
+
 Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const int id,
                                                 Bscript::Executor& ex, bool& changed )
 {
@@ -514,11 +626,11 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
     const String* propname_str;
     if ( !ex.getStringParam( 0, propname_str ) )
       return new BError( "Invalid parameter type" );
-    std::string val;
-    if ( !proplist.getprop( propname_str->value(), val ) )
+    Bscript::BObjectImp* val = proplist.getpropimp( propname_str->value() );
+    if ( val == nullptr )
       return new BError( "Property not found" );
 
-    return Bscript::BObjectImp::unpack( val.c_str() );
+    return val;
   }
 
   case MTH_SETPROP:
@@ -535,7 +647,7 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
       POLLOGLN( "wtf, setprop w/ an error '{}' PC:{}", ex.scriptname().c_str(), ex.PC );
     }
     std::string propname = propname_str->value();
-    proplist.setprop( propname, propval->pack() );
+    proplist.setprop( propname, pack_property( *propval ) );
     if ( propname[0] != '#' )
       changed = true;
     return new BLong( 1 );
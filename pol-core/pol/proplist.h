@@ -13,6 +13,7 @@
 #include <boost/flyweight.hpp>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -94,14 +95,17 @@ private:
     static const size_t READ = 0;
     static const size_t WRITE = 1;
     static const size_t ERASE = 2;
+    static const size_t DECODE = 3;
+    static const size_t CACHED = 4;
+    static const size_t SAVED_BYTES = 5;
 
     HitsCounter();
     u64& operator[]( size_t idx );
     const u64& operator[]( size_t idx ) const;
 
   private:
-    /// 0=read, 1=write, 2=erase
-    std::array<u64, 3> hits;
+    /// 0=read, 1=write, 2=erase, 3=decode, 4=read from the decoded cache, 5=bytes not decoded
+    std::array<u64, 6> hits;
   };
   typedef std::map<const PropertyList*, const Type> PropLists;
   typedef std::map<const std::string, HitsCounter> HitsEntries;
@@ -111,7 +115,8 @@ private:
 
   Type getProplistType( const PropertyList* proplist ) const;
   bool isIgnored( Type type ) const;
-  void cpropAction( const PropertyList* proplist, const std::string& name, const size_t key );
+  void cpropAction( const PropertyList* proplist, const std::string& name, const size_t key,
+                    const u64 amount = 1 );
 
   std::unique_ptr<PropLists> _proplists;
   std::unique_ptr<Hits> _hits;
@@ -122,6 +127,8 @@ public:
   void cpropRead( const PropertyList* proplist, const std::string& name );
   void cpropWrite( const PropertyList* proplist, const std::string& name );
   void cpropErase( const PropertyList* proplist, const std::string& name );
+  void cpropDecode( const PropertyList* proplist, const std::string& name );
+  void cpropCached( const PropertyList* proplist, const std::string& name, size_t packed_size );
 };
 
 
@@ -135,7 +142,9 @@ public:
   PropertyList( CPropProfiler::Type type );
   PropertyList( CPropProfiler::Type type, bool force );
   PropertyList( const PropertyList& );  // dave added 1/26/3
+  ~PropertyList();
   bool getprop( const std::string& propname, std::string& propvalue ) const;
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const PropertyList& proplist );
@@ -160,10 +169,18 @@ protected:
   Properties properties;
 
 private:
+  // decoded values of read properties, only used with Pol.cfg CacheCProps
+  struct DecodedProps;
+  mutable std::unique_ptr<DecodedProps> decoded_props;
+  void forget_decoded( const boost_utils::cprop_name_flystring& propname );
+
   // not implemented
   PropertyList& operator=( const PropertyList& ) = delete;
 };
 
+// packs a value to be stored as a property, in the format selected by CPropPackFormat
+std::string pack_property( const Bscript::BObjectImp& imp );
+
 Bscript::BObjectImp* CallPropertyListMethod( PropertyList& proplist, const char* methodname,
                                              Bscript::Executor& ex, bool& changed );
 Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const int id,
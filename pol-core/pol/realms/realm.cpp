@@ -36,7 +36,12 @@ Realm::Realm( const std::string& realm_name, const std::string& realm_path )
       _multi_count( 0 ),
       _mapserver( Plib::MapServer::Create( _descriptor ) ),
       _staticserver( new Plib::StaticServer( _descriptor ) ),
-      _maptileserver( new Plib::MapTileServer( _descriptor ) )
+      _maptileserver( new Plib::MapTileServer( _descriptor ) ),
+      _region_grids(),
+      _region_grid_width( static_cast<unsigned short>(
+          ( _descriptor.width + Core::ZONE_SIZE - 1 ) >> Core::ZONE_SHIFT ) ),
+      _region_grid_height( static_cast<unsigned short>(
+          ( _descriptor.height + Core::ZONE_SIZE - 1 ) >> Core::ZONE_SHIFT ) )
 {
   _area = Core::Range2d( Core::Pos2d( 0, 0 ),
                          Core::Pos2d( _descriptor.width - 1, _descriptor.height - 1 ), nullptr );
@@ -61,7 +66,10 @@ Realm::Realm( const std::string& realm_name, Realm* realm )
       _mobile_count( 0 ),
       _offline_count( 0 ),
       _toplevel_item_count( 0 ),
-      _multi_count( 0 )
+      _multi_count( 0 ),
+      _region_grids( realm->_region_grids ),
+      _region_grid_width( realm->_region_grid_width ),
+      _region_grid_height( realm->_region_grid_height )
 {
   _area = Core::Range2d( Core::Pos2d( 0, 0 ),
                          Core::Pos2d( _descriptor.width - 1, _descriptor.height - 1 ), nullptr );
@@ -77,6 +85,13 @@ Realm::Realm( const std::string& realm_name, Realm* realm )
     zone[i] = new Core::Zone[gridwidth];
 }
 
+void Realm::region_grid( size_t grid, Core::RegionId* data )
+{
+  if ( grid >= _region_grids.size() )
+    _region_grids.resize( grid + 1, nullptr );
+  _region_grids[grid] = data;
+}
+
 Realm::~Realm()
 {
   size_t gridheight = grid_height();
@@ -93,11 +108,13 @@ size_t Realm::sizeEstimate() const
   for ( const auto& p : gridarea() )
   {
     const auto& gzone = getzone_grid( p );
-    size += Clib::memsize( gzone.characters ) + Clib::memsize( gzone.npcs ) +
-            Clib::memsize( gzone.items ) + Clib::memsize( gzone.multis );
+    size += gzone.characters.sizeEstimate() + gzone.npcs.sizeEstimate() +
+            gzone.items.sizeEstimate() + gzone.multis.sizeEstimate() +
+            gzone.area_event_npcs.sizeEstimate() + gzone.area_event_items.sizeEstimate();
   }
 
   size += Clib::memsize( global_hulls );
+  size += Clib::memsize( _region_grids );
   size += _descriptor.sizeEstimate() + ( ( !_mapserver ) ? 0 : _mapserver->sizeEstimate() ) +
           ( ( !_staticserver ) ? 0 : _staticserver->sizeEstimate() ) +
           ( ( !_maptileserver ) ? 0 : _maptileserver->sizeEstimate() );
@@ -136,26 +153,52 @@ const std::string Realm::name() const
 
 void Realm::notify_moved( Mobile::Character& whomoved )
 {
+  // Only npcs and items whose scripts listen for area events care about movement, they are kept
+  // in separate zone lists. A listening npc that moved itself has to learn about every mobile
+  // around it (inform_imoved), in that case all mobiles are visited.
+  const bool mover_listens = whomoved.area_event_listener();
+  const bool far_move = whomoved.distance_to( whomoved.lastpos ) > 32;
+  auto notify_mobiles = [&]( const auto& pos, unsigned range )
+  {
+    if ( mover_listens )
+      Core::WorldIterator<Core::MobileFilter>::InRange(
+          pos, range,
+          [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
+    else
+      Core::WorldIterator<Core::AreaEventNPCFilter>::InRange(
+          pos, range,
+          [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
+  };
+
   // When the movement is larger than 32 tiles, notify mobiles and items in the old location
   // TODO Pos magic 32 everywhere?
   // TODO its for npcs, with ex->area_size, NPC::update_range equal the area_size?
-  if ( whomoved.distance_to( whomoved.lastpos ) > 32 )
+  if ( far_move )
   {
-    Core::WorldIterator<Core::MobileFilter>::InRange(
-        whomoved.lastpos, 32,
-        [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
+    notify_mobiles( whomoved.lastpos, 32 );
 
-    Core::WorldIterator<Core::ItemFilter>::InRange(
+    Core::WorldIterator<Core::AreaEventItemFilter>::InRange(
         whomoved.lastpos, 32, [&]( Items::Item* item ) { item->inform_moved( &whomoved ); } );
   }
 
   // Inform nearby mobiles that a movement has been made.
-  Core::WorldIterator<Core::MobileFilter>::InRange(
-      &whomoved, 33,
-      [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
+  notify_mobiles( &whomoved, 33 );
+
+  // Npcs fighting the mover want EVID_OPPONENT_MOVED, which is no area event. The listening ones
+  // were already informed above.
+  if ( !mover_listens )
+  {
+    for ( Mobile::Character* chr : whomoved.hostiles() )
+    {
+      if ( chr->area_event_listener() || !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+        continue;
+      if ( chr->in_range( &whomoved, 33 ) || ( far_move && chr->in_range( whomoved.lastpos, 32 ) ) )
+        Mobile::NpcPropagateMove( chr, &whomoved );
+    }
+  }
 
   // the same for top-level items
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventItemFilter>::InRange(
       &whomoved, 33, [&]( Items::Item* item ) { item->inform_moved( &whomoved ); } );
 }
 
@@ -163,11 +206,11 @@ void Realm::notify_moved( Mobile::Character& whomoved )
 // the other mobiles in the region that a new one appeared.
 void Realm::notify_unhid( Mobile::Character& whounhid )
 {
-  Core::WorldIterator<Core::NPCFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventNPCFilter>::InRange(
       &whounhid, 32,
       [&]( Mobile::Character* chr ) { Mobile::NpcPropagateEnteredArea( chr, &whounhid ); } );
 
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventItemFilter>::InRange(
       &whounhid, 32, [&]( Items::Item* item ) { item->inform_enteredarea( &whounhid ); } );
 }
 
@@ -190,18 +233,18 @@ void Realm::notify_entered( Mobile::Character& whoentered )
       } );
 
   // and notify the top-level items too
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventItemFilter>::InRange(
       &whoentered, 32, [&]( Items::Item* item ) { item->inform_enteredarea( &whoentered ); } );
 }
 
 // Must be used right before a mobile leaves (before updating x and y)
 void Realm::notify_left( Mobile::Character& wholeft )
 {
-  Core::WorldIterator<Core::MobileFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventNPCFilter>::InRange(
       &wholeft, 32,
       [&]( Mobile::Character* chr ) { Mobile::NpcPropagateLeftArea( chr, &wholeft ); } );
 
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::AreaEventItemFilter>::InRange(
       &wholeft, 32, [&]( Items::Item* item ) { item->inform_leftarea( &wholeft ); } );
 }
 
@@ -79,6 +79,14 @@ public:
   Core::Zone& getzone_grid( const Core::Pos2d& pos ) const;
   Core::Zone& getzone( const Core::Pos2d& p ) const;
 
+  // grids of the RegionGroups indexed by their grid index, y first with one entry per ZONE_SIZE
+  // block. Shadow realms share the grids of their base realm.
+  Core::RegionId* region_grid( size_t grid ) const;
+  void region_grid( size_t grid, Core::RegionId* data );
+  size_t region_grid_size() const;
+  Core::RegionId& regionid_grid( size_t grid, const Core::Pos2d& zone ) const;
+  Core::RegionId regionid( size_t grid, const Core::Pos2d& p ) const;
+
   unsigned season() const;
 
   bool valid( const Core::Pos2d& p ) const;
@@ -197,6 +205,9 @@ private:
   Core::Zone** zone;  // y first
   Core::Range2d _area;
   Core::Range2d _gridarea;
+  std::vector<Core::RegionId*> _region_grids;
+  unsigned short _region_grid_width;
+  unsigned short _region_grid_height;
 
 public:
   size_t sizeEstimate() const;
@@ -283,6 +294,24 @@ inline Core::Zone& Realm::getzone( const Core::Pos2d& p ) const
   return getzone_grid( Core::Pos2d( p.x() >> Plib::WGRID_SHIFT, p.y() >> Plib::WGRID_SHIFT ) );
 }
 
+inline Core::RegionId* Realm::region_grid( size_t grid ) const
+{
+  return grid < _region_grids.size() ? _region_grids[grid] : nullptr;
+}
+inline size_t Realm::region_grid_size() const
+{
+  return static_cast<size_t>( _region_grid_width ) * _region_grid_height;
+}
+inline Core::RegionId& Realm::regionid_grid( size_t grid, const Core::Pos2d& zone ) const
+{
+  return _region_grids[grid][zone.y() * _region_grid_width + zone.x()];
+}
+inline Core::RegionId Realm::regionid( size_t grid, const Core::Pos2d& p ) const
+{
+  return regionid_grid(
+      grid, Core::Pos2d( p.x() >> Core::ZONE_SHIFT, p.y() >> Core::ZONE_SHIFT ) );
+}
+
 
 }  // namespace Realms
 }  // namespace Pol
@@ -0,0 +1,86 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "realmtask.h"
+
+#include <exception>
+#include <future>
+
+#include "../globals/uvars.h"
+#include "realm.h"
+
+namespace Pol
+{
+namespace Realms
+{
+void DeferredActions::push( std::function<void()> action )
+{
+  _actions.push_back( std::move( action ) );
+}
+
+void DeferredActions::run()
+{
+  // an action may push new ones, which can reallocate the vector while it is called
+  for ( size_t i = 0; i < _actions.size(); ++i )
+  {
+    auto action = std::move( _actions[i] );
+    action();
+  }
+  _actions.clear();
+}
+
+bool DeferredActions::empty() const
+{
+  return _actions.empty();
+}
+
+void for_each_realm_parallel( const std::function<void( Realm*, DeferredActions& )>& task )
+{
+  const auto& realms = Core::gamestate.Realms;
+  std::vector<DeferredActions> deferred( realms.size() );
+
+  if ( realms.size() < 2 || Core::gamestate.realm_thread_pool.size() < 2 )
+  {
+    for ( size_t i = 0; i < realms.size(); ++i )
+      task( realms[i], deferred[i] );
+  }
+  else
+  {
+    std::vector<std::future<bool>> parts;
+    parts.reserve( realms.size() );
+    for ( size_t i = 0; i < realms.size(); ++i )
+    {
+      parts.push_back( Core::gamestate.realm_thread_pool.checked_push(
+          [&, i]() { task( realms[i], deferred[i] ); } ) );
+    }
+    // every task has to be finished before the first exception is passed on, they reference
+    // the local state
+    std::exception_ptr error;
+    for ( auto& part : parts )
+    {
+      try
+      {
+        part.get();
+      }
+      catch ( ... )
+      {
+        if ( !error )
+          error = std::current_exception();
+      }
+    }
+    if ( error )
+    {
+      for ( auto& actions : deferred )
+        actions.run();
+      std::rethrow_exception( error );
+    }
+  }
+
+  for ( auto& actions : deferred )
+    actions.run();
+}
+}  // namespace Realms
+}  // namespace Pol
@@ -0,0 +1,48 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef REALMS_REALMTASK_H
+#define REALMS_REALMTASK_H
+
+#include <functional>
+#include <vector>
+
+namespace Pol
+{
+namespace Realms
+{
+class Realm;
+
+/**
+ * Effects of a realm task which reach outside of its realm.
+ * Client sends, script calls and changes to the world are collected here and executed after all
+ * realm tasks are finished.
+ */
+class DeferredActions
+{
+public:
+  void push( std::function<void()> action );
+  void run();
+  bool empty() const;
+
+private:
+  std::vector<std::function<void()>> _actions;
+};
+
+/**
+ * Runs task once per realm, the realms are processed concurrently on the realm_thread_pool.
+ * Must be called with the PolLock held, returns after every realm is finished and the deferred
+ * actions of all realms are executed in realm order on the calling thread.
+ * The realm_thread_pool is reserved for this function, the PolLock is never held while waiting
+ * behind unrelated work like saves or house design compression.
+ *
+ * A task is only allowed to access the zones of its realm, the objects listed in them and
+ * read only global state. Everything else has to be pushed into the DeferredActions.
+ */
+void for_each_realm_parallel( const std::function<void( Realm*, DeferredActions& )>& task );
+}  // namespace Realms
+}  // namespace Pol
+#endif
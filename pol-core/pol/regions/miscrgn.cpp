@@ -73,60 +73,31 @@ size_t WeatherRegion::estimateSize() const
          + sizeof( int );                                   /*lightoverride*/
 }
 
-WeatherDef::WeatherDef( const char* name ) : RegionGroup<WeatherRegion>( name )
+WeatherDef::WeatherDef( const char* name )
+    : RegionGroup<WeatherRegion>( name ), default_regions_()
 {
-  for ( auto const& realm : gamestate.Realms )
-  {
-    unsigned int gridwidth = realm->width() / ZONE_SIZE;
-    unsigned int gridheight = realm->height() / ZONE_SIZE;
-
-    RegionId** zone = new RegionId*[gridheight];
-
-    for ( unsigned int i = 0; i < gridheight; i++ )
-    {
-      zone[i] = new RegionId[gridwidth];
-      for ( unsigned int j = 0; j < gridwidth; j++ )
-      {
-        zone[i][j] = 0;
-      }
-    }
-    default_regionrealms.insert( std::make_pair( realm, zone ) );
-  }
-}
-
-WeatherDef::~WeatherDef()
-{
-  for ( auto& realmregion : default_regionrealms )
-  {
-    unsigned int gridheight = realmregion.first->height() / ZONE_SIZE;
-
-    for ( unsigned int i = 0; i < gridheight; i++ )
-      delete[] realmregion.second[i];
-    delete[] realmregion.second;
-  }
 }
 
 size_t WeatherDef::estimateSize() const
 {
   size_t size = RegionGroup<WeatherRegion>::estimateSize();
-  size += Clib::memsize( default_regionrealms );
-
-  for ( const auto& realm : default_regionrealms )
-  {
-    unsigned int gridheight = realm.first->height() / ZONE_SIZE;
-    size += gridheight * sizeof( RegionId );
-  }
+  size += Clib::memsize( default_regions_ );
+  for ( const auto& realmregion : default_regions_ )
+    size += Clib::memsize( realmregion.second );
   return size;
 }
 
 void WeatherDef::copy_default_regions()
 {
-  for ( auto& realmregion : regionrealms )
+  for ( const auto& realm : gamestate.Realms )
   {
-    Realms::Realm* realm = realmregion.first;
+    if ( realm->is_shadowrealm )
+      continue;
     Range2d area = Range2d( Pos2d( 0, 0 ), XyToZone( realm->area().se() ), nullptr );
+    auto& defaults = default_regions_[realm];
+    defaults.clear();
     for ( const auto& p : area )
-      default_regionrealms[realm][p.y()][p.x()] = regionrealms[realm][p.y()][p.x()];
+      defaults.push_back( regionid_grid( realm, p ) );
   }
 }
 
@@ -141,12 +112,16 @@ bool WeatherDef::assign_zones_to_region( const char* regionname, const Range2d&
       return false;
 
     for ( const auto& p : zone_area )
-      regionrealms[realm][p.y()][p.x()] = rgn->regionid();
+      regionid_grid( realm, p ) = rgn->regionid();
   }
   else  // move 'em back to the default
   {
+    if ( realm->is_shadowrealm )
+      realm = realm->baserealm;
+    const auto& defaults = default_regions_[realm];
+    const auto width = XyToZone( realm->area().se() ).x() + 1u;
     for ( const auto& p : zone_area )
-      regionrealms[realm][p.y()][p.x()] = default_regionrealms[realm][p.y()][p.x()];
+      regionid_grid( realm, p ) = defaults[p.y() * width + p.x()];
   }
   update_all_weatherregions();
   return true;
@@ -7,6 +7,8 @@
 #ifndef MISCRGN_H
 #define MISCRGN_H
 
+#include <map>
+#include <vector>
 
 #include "base/range.h"
 #include "regions/region.h"
@@ -76,14 +78,14 @@ class WeatherDef final : public RegionGroup<WeatherRegion>
 {
 public:
   WeatherDef( const char* name );
-  virtual ~WeatherDef();
   void copy_default_regions();
   virtual size_t estimateSize() const override;
 
   bool assign_zones_to_region( const char* regionname, const Range2d& area, Realms::Realm* realm );
 
 private:
-  RegionRealms default_regionrealms;  // y first
+  // regions as read from the config per base realm, y first
+  std::map<Realms::Realm*, std::vector<RegionId>> default_regions_;
 };
 }  // namespace Core
 }  // namespace Pol
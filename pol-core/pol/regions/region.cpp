@@ -7,8 +7,10 @@
 
 #include "region.h"
 
+#include <algorithm>
 #include <stddef.h>
 #include <string>
+#include <vector>
 
 #include "bscript/berror.h"
 #include "bscript/impstr.h"
@@ -29,6 +31,12 @@ namespace Pol
 {
 namespace Core
 {
+namespace
+{
+// RegionGroups by their grid index, freed slots get reused
+std::vector<RegionGroupBase*> registered_groups;
+}  // namespace
+
 Region::Region( Clib::ConfigElem& elem, RegionId id )
     : name_( elem.rest() ), regionid_( id ), proplist_( Core::CPropProfiler::Type::REGION )
 {
@@ -53,40 +61,33 @@ Bscript::BObjectImp* Region::get_region_string( const std::string& propname )
 }
 
 
-RegionGroupBase::RegionGroupBase( const char* name ) : name_( name )
+RegionGroupBase::RegionGroupBase( const char* name ) : name_( name ), grid_index_( 0 ), grids_()
 {
+  auto slot = std::find( registered_groups.begin(), registered_groups.end(), nullptr );
+  if ( slot == registered_groups.end() )
+    slot = registered_groups.insert( slot, nullptr );
+  *slot = this;
+  grid_index_ = static_cast<size_t>( slot - registered_groups.begin() );
+
+  // shadow realms share the grid of their base realm, which needs to exist first
   for ( const auto& realm : gamestate.Realms )
   {
-    unsigned int gridwidth = realm->width() / ZONE_SIZE;
-    unsigned int gridheight = realm->height() / ZONE_SIZE;
-
-    RegionId** zone = new RegionId*[gridheight];
-
-    for ( unsigned int i = 0; i < gridheight; i++ )
-    {
-      zone[i] = new RegionId[gridwidth];
-      for ( unsigned int j = 0; j < gridwidth; j++ )
-      {
-        zone[i][j] = 0;
-      }
-    }
-    regionrealms.insert( std::make_pair( realm, zone ) );
+    if ( realm->is_shadowrealm )
+      continue;
+    grids_.emplace_back( realm->region_grid_size(), static_cast<RegionId>( 0 ) );
+    realm->region_grid( grid_index_, grids_.back().data() );
+  }
+  for ( const auto& realm : gamestate.Realms )
+  {
+    if ( realm->is_shadowrealm )
+      realm->region_grid( grid_index_, realm->baserealm->region_grid( grid_index_ ) );
   }
 }
 RegionGroupBase::~RegionGroupBase()
 {
-  for ( auto& realm : regionrealms )
-  {
-    unsigned int gridheight = realm.first->height() / ZONE_SIZE;
-
-    // Tokuno-Fix removed Turley, 2009/09/08 (for ZONE_SIZE 4 not needed)
-    /*if (gridwidth * ZONE_SIZE < itr->first->width())
-      gridwidth++;*/
-
-    for ( unsigned int i = 0; i < gridheight; i++ )
-      delete[] realm.second[i];
-    delete[] realm.second;
-  }
+  for ( const auto& realm : gamestate.Realms )
+    realm->region_grid( grid_index_, nullptr );
+  registered_groups[grid_index_] = nullptr;
 
   // cleans the regions_ vector...
   for ( auto& region : regions_ )
@@ -118,7 +119,7 @@ void RegionGroupBase::paint_zones( Clib::ConfigElem& elem, RegionId ridx )
       Range2d area( XyToZone( Pos2d( xwest, ynorth ) ), XyToZone( Pos2d( xeast, ysouth ) ),
                     nullptr );
       for ( const auto& itr : area )
-        regionrealms[realm][itr.y()][itr.x()] = ridx;
+        regionid_grid( realm, itr ) = ridx;
     }
     else
     {
@@ -127,15 +128,9 @@ void RegionGroupBase::paint_zones( Clib::ConfigElem& elem, RegionId ridx )
   }
 }
 
-RegionId RegionGroupBase::getregionid( const Pos4d& pos )
+RegionId& RegionGroupBase::regionid_grid( Realms::Realm* realm, const Pos2d& zone )
 {
-  Pos2d zonep = XyToZone( pos.xy() );
-  RegionId** regiongrp;
-  if ( pos.realm()->is_shadowrealm )
-    regiongrp = regionrealms[pos.realm()->baserealm];
-  else
-    regiongrp = regionrealms[pos.realm()];
-  return regiongrp[zonep.y()][zonep.x()];
+  return realm->regionid_grid( grid_index_, zone );
 }
 
 Region* RegionGroupBase::getregion_byname( const std::string& regionname )
@@ -148,11 +143,10 @@ Region* RegionGroupBase::getregion_byname( const std::string& regionname )
 
 Region* RegionGroupBase::getregion_byloc( const Pos4d& pos )
 {
-  RegionId ridx = getregionid( pos );
+  RegionId ridx = pos.realm()->regionid( grid_index_, pos.xy() );
 
   // dave 12-22 return null if no regions, don't throw
-  std::vector<Region*>::iterator itr = regions_.begin();
-  if ( ( itr += ridx ) >= regions_.end() )
+  if ( ridx >= regions_.size() )
     return nullptr;
   return regions_[ridx];
 }
@@ -183,14 +177,9 @@ size_t RegionGroupBase::estimateSize() const
   {
     size += region->estimateSize();
   }
-  size += Clib::memsize( regionrealms );
-  for ( const auto& realm : regionrealms )
-  {
-    if ( realm.first == nullptr )
-      continue;
-    unsigned int gridheight = realm.first->height() / ZONE_SIZE;
-    size += gridheight * sizeof( RegionId );
-  }
+  size += Clib::memsize( grids_ );
+  for ( const auto& grid : grids_ )
+    size += Clib::memsize( grid );
   size += name_.capacity();
   size += Clib::memsize( regions_byname_ );
   return size;
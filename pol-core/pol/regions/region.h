@@ -82,18 +82,18 @@ public:
 protected:
   Region* getregion_byname( const std::string& regionname );
   Region* getregion_byloc( const Pos4d& pos );
+  RegionId& regionid_grid( Realms::Realm* realm, const Pos2d& zone );
 
   std::vector<Region*> regions_;
 
-  typedef std::map<Realms::Realm*, RegionId**> RegionRealms;
-  RegionRealms regionrealms;  // y first
-
 private:
   virtual Region* create_region( Clib::ConfigElem& elem, RegionId id ) const = 0;
 
-  RegionId getregionid( const Pos4d& pos );
   void paint_zones( Clib::ConfigElem& elem, RegionId ridx );
   std::string name_;
+  // index of the grids in Realm::region_grid, the grids of the base realms are owned here
+  size_t grid_index_;
+  std::vector<std::vector<RegionId>> grids_;
   typedef std::map<std::string, Region*> RegionsByName;
   RegionsByName regions_byname_;
 };
@@ -7,11 +7,20 @@
 
 #include "savedata.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <exception>
 #include <filesystem>
 #include <fstream>
 #include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "../clib/Debugging/ExceptionParser.h"
 #include "../clib/Program/ProgramConfig.h"
@@ -57,6 +66,9 @@ namespace Core
 void write_party( Clib::StreamWriter& sw );
 void write_guilds( Clib::StreamWriter& sw );
 
+// size at which the part next in line hands its buffer to the file, same as a file flushes
+const size_t STREAM_PART_SIZE = 0x8000;
+
 std::shared_future<void> SaveContext::finished;
 std::atomic<gameclock_t> SaveContext::last_worldsave_success = 0;
 
@@ -73,7 +85,8 @@ SaveContext::SaveContext()
       resource( Plib::systemstate.config.world_data_path + "resource.ndt" ),
       guilds( Plib::systemstate.config.world_data_path + "guilds.ndt" ),
       datastore( Plib::systemstate.config.world_data_path + "datastore.ndt" ),
-      party( Plib::systemstate.config.world_data_path + "parties.ndt" )
+      party( Plib::systemstate.config.world_data_path + "parties.ndt" ),
+      max_part_buffer( 16 * 1024 * 1024 )
 {
   pcs.comment( "" );
   pcs.comment( " PCS.TXT: Player-Character Data" );
@@ -167,6 +180,105 @@ SaveContext::~SaveContext() noexcept( false )
   }
 }
 
+SaveContext::SaveStrategy& SaveContext::add_part( SaveStrategy& file )
+{
+  auto part = std::make_unique<Part>();
+  part->file = &file;
+  part->buffer = std::make_unique<SaveStrategy>();
+  part->state = Part::State::Filling;
+  part->buffer->set_buffer_handler(
+      STREAM_PART_SIZE, [this, p = part.get()]( SaveStrategy& ) { part_buffered( *p ); } );
+  std::lock_guard<std::mutex> lock( _parts_mutex );
+  _parts.push_back( std::move( part ) );
+  return *_parts.back()->buffer;
+}
+
+// true if all earlier parts of its file are written, needs _parts_mutex
+bool SaveContext::is_next( const Part& part ) const
+{
+  for ( const auto& other : _parts )
+  {
+    if ( other->file == part.file && other->state != Part::State::Written )
+      return other.get() == &part;
+  }
+  return false;
+}
+
+// called by the filling save task whenever the buffer of its part grew past its limit
+void SaveContext::part_buffered( Part& part )
+{
+  std::unique_lock<std::mutex> lock( _parts_mutex );
+  if ( !is_next( part ) )
+  {
+    if ( part.buffer->buffered() < max_part_buffer )
+    {
+      part.buffer->set_buffer_limit( std::min( 2 * part.buffer->buffered(), max_part_buffer ) );
+      return;
+    }
+    // the earlier parts were queued first, so their tasks are already running
+    _parts_cv.wait( lock, [&]() { return is_next( part ); } );
+  }
+  part.buffer->set_buffer_limit( STREAM_PART_SIZE );
+  part.buffer->move_to( *part.file );
+}
+
+void SaveContext::finish_part( SaveStrategy& buffer )
+{
+  std::lock_guard<std::mutex> lock( _parts_mutex );
+  auto itr = std::find_if( _parts.begin(), _parts.end(),
+                           [&]( const auto& part ) { return part->buffer.get() == &buffer; } );
+  if ( itr == _parts.end() )
+    return;  // not sharded, the task wrote into the file itself
+  ( *itr )->state = Part::State::Finished;
+  try
+  {
+    write_finished_parts( *( *itr )->file );
+  }
+  catch ( ... )
+  {
+    _parts_cv.notify_all();
+    throw;
+  }
+  _parts_cv.notify_all();
+}
+
+// appends the finished parts at the front of file, needs _parts_mutex
+void SaveContext::write_finished_parts( SaveStrategy& file )
+{
+  std::exception_ptr error;
+  for ( auto& part : _parts )
+  {
+    if ( part->file != &file || part->state == Part::State::Written )
+      continue;
+    if ( part->state != Part::State::Finished )
+      break;
+    // marked first, a failed write must not block the following parts
+    part->state = Part::State::Written;
+    try
+    {
+      part->buffer->move_to( file );
+    }
+    catch ( ... )
+    {
+      if ( !error )
+        error = std::current_exception();
+    }
+    part->buffer.reset();  // free the memory early
+  }
+  if ( error )
+    std::rethrow_exception( error );
+}
+
+void SaveContext::write_parts()
+{
+  std::lock_guard<std::mutex> lock( _parts_mutex );
+  for ( auto& part : _parts )
+    part->state = part->state == Part::State::Filling ? Part::State::Finished : part->state;
+  for ( auto& part : _parts )
+    write_finished_parts( *part->file );
+  _parts.clear();
+}
+
 /// blocks till possible last commit finishes
 void SaveContext::ready()
 {
@@ -229,76 +341,66 @@ void WriteGottenItem( Mobile::Character* chr, Items::Item* item, Clib::StreamWri
              item->realm() ) );  // TODO POS position should have no meaning remove this completely
 }
 
-void write_characters( Core::SaveContext& sc )
+void write_characters( const std::vector<Mobile::Character*>& chrs, Clib::StreamWriter& sw,
+                       Clib::StreamWriter& sw_equip )
 {
-  for ( const auto& objitr : objStorageManager.objecthash )
+  for ( const auto& chr : chrs )
   {
-    UObject* obj = objitr.second.get();
-    if ( obj->ismobile() && !obj->orphan() )
-    {
-      Mobile::Character* chr = static_cast<Mobile::Character*>( obj );
-      if ( !chr->isa( UOBJ_CLASS::CLASS_NPC ) )
-      {
-        chr->printOn( sc.pcs );
-        chr->clear_dirty();
-        chr->printWornItems( sc.pcs, sc.pcequip );
-      }
-    }
+    chr->printOn( sw );
+    chr->clear_dirty();
+    chr->printWornItems( sw, sw_equip );
   }
 }
 
-void write_npcs( Core::SaveContext& sc )
+void write_items( const std::vector<Zone*>& zones, Clib::StreamWriter& sw_items )
 {
-  for ( const auto& objitr : objStorageManager.objecthash )
+  for ( const auto& zone : zones )
   {
-    UObject* obj = objitr.second.get();
-    if ( obj->ismobile() && !obj->orphan() )
+    for ( const auto& item : zone->items )
     {
-      Mobile::Character* chr = static_cast<Mobile::Character*>( obj );
-      if ( chr->isa( UOBJ_CLASS::CLASS_NPC ) )
+      if ( item->itemdesc().save_on_exit && item->saveonexit() )
       {
-        if ( chr->saveonexit() )
-        {
-          chr->printOn( sc.npcs );
-          chr->clear_dirty();
-          chr->printWornItems( sc.npcs, sc.npcequip );
-        }
+        item->printOn( sw_items );
+        item->clear_dirty();
       }
     }
   }
 }
 
-void write_items( Clib::StreamWriter& sw_items )
+void write_gotten_items( const std::vector<Mobile::Character*>& pcs, Clib::StreamWriter& sw_items )
 {
-  for ( const auto& realm : gamestate.Realms )
+  for ( const auto& chr : pcs )
   {
-    for ( const auto& p : realm->gridarea() )
-    {
-      for ( const auto& item : realm->getzone_grid( p ).items )
-      {
-        if ( item->itemdesc().save_on_exit && item->saveonexit() )
-        {
-          item->printOn( sw_items );
-          item->clear_dirty();
-        }
-      }
-    }
+    // Figure out where to save the 'gotten item' - Austin (Oct. 17, 2006)
+    if ( chr->has_gotten_item() )
+      WriteGottenItem( chr, chr->gotten_item().item(), sw_items );
   }
+}
 
-  for ( const auto& objitr : objStorageManager.objecthash )
+// Splits [0,weights.size()) into at most count consecutive ranges of roughly equal weight.
+// Formatting the ranges separately and concatenating them in order gives the sequential output.
+std::vector<std::pair<size_t, size_t>> split_shards( const std::vector<size_t>& weights,
+                                                     size_t count )
+{
+  std::vector<std::pair<size_t, size_t>> shards;
+  size_t total = 0;
+  for ( const auto& weight : weights )
+    total += weight;
+  count = std::max<size_t>( count, 1 );
+  size_t begin = 0;
+  size_t sum = 0;
+  for ( size_t i = 0; i < weights.size(); ++i )
   {
-    UObject* obj = objitr.second.get();
-    if ( obj->ismobile() && !obj->orphan() )
+    sum += weights[i];
+    if ( sum * count >= total * ( shards.size() + 1 ) && shards.size() + 1 < count )
     {
-      Mobile::Character* chr = static_cast<Mobile::Character*>( obj );
-      if ( !chr->isa( UOBJ_CLASS::CLASS_NPC ) )
-      {
-        // Figure out where to save the 'gotten item' - Austin (Oct. 17, 2006)
-        if ( chr->has_gotten_item() )
-          WriteGottenItem( chr, chr->gotten_item().item(), sw_items );
-      }
+      shards.emplace_back( begin, i + 1 );
+      begin = i + 1;
     }
   }
+  if ( begin < weights.size() || shards.empty() )
+    shards.emplace_back( begin, weights.size() );
+  return shards;
 }
 
 void write_multis( Clib::StreamWriter& ofs )
@@ -360,6 +462,308 @@ bool commit( const std::string& basename )
   return true;
 }
 
+// Queues the formatting of all world files except accounts and datastore. The big files are
+// formatted in shards, each into its own in memory part, which SaveContext appends to the files in
+// order. The output is the same as formatting them sequentially.
+void save_world( SaveContext& sc, size_t shard_count, const SaveTask& save )
+{
+  auto part = [&]( Clib::StreamWriter& file ) -> Clib::StreamWriter*
+  { return shard_count > 1 ? &sc.add_part( file ) : &file; };
+  // queues func, the parts are finished even if it failed so that the following ones get written
+  auto save_parts = [&]( std::vector<Clib::StreamWriter*> outs, std::function<void()> func,
+                         std::string name )
+  {
+    save(
+        [&sc, outs = std::move( outs ), func = std::move( func )]()
+        {
+          auto finish = [&]()
+          {
+            for ( auto out : outs )
+              sc.finish_part( *out );
+          };
+          try
+          {
+            func();
+          }
+          catch ( ... )
+          {
+            finish();
+            throw;
+          }
+          finish();
+        },
+        std::move( name ) );
+  };
+
+  std::vector<Zone*> zones;
+  std::vector<size_t> zone_weights;
+  for ( const auto& realm : gamestate.Realms )
+  {
+    for ( const auto& p : realm->gridarea() )
+    {
+      Zone& zone = realm->getzone_grid( p );
+      if ( zone.items.empty() )
+        continue;
+      zones.push_back( &zone );
+      zone_weights.push_back( zone.items.size() );
+    }
+  }
+  std::vector<Mobile::Character*> pcs;
+  std::vector<Mobile::Character*> npcs;
+  for ( const auto& objitr : objStorageManager.objecthash )
+  {
+    UObject* obj = objitr.second.get();
+    if ( obj->ismobile() && !obj->orphan() )
+    {
+      Mobile::Character* chr = static_cast<Mobile::Character*>( obj );
+      if ( !chr->isa( UOBJ_CLASS::CLASS_NPC ) )
+        pcs.push_back( chr );
+      else if ( chr->saveonexit() )
+        npcs.push_back( chr );
+    }
+  }
+  auto save_characters = [&]( const std::vector<Mobile::Character*>& chrs, Clib::StreamWriter& sw,
+                              Clib::StreamWriter& sw_equip, const std::string& name )
+  {
+    for ( const auto& [begin, end] :
+          split_shards( std::vector<size_t>( chrs.size(), 1 ), shard_count ) )
+    {
+      auto out = part( sw );
+      auto out_equip = part( sw_equip );
+      save_parts(
+          { out, out_equip },
+          [out, out_equip,
+           shard = std::vector<Mobile::Character*>( chrs.begin() + begin, chrs.begin() + end )]()
+          { write_characters( shard, *out, *out_equip ); },
+          name );
+    }
+  };
+
+  // ordered roughly by "usual" size, so that the biggest files will be written first
+  for ( const auto& [begin, end] : split_shards( zone_weights, shard_count ) )
+  {
+    auto out = part( sc.items );
+    save_parts(
+        { out },
+        [out, shard = std::vector<Zone*>( zones.begin() + begin, zones.begin() + end )]()
+        { write_items( shard, *out ); },
+        "items" );
+  }
+  auto gotten_out = part( sc.items );
+  save_parts(
+      { gotten_out }, [gotten_out, pcs]() { write_gotten_items( pcs, *gotten_out ); }, "items" );
+  const auto storage_entries = gamestate.storage.print_entries();
+  for ( const auto& [begin, end] :
+        split_shards( std::vector<size_t>( storage_entries.size(), 1 ), shard_count ) )
+  {
+    auto out = part( sc.storage );
+    save_parts(
+        { out },
+        [out, shard = std::vector<Storage::PrintEntry>( storage_entries.begin() + begin,
+                                                        storage_entries.begin() + end )]()
+        { Storage::print( *out, shard ); },
+        "storage" );
+  }
+  save_characters( pcs, sc.pcs, sc.pcequip, "character" );
+  save_characters( npcs, sc.npcs, sc.npcequip, "npcs" );
+  save(
+      [&]()
+      {
+        sc.pol.comment( "" );
+        sc.pol.comment( " Created by Version: {}", POL_VERSION_ID );
+        sc.pol.comment( " Mobiles: {}", get_mobile_count() );
+        sc.pol.comment( " Top-level Items: {}", get_toplevel_item_count() );
+        sc.pol.comment( "\n" );
+
+        write_system_data( sc.pol );
+        write_global_properties( sc.pol );
+        write_realms( sc.pol );
+      },
+      "pol" );
+  save( [&]() { write_multis( sc.multis ); }, "multis" );
+  save( [&]() { write_resources_dat( sc.resource ); }, "resource" );
+  save( [&]() { write_guilds( sc.guilds ); }, "guilds" );
+  save( [&]() { write_party( sc.party ); }, "party" );
+}
+
+void save_accounts()
+{
+  if ( Plib::systemstate.accounts_txt_dirty )
+    Accounts::write_account_data();
+}
+
+void save_datastore( Clib::StreamWriter& sw )
+{
+  Module::write_datastore( sw );
+  // Atomically (hopefully) perform the switch.
+  Module::commit_datastore();
+}
+
+#ifndef _WIN32
+namespace
+{
+struct SnapshotReport
+{
+  bool result;
+  unsigned int dirty_writes;
+  unsigned int clean_writes;
+};
+
+// The child inherits every descriptor of the server. Listening and client sockets would stay open
+// until it exits, so connections closed by the server would not be closed. Only stdio and the
+// report pipe are kept, the data files are opened afterwards.
+void close_inherited_fds( int keep )
+{
+  std::vector<int> fds;
+  try
+  {
+    for ( const auto& entry : fs::directory_iterator( "/proc/self/fd" ) )
+      fds.push_back( std::stoi( entry.path().filename().string() ) );
+  }
+  catch ( ... )
+  {
+    // no procfs, try every possible descriptor
+    fds.clear();
+    const long max_fd = sysconf( _SC_OPEN_MAX );
+    for ( long fd = STDERR_FILENO + 1; fd < max_fd; ++fd )
+    {
+      if ( fd != keep )
+        ::close( static_cast<int>( fd ) );
+    }
+  }
+  for ( const auto& fd : fds )
+  {
+    if ( fd > STDERR_FILENO && fd != keep )
+      ::close( fd );
+  }
+}
+
+// Runs in the forked child: writes the world files from the copy on write snapshot of the
+// process. Only the forking thread exists in the child, every lock another thread held at the
+// time of the fork stays locked forever. So everything runs inline without the task thread pool,
+// errors are sent to the parent and the log worker is never used: without a logger, log messages
+// of the save code go to stdout. The memory allocator of glibc is fork safe.
+[[noreturn]] void write_snapshot( const Clib::StreamWriter& datastore, int fd )
+{
+  Clib::Logging::global_logger = nullptr;
+  close_inherited_fds( fd );
+
+  bool result = true;
+  std::string errors;
+  auto save = [&]( std::function<void()> func, std::string name )
+  {
+    try
+    {
+      func();
+    }
+    catch ( const std::exception& error )
+    {
+      errors += fmt::format( "failed to store {} datafile! {}\n", name, error.what() );
+      result = false;
+    }
+    catch ( ... )
+    {
+      errors += fmt::format( "failed to store {} datafile!\n", name );
+      result = false;
+    }
+  };
+  try
+  {
+    SaveContext sc;
+    sc.datastore.append( datastore );
+    save_world( sc, 1, save );
+  }  // deconstructor of the SaveContext flushes
+  catch ( const std::exception& error )
+  {
+    errors +=
+        fmt::format( "failed to save datafiles! {}:{}\n", error.what(), std::strerror( errno ) );
+    result = false;
+  }
+  catch ( ... )
+  {
+    errors += "failed to save datafiles!\n";
+    result = false;
+  }
+
+  SnapshotReport report{ result, UObject::dirty_writes, UObject::clean_writes };
+  auto send = [fd]( const void* data, size_t size )
+  {
+    auto ptr = static_cast<const char*>( data );
+    while ( size > 0 )
+    {
+      auto written = ::write( fd, ptr, size );
+      if ( written < 0 )
+      {
+        if ( errno == EINTR )
+          continue;
+        return;
+      }
+      ptr += written;
+      size -= written;
+    }
+  };
+  send( &report, sizeof( report ) );
+  send( errors.data(), errors.size() );
+  ::close( fd );
+  // skip any cleanup, the threads and state of the parent do not exist here
+  _exit( result ? 0 : 1 );
+}
+
+// The child clears the dirty flags of its copy only, the parent clears its own after the fork while
+// the world is still locked. The statistics are reported by the child.
+void clear_dirty_flags()
+{
+  for ( const auto& objitr : objStorageManager.objecthash )
+    objitr.second->clear_dirty();
+  UObject::dirty_writes = 0;
+  UObject::clean_writes = 0;
+}
+
+// Waits for the snapshot child and takes over its statistics.
+bool wait_snapshot( pid_t pid, int fd )
+{
+  std::string data;
+  char buffer[4096];
+  for ( ;; )
+  {
+    auto len = ::read( fd, buffer, sizeof( buffer ) );
+    if ( len < 0 && errno == EINTR )
+      continue;
+    if ( len <= 0 )
+      break;
+    data.append( buffer, len );
+  }
+  ::close( fd );
+  int status = 0;
+  while ( waitpid( pid, &status, 0 ) < 0 )
+  {
+    if ( errno != EINTR )
+    {
+      POLLOG_ERRORLN( "failed to wait for the snapshot save: {}", std::strerror( errno ) );
+      return false;
+    }
+  }
+
+  SnapshotReport report{ false, 0, 0 };
+  if ( data.size() >= sizeof( report ) )
+  {
+    memcpy( &report, data.data(), sizeof( report ) );
+    data.erase( 0, sizeof( report ) );
+    UObject::dirty_writes = report.dirty_writes;
+    UObject::clean_writes = report.clean_writes;
+  }
+  if ( !data.empty() )
+    POLLOG_ERROR( "snapshot save: {}", data );
+  if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+  {
+    POLLOG_ERRORLN( "snapshot save process failed with status {}", status );
+    return false;
+  }
+  return report.result;
+}
+}  // namespace
+#endif
+
 std::optional<bool> write_data( std::function<void( bool, u32, u32, s64 )> callback,
                                 u32* dirty_writes, u32* clean_writes, s64* elapsed_ms )
 {
@@ -369,6 +773,10 @@ std::optional<bool> write_data( std::function<void( bool, u32, u32, s64 )> callb
 
   UObject::dirty_writes = 0;
   UObject::clean_writes = 0;
+  // the statistics of a snapshot save are only known after the child reported, callers which need
+  // them right away save in process
+  const bool snapshot = Plib::systemstate.config.snapshot_saves && !Clib::exit_signalled &&
+                        dirty_writes == nullptr && clean_writes == nullptr;
 
   Tools::Timer<> timer;
   // launch complete save as seperate thread
@@ -389,84 +797,109 @@ std::optional<bool> write_data( std::function<void( bool, u32, u32, s64 )> callb
   };
   SaveContext::finished = std::async(
       std::launch::async,
-      [&, critical_promise = std::move( critical_promise ),
+      [&, snapshot, critical_promise = std::move( critical_promise ),
        callback = std::move( callback )]() mutable
       {
         Tools::Timer<> blocking_timer;
         std::atomic<bool> result( true );
-        try
+        auto run = [&]( const std::function<void()>& func, const std::string& name )
+        {
+          try
+          {
+            func();
+          }
+          catch ( const std::exception& error )
+          {
+            POLLOG_ERRORLN( "failed to store {} datafile! {}\n{}", name, error.what(),
+                            Clib::ExceptionParser::getTrace() );
+            result = false;
+          }
+          catch ( ... )
+          {
+            POLLOG_ERRORLN( "failed to store {} datafile!\n{}", name,
+                            Clib::ExceptionParser::getTrace() );
+            result = false;
+          }
+        };
+        // formats all files with the task thread pool, datastore is given if it was already
+        // formatted
+        auto save_in_process = [&]( const Clib::StreamWriter* datastore )
         {
           SaveContext sc;
           std::vector<std::future<bool>> critical_parts;
-          auto save = [&]( auto func, std::string name )
+          auto save = [&]( std::function<void()> func, std::string name )
           {
             critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-                [&, name, func = std::move( func )]() mutable
-                {
-                  try
-                  {
-                    func();
-                  }
-                  catch ( const std::exception& error )
-                  {
-                    POLLOG_ERRORLN( "failed to store {} datafile! {}\n{}", name, error.what(),
-                                    Clib::ExceptionParser::getTrace() );
-                    result = false;
-                  }
-                  catch ( ... )
-                  {
-                    POLLOG_ERRORLN( "failed to store {} datafile!\n{}", name,
-                                    Clib::ExceptionParser::getTrace() );
-                    result = false;
-                  }
-                } ) );
+                [&, name = std::move( name ), func = std::move( func )]()
+                { run( func, name ); } ) );
           };
 
-          // ordered roughly by "usual" size, so that the biggest files will be written first
-          save( [&]() { write_items( sc.items ); }, "items" );
-          save( [&]() { gamestate.storage.print( sc.storage ); }, "storage" );
-          save( [&]() { write_characters( sc ); }, "character" );
-          save( [&]() { write_npcs( sc ); }, "npcs" );
-          save(
-              [&]()
-              {
-                if ( Plib::systemstate.accounts_txt_dirty )
-                  Accounts::write_account_data();
-              },
-              "accounts" );
-          save(
-              [&]()
-              {
-                sc.pol.comment( "" );
-                sc.pol.comment( " Created by Version: {}", POL_VERSION_ID );
-                sc.pol.comment( " Mobiles: {}", get_mobile_count() );
-                sc.pol.comment( " Top-level Items: {}", get_toplevel_item_count() );
-                sc.pol.comment( "\n" );
-
-                write_system_data( sc.pol );
-                write_global_properties( sc.pol );
-                write_realms( sc.pol );
-              },
-              "pol" );
-          save( [&]() { write_multis( sc.multis ); }, "multis" );
-          save( [&]() { write_resources_dat( sc.resource ); }, "resource" );
-          save( [&]() { write_guilds( sc.guilds ); }, "guilds" );
-          save(
-              [&]()
-              {
-                Module::write_datastore( sc.datastore );
-                // Atomically (hopefully) perform the switch.
-                Module::commit_datastore();
-              },
-              "datastore" );
-          save( [&]() { write_party( sc.party ); }, "party" );
+          save_world( sc, gamestate.task_thread_pool.size(), save );
+          if ( datastore )
+          {
+            sc.datastore.append( *datastore );
+          }
+          else
+          {
+            save( save_accounts, "accounts" );
+            save( [&]() { save_datastore( sc.datastore ); }, "datastore" );
+          }
 
           for ( auto& task : critical_parts )
             task.wait();
 
           set_promise( critical_promise, result );  // critical part end
           blocking_timer.stop();
-        }  // deconstructor of the SaveContext flushes and joins the queues
+          sc.write_parts();
+        };  // deconstructor of the SaveContext flushes and joins the queues
+
+        try
+        {
+#ifndef _WIN32
+          // Snapshot save: the locked part only saves accounts and datastore, which keep state in
+          // this process, and forks. The child writes everything else from its copy on write
+          // snapshot of the world.
+          if ( snapshot )
+          {
+            Clib::StreamWriter datastore;
+            run( save_accounts, "accounts" );
+            run( [&]() { save_datastore( datastore ); }, "datastore" );
+
+            int fds[2];
+            pid_t pid = -1;
+            if ( pipe( fds ) == 0 )
+            {
+              pid = fork();
+              if ( pid == 0 )
+              {
+                ::close( fds[0] );
+                write_snapshot( datastore, fds[1] );
+              }
+              ::close( fds[1] );
+              if ( pid < 0 )
+                ::close( fds[0] );
+            }
+            if ( pid > 0 )
+            {
+              clear_dirty_flags();
+              set_promise( critical_promise, result );  // critical part end
+              blocking_timer.stop();
+              if ( !wait_snapshot( pid, fds[0] ) )
+                result = false;
+            }
+            else
+            {
+              POLLOG_ERRORLN( "failed to fork the snapshot save, saving in process: {}",
+                              std::strerror( errno ) );
+              save_in_process( &datastore );
+            }
+          }
+          else
+#endif
+          {
+            save_in_process( nullptr );
+          }
+        }
         catch ( std::ios_base::failure& e )
         {
           POLLOG_ERRORLN( "failed to save datafiles! {}:{}\n{}", e.what(), std::strerror( errno ),
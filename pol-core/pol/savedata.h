@@ -6,10 +6,16 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "../clib/streamsaver.h"
 #include "gameclck.h"
@@ -40,11 +46,48 @@ public:
   SaveStrategy guilds;
   SaveStrategy datastore;
   SaveStrategy party;
+
+  // in memory part of the given file, filled concurrently by a save task. The parts of a file are
+  // appended in the order they were added: the first unwritten one streams into the file, the
+  // others buffer up to max_part_buffer bytes and then wait for their turn.
+  SaveStrategy& add_part( SaveStrategy& file );
+  // called by the save task once it filled the part, appends the finished parts that are next
+  void finish_part( SaveStrategy& part );
+  // appends what is left of all parts to their files
+  void write_parts();
+
+  size_t max_part_buffer;
+
   static std::shared_future<void> finished;
   static void ready();
   static std::atomic<gameclock_t> last_worldsave_success;
+
+private:
+  struct Part
+  {
+    enum class State
+    {
+      Filling,
+      Finished,
+      Written
+    };
+    SaveStrategy* file;
+    std::unique_ptr<SaveStrategy> buffer;
+    State state;
+  };
+  bool is_next( const Part& part ) const;
+  void part_buffered( Part& part );
+  void write_finished_parts( SaveStrategy& file );
+
+  std::vector<std::unique_ptr<Part>> _parts;
+  std::mutex _parts_mutex;
+  std::condition_variable _parts_cv;
 };
 
+// queues a task with its name for the log
+using SaveTask = std::function<void( std::function<void()>, std::string )>;
+void save_world( SaveContext& sc, size_t shard_count, const SaveTask& save );
+
 void write_system_data( Clib::StreamWriter& sw );
 void write_global_properties( Clib::StreamWriter& sw );
 void write_shadow_realms( Clib::StreamWriter& sw );
@@ -6,6 +6,7 @@
 
 #include "sqlscrobj.h"
 
+#include <algorithm>
 #include <exception>
 #include <regex>
 #include <string.h>
@@ -23,6 +24,7 @@
 #include "../clib/esignal.h"
 #include "../clib/logfacility.h"
 #include "../clib/threadhelp.h"
+#include "../plib/systemstate.h"
 #include "globals/network.h"
 
 namespace Pol
@@ -344,6 +346,17 @@ bool BSQLConnection::connect( const char* host, const char* user, const char* pa
     _error = "No active MYSQL object instance.";
     return false;
   }
+  SQLLogin login{ host, user, passwd, port };
+  const bool use_pool = Plib::systemstate.config.sql_connection_pool_size > 0;
+  if ( use_pool )
+  {
+    if ( MYSQL* pooled = networkManager.sql_service->acquire_connection( login ) )
+    {
+      _conn->set( pooled );
+      _conn->pooled( std::move( login ) );
+      return true;
+    }
+  }
   // port == 0 means default sql port
   if ( !mysql_real_connect( _conn->ptr(), host, user, passwd, nullptr, port, nullptr, 0 ) )
   {
@@ -351,6 +364,8 @@ bool BSQLConnection::connect( const char* host, const char* user, const char* pa
     _error = mysql_error( _conn->ptr() );
     return false;
   }
+  if ( use_pool )
+    _conn->pooled( std::move( login ) );
   return true;
 }
 bool BSQLConnection::select_db( const char* db )
@@ -509,24 +524,41 @@ Bscript::BObjectImp* BSQLConnection::copy() const
   return new BSQLConnection( _conn );
 }
 
-BSQLConnection::ConnectionWrapper::ConnectionWrapper() : _conn( nullptr ) {}
+BSQLConnection::ConnectionWrapper::ConnectionWrapper() : _conn( nullptr ), _login() {}
 BSQLConnection::ConnectionWrapper::~ConnectionWrapper()
 {
   if ( _conn )
-    mysql_close( _conn );
+  {
+    if ( _login && networkManager.sql_service )
+      networkManager.sql_service->release_connection( std::move( *_login ), _conn );
+    else
+      mysql_close( _conn );
+  }
   _conn = nullptr;
 }
 void BSQLConnection::ConnectionWrapper::set( MYSQL* conn )
 {
+  // explicitly closed or replaced connections are not reused
   if ( _conn )
     mysql_close( _conn );
   _conn = conn;
+  _login.reset();
+}
+void BSQLConnection::ConnectionWrapper::pooled( SQLLogin login )
+{
+  _login = std::move( login );
 }
 MYSQL* BSQLConnection::ConnectionWrapper::ptr()
 {
   return _conn;
 };
 
+bool SQLLogin::operator==( const SQLLogin& other ) const
+{
+  return port == other.port && host == other.host && user == other.user &&
+         password == other.password;
+}
+
 ResultWrapper::ResultWrapper( MYSQL_RES* res ) : _result( res ) {}
 ResultWrapper::ResultWrapper() : _result( nullptr ) {}
 ResultWrapper::~ResultWrapper()
@@ -570,18 +602,167 @@ void sql_service_thread_stub()
   }
 }
 
-SQLService::SQLService() {}
-SQLService::~SQLService() {}
+SQLService::SQLService()
+    : _msgs(),
+      _mutex(),
+      _strands(),
+      _idle(),
+      _stopped( false ),
+      _queued( 0 ),
+      _running( 0 ),
+      _executed( 0 ),
+      _wait_total_ms( 0 ),
+      _wait_max_ms( 0 ),
+      _reused( 0 )
+{
+}
+SQLService::~SQLService()
+{
+  for ( auto& idle : _idle )
+    mysql_close( idle.second );
+}
 void SQLService::stop()
 {
+  _stopped = true;
   _msgs.cancel();
 }
 void SQLService::push( msg&& msg_ )
 {
-  _msgs.push_move( std::move( msg_ ) );
+  push( nullptr, std::move( msg_ ) );
+}
+void SQLService::push( const void* affinity, msg&& msg_ )
+{
+  ++_queued;
+  Task task{ std::move( msg_ ), std::chrono::steady_clock::now() };
+  if ( affinity != nullptr )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    auto itr = _strands.find( affinity );
+    if ( itr != _strands.end() )
+    {
+      // the connection is busy, the message follows after the running ones
+      itr->second.push_back( std::move( task ) );
+      return;
+    }
+    _strands.emplace( affinity, std::deque<Task>() );
+  }
+  enqueue( affinity, std::move( task ) );
+}
+void SQLService::enqueue( const void* affinity, Task&& task )
+{
+  // std::function needs a copyable target
+  auto shared = std::make_shared<Task>( std::move( task ) );
+  _msgs.push_move( [this, affinity, shared]() { run( affinity, *shared ); } );
+}
+void SQLService::run( const void* affinity, Task& task )
+{
+  --_queued;
+  ++_running;
+  const u64 waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - task.queued )
+                         .count();
+  _wait_total_ms += waited;
+  u64 max = _wait_max_ms;
+  while ( waited > max && !_wait_max_ms.compare_exchange_weak( max, waited ) )
+    ;
+  try
+  {
+    task.task();
+  }
+  catch ( ... )
+  {
+    finish( affinity );
+    throw;
+  }
+  finish( affinity );
+}
+void SQLService::finish( const void* affinity )
+{
+  --_running;
+  ++_executed;
+  if ( affinity == nullptr )
+    return;
+  std::lock_guard<std::mutex> lock( _mutex );
+  auto itr = _strands.find( affinity );
+  if ( itr == _strands.end() )
+    return;
+  if ( itr->second.empty() )
+  {
+    _strands.erase( itr );
+    return;
+  }
+  Task next = std::move( itr->second.front() );
+  itr->second.pop_front();
+  enqueue( affinity, std::move( next ) );
+}
+MYSQL* SQLService::acquire_connection( const SQLLogin& login )
+{
+  while ( true )
+  {
+    MYSQL* conn;
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      auto itr = std::find_if( _idle.begin(), _idle.end(),
+                               [&]( const auto& idle ) { return idle.first == login; } );
+      if ( itr == _idle.end() )
+        return nullptr;
+      conn = itr->second;
+      _idle.erase( itr );
+    }
+    // the server could have closed the idle connection meanwhile
+    if ( !mysql_ping( conn ) )
+    {
+      ++_reused;
+      return conn;
+    }
+    mysql_close( conn );
+  }
+}
+void SQLService::release_connection( SQLLogin login, MYSQL* conn )
+{
+  if ( _stopped )
+  {
+    mysql_close( conn );
+    return;
+  }
+  push(
+      [this, login, conn]()
+      {
+        // resets the session state: open transactions are rolled back, temporary tables dropped
+        // and no database is selected
+        if ( !mysql_change_user( conn, login.user.c_str(), login.password.c_str(), nullptr ) )
+        {
+          std::lock_guard<std::mutex> lock( _mutex );
+          if ( _idle.size() < Plib::systemstate.config.sql_connection_pool_size )
+          {
+            _idle.emplace_back( login, conn );
+            return;
+          }
+        }
+        mysql_close( conn );
+      } );
+}
+SQLService::Stats SQLService::stats() const
+{
+  Stats stats;
+  stats.queued = _queued;
+  stats.running = _running;
+  stats.executed = _executed;
+  stats.wait_total_ms = _wait_total_ms;
+  stats.wait_max_ms = _wait_max_ms;
+  stats.reused_connections = _reused;
+  std::lock_guard<std::mutex> lock( _mutex );
+  stats.idle_connections = _idle.size();
+  return stats;
 }
 void SQLService::start()  // executed inside a extra thread
 {
+  // the client library keeps state per thread, every worker has to set it up and release it
+  mysql_thread_init();
+  struct ThreadEnd
+  {
+    ~ThreadEnd() { mysql_thread_end(); }
+  } thread_end;
   while ( !Clib::exit_signalled )
   {
     try
@@ -601,7 +782,14 @@ void SQLService::start()  // executed inside a extra thread
 
 void start_sql_service()
 {
-  threadhelp::start_thread( sql_service_thread_stub, "SQLService" );
+  // mysql_init() would initialize the library on first use, which is not thread safe
+  if ( mysql_library_init( 0, nullptr, nullptr ) )
+  {
+    POLLOG_ERRORLN( "Failed to initialize the MySQL client library" );
+    return;
+  }
+  for ( unsigned short i = 0; i < Plib::systemstate.config.sql_worker_threads; ++i )
+    threadhelp::start_thread( sql_service_thread_stub, "SQLService" );
 }
 }  // namespace Core
 }  // namespace Pol
@@ -18,9 +18,17 @@
 #include <mysql/mysql.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../bscript/bobject.h"
 #include "../clib/message_queue.h"
@@ -117,6 +125,17 @@ class SQLService;
 typedef std::vector<std::string> QueryParam;
 typedef std::shared_ptr<QueryParam> QueryParams;
 
+// credentials of a connection, identifies the idle connections of the pool which can be reused
+struct SQLLogin
+{
+  std::string host;
+  std::string user;
+  std::string password;
+  int port;
+
+  bool operator==( const SQLLogin& other ) const;
+};
+
 class BSQLConnection final : public Core::PolObjectImp
 {
   class ConnectionWrapper;
@@ -163,25 +182,70 @@ private:
     ~ConnectionWrapper();
     void set( MYSQL* conn );
     MYSQL* ptr();
+    // connection is handed back to the pool instead of closed when the last reference is gone
+    void pooled( SQLLogin login );
 
   private:
     MYSQL* _conn;
+    std::optional<SQLLogin> _login;
   };
 };
 
+// Executes the script database calls on a pool of worker threads (SQLWorkerThreads).
+// Calls on the same connection are executed in order and never in parallel, so transactions and
+// select_db stay bound to their connection while other connections are served meanwhile.
 class SQLService
 {
 public:
   typedef std::function<void()> msg;
   typedef Clib::message_queue<msg> msg_queue;
+  struct Stats
+  {
+    size_t queued;
+    size_t running;
+    u64 executed;
+    u64 wait_total_ms;
+    u64 wait_max_ms;
+    size_t idle_connections;
+    u64 reused_connections;
+  };
   SQLService();
   ~SQLService();
   void start();
   void stop();
   void push( msg&& msg_ );
+  // affinity identifies the connection the message works on
+  void push( const void* affinity, msg&& msg_ );
+
+  // idle connection of the pool for the given login or nullptr, executed inside of a worker
+  MYSQL* acquire_connection( const SQLLogin& login );
+  // resets the session of the connection and keeps it for reuse (SQLConnectionPoolSize)
+  void release_connection( SQLLogin login, MYSQL* conn );
+
+  Stats stats() const;
 
 private:
+  struct Task
+  {
+    msg task;
+    std::chrono::steady_clock::time_point queued;
+  };
+  void enqueue( const void* affinity, Task&& task );
+  void run( const void* affinity, Task& task );
+  void finish( const void* affinity );
+
   msg_queue _msgs;
+  mutable std::mutex _mutex;
+  // connections with a queued or running message, further messages wait here
+  std::unordered_map<const void*, std::deque<Task>> _strands;
+  std::vector<std::pair<SQLLogin, MYSQL*>> _idle;
+  std::atomic<bool> _stopped;
+  std::atomic<size_t> _queued;
+  std::atomic<size_t> _running;
+  std::atomic<u64> _executed;
+  std::atomic<u64> _wait_total_ms;
+  std::atomic<u64> _wait_max_ms;
+  std::atomic<u64> _reused;
 };
 void start_sql_service();
 }  // namespace Core
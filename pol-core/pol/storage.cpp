@@ -253,12 +253,38 @@ void Storage::read( Clib::ConfigFile& cf )
 
 void Storage::print( Clib::StreamWriter& sw ) const
 {
+  print( sw, print_entries() );
+}
+
+std::vector<Storage::PrintEntry> Storage::print_entries() const
+{
+  std::vector<PrintEntry> entries;
   for ( const auto& area : areas )
   {
-    sw.begin( "StorageArea" );
-    sw.add( "Name", area.first );
-    sw.end();
-    area.second->print( sw );
+    entries.push_back( { &area.first, nullptr } );
+    for ( const auto& cont_item : area.second->_items )
+    {
+      if ( cont_item.second->saveonexit() )
+        entries.push_back( { nullptr, cont_item.second } );
+    }
+  }
+  return entries;
+}
+
+void Storage::print( Clib::StreamWriter& sw, const std::vector<PrintEntry>& entries )
+{
+  for ( const auto& entry : entries )
+  {
+    if ( entry.area != nullptr )
+    {
+      sw.begin( "StorageArea" );
+      sw.add( "Name", *entry.area );
+      sw.end();
+    }
+    else
+    {
+      entry.item->printOn( sw );
+    }
   }
 }
 
@@ -9,6 +9,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "../bscript/bobject.h"
 #include "../clib/maputil.h"
@@ -59,6 +60,7 @@ private:
 
   friend class StorageAreaImp;
   friend class StorageAreaIterator;
+  friend class Storage;
 };
 
 
@@ -92,6 +94,17 @@ public:
 
   void print( Clib::StreamWriter& sw ) const;
   void read( Clib::ConfigFile& cf );
+
+  // Area headers and root items in save order. Printing consecutive parts of it separately and
+  // concatenating them equals print( sw ).
+  struct PrintEntry
+  {
+    const std::string* area;  // header of a new area
+    const Items::Item* item;
+  };
+  std::vector<PrintEntry> print_entries() const;
+  static void print( Clib::StreamWriter& sw, const std::vector<PrintEntry>& entries );
+
   void clear();
   size_t estimateSize() const;
 
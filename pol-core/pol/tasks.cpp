@@ -30,6 +30,7 @@
 #include "polsig.h"
 #include "profile.h"
 #include "realms/realm.h"
+#include "realms/realmtask.h"
 #include "uworld.h"
 #include "vital.h"
 
@@ -49,7 +50,9 @@ void regen_stats()
   gameclock_t now_gameclock = read_gameclock();
   THREAD_CHECKPOINT( tasks, 401 );
 
-  auto stat_regen = [&now_gameclock, &now]( Mobile::Character* chr )
+  // runs concurrently per realm, everything which leaves the character is deferred
+  auto stat_regen = [&now_gameclock, &now]( Mobile::Character* chr,
+                                            Realms::DeferredActions& deferred )
   {
     THREAD_CHECKPOINT( tasks, 402 );
 
@@ -60,8 +63,13 @@ void regen_stats()
       {
         chr->lightoverride( -1 );
         chr->lightoverride_until( 0 );
-        THREAD_CHECKPOINT( tasks, 403 );
-        chr->check_region_changes();
+        deferred.push(
+            [ref = CharacterRef( chr )]()
+            {
+              THREAD_CHECKPOINT( tasks, 403 );
+              if ( !ref->orphan() )
+                ref->check_region_changes();
+            } );
       }
     }
 
@@ -116,33 +124,31 @@ void regen_stats()
     {
       THREAD_CHECKPOINT( tasks, 406 );
       if ( !chr->dead() || pVital->regen_while_dead )
-        chr->regen_vital( pVital );
+        chr->regen_vital( pVital, deferred );
       THREAD_CHECKPOINT( tasks, 407 );
     }
 
     if ( !chr->dead() )
     {
       THREAD_CHECKPOINT( tasks, 408 );
-      chr->check_undamaged();
+      chr->check_undamaged( deferred );
       THREAD_CHECKPOINT( tasks, 409 );
     }
   };
 
 
-  for ( auto& realm : gamestate.Realms )
-  {
-    for ( const auto& p : realm->gridarea() )
-    {
-      for ( auto& chr : realm->getzone_grid( p ).characters )
-      {
-        stat_regen( chr );
-      }
-      for ( auto& chr : realm->getzone_grid( p ).npcs )
+  THREAD_CHECKPOINT( tasks, 410 );
+  Realms::for_each_realm_parallel(
+      [&]( Realms::Realm* realm, Realms::DeferredActions& deferred )
       {
-        stat_regen( chr );
-      }
-    }
-  }
+        for ( const auto& p : realm->gridarea() )
+        {
+          for ( auto& chr : realm->getzone_grid( p ).characters )
+            stat_regen( chr, deferred );
+          for ( auto& chr : realm->getzone_grid( p ).npcs )
+            stat_regen( chr, deferred );
+        }
+      } );
   THREAD_CHECKPOINT( tasks, 499 );
 }
 
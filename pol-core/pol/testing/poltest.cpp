@@ -33,6 +33,8 @@ bool run_pol_tests()
   RUNTEST( test_convertquotedstring )
   RUNTEST( test_sanitizeUnicodeWithIso )
   RUNTEST( test_encodingconversions )
+  RUNTEST( mappedcfgfile_test )
+  RUNTEST( binpack_test )
 
   //  skilladv_test();
 
@@ -53,6 +55,8 @@ bool run_pol_tests()
   RUNTEST( test_curlfeatures )
 
   RUNTEST( decay_test )
+  RUNTEST( realmtask_test )
+  RUNTEST( savedata_test )
   RUNTEST( clamp_test )
   RUNTEST( uoextension_test )
   //  RUNTEST( dummy )
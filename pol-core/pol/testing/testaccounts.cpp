@@ -0,0 +1,116 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "../../clib/cfgelem.h"
+#include "../../clib/cfgfile.h"
+#include "../../clib/random.h"
+#include "../../clib/strutil.h"
+#include "../accounts/account.h"
+#include "../accounts/accounts.h"
+#include "../globals/uvars.h"
+#endif
+
+namespace Pol
+{
+namespace Testing
+{
+#ifdef ENABLE_BENCHMARK
+namespace
+{
+std::string bench_account_name( int count, int i )
+{
+  return "Bench" + std::to_string( count ) + "_" + std::to_string( i );
+}
+
+// writes an accounts.txt with count entries and loads it like read_account_data does, returns the
+// index of the first loaded account
+size_t load_bench_accounts( int count )
+{
+  const size_t first = Core::gamestate.accounts.size();
+  std::string filename = "bench_accounts_" + std::to_string( count ) + ".txt";
+  {
+    std::ofstream ofs( filename, std::ios::trunc );
+    for ( int i = 0; i < count; ++i )
+    {
+      ofs << "Account\n{\n"
+          << "\tName\t" << bench_account_name( count, i ) << "\n"
+          << "\tPasswordHash\t0123456789abcdef0123456789abcdef\n"
+          << "\tEnabled\t1\n"
+          << "}\n\n";
+    }
+  }
+  {
+    Clib::ConfigFile cf( filename, "Account" );
+    Clib::ConfigElem elem;
+    while ( cf.read( elem ) )
+      Accounts::add_account( new Accounts::Account( elem ) );
+  }
+  remove( filename.c_str() );
+  return first;
+}
+
+// removes the accounts load_bench_accounts added behind first, at once instead of the linear
+// delete_account for each
+void remove_bench_accounts( size_t first )
+{
+  auto& accounts = Core::gamestate.accounts;
+  auto& by_name = Core::gamestate.accounts_by_name;
+  for ( auto itr = accounts.begin() + first; itr != accounts.end(); ++itr )
+  {
+    auto name_itr = by_name.find( Clib::strlowerASCII( ( *itr )->name() ) );
+    if ( name_itr != by_name.end() && name_itr->second == itr->get() )
+      by_name.erase( name_itr );
+  }
+  accounts.erase( accounts.begin() + first, accounts.end() );
+}
+}  // namespace
+
+// burst of logins: find_account with the casing a client sent, one in eight unknown
+static void BM_find_account_burst( benchmark::State& state )
+{
+  const int count = static_cast<int>( state.range( 0 ) );
+  const size_t first = load_bench_accounts( count );
+
+  std::vector<std::string> logins;
+  logins.reserve( 4096 );
+  for ( int i = 0; i < 4096; ++i )
+  {
+    std::string name = bench_account_name( count, Clib::random_int( count - 1 ) );
+    if ( i % 2 )
+      name[0] = 'b';
+    if ( i % 8 == 0 )
+      name += "x";
+    logins.push_back( std::move( name ) );
+  }
+
+  size_t idx = 0;
+  size_t found = 0;
+  while ( state.KeepRunning() )
+  {
+    Accounts::Account* acct = Accounts::find_account( logins[idx].c_str() );
+    if ( acct != nullptr && acct->enabled() )
+      ++found;
+    if ( ++idx == logins.size() )
+      idx = 0;
+  }
+  benchmark::DoNotOptimize( found );
+  state.SetItemsProcessed( state.iterations() );
+  remove_bench_accounts( first );
+}
+BENCHMARK( BM_find_account_burst )->Arg( 10000 )->Arg( 250000 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
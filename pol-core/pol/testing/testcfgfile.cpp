@@ -0,0 +1,186 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include "testenv.h"
+
+#include <fstream>
+#include <stdio.h>
+#include <string>
+
+#include "../../clib/cfgelem.h"
+#include "../../clib/cfgfile.h"
+#include "../../clib/mappedcfgfile.h"
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+namespace Pol
+{
+namespace Testing
+{
+namespace
+{
+// every element with its properties in the order remove_first_prop returns them
+template <class File, class Elem>
+std::string dump_cfg( const std::string& filename )
+{
+  File cf( filename );
+  Elem elem;
+  std::string out, name, value;
+  while ( cf.read( elem ) )
+  {
+    out += fmt::format( "{} {}\n", elem.type(), elem.rest() );
+    while ( elem.remove_first_prop( &name, &value ) )
+      out += fmt::format( "  [{}] [{}]\n", name, value );
+  }
+  return out;
+}
+}  // namespace
+
+void mappedcfgfile_test()
+{
+  const std::string filename = "test_mappedcfgfile.cfg";
+  {
+    std::ofstream ofs( filename, std::ios::binary | std::ios::trunc );
+    ofs << "\xEF\xBB\xBF# comment\r\n"
+           "Item 0x4001 rest words \r\n"
+           "{\r\n"
+           "  Name=sword\r\n"
+           "  zeta 1\r\n"
+           "  Alpha  two words  \r\n"
+           "  alpha dup\r\n"
+           "  // comment\r\n"
+           "  Quoted \"a b\" trailing\r\n"
+           "  Escaped \"x\\\"y\\nz\"\r\n"
+           "  Iso caf\xE9\r\n"
+           "  Empty\r\n"
+           "}\r\n"
+           "\r\n"
+           "Npc guard\n"
+           "{\n"
+           "}\n"
+           "Last\n"
+           "{\n"
+           "  Graphic 0x1F4\n"
+           "  CProp x sS3:abc\n"
+           "}";
+  }
+  const std::string expected = dump_cfg<Clib::ConfigFile, Clib::ConfigElem>( filename );
+  UnitTest( [&]() { return dump_cfg<Clib::MappedConfigFile, Clib::ConfigElemView>( filename ); },
+            expected, "same elements as ConfigFile" );
+  {
+    Clib::MappedConfigFile cf( filename );
+    Clib::ConfigElemView elem;
+    cf.read( elem );
+    UnitTest( [&]() { return elem.remove_ushort( "ZETA" ); }, 1, "remove_ushort" );
+    UnitTest( [&]() { return elem.remove_string( "alpha" ); }, "two words", "remove_string" );
+    UnitTest(
+        [&]()
+        {
+          elem.clear_prop( "alpha" );
+          return elem.has_prop( "alpha" );
+        },
+        false, "clear_prop" );
+    UnitTest( [&]() { return elem.remove_int( "missing", 7 ); }, 7, "default" );
+    cf.read( elem );
+    cf.read( elem );
+    UnitTest( [&]() { return elem.remove_ulong( "Graphic" ); }, 0x1F4u, "remove_ulong" );
+    UnitTest(
+        [&]()
+        {
+          Clib::ConfigElem copy;
+          elem.copy_to( copy );
+          return copy.remove_string( "CProp" );
+        },
+        "x sS3:abc", "copy_to" );
+    UnitTest( [&]() { return cf.read( elem ); }, false, "end of file" );
+  }
+  remove( filename.c_str() );
+}
+
+#ifdef ENABLE_BENCHMARK
+namespace
+{
+// an items.txt like a worldsave writes it
+std::string write_bench_items( int count )
+{
+  std::string filename = "bench_items_" + std::to_string( count ) + ".txt";
+  std::ofstream ofs( filename, std::ios::trunc );
+  for ( int i = 0; i < count; ++i )
+  {
+    ofs << "Item\n{\n"
+        << "\tName\titem" << i << "\n"
+        << "\tSerial\t0x" << std::hex << 0x40000000 + i << "\n"
+        << "\tObjType\t0x" << 0xE75 + i % 16 << "\n"
+        << "\tGraphic\t0x" << 0xE75 + i % 16 << std::dec << "\n"
+        << "\tX\t" << 1000 + i % 4000 << "\n"
+        << "\tY\t" << 500 + i % 3000 << "\n"
+        << "\tZ\t" << i % 20 << "\n"
+        << "\tColor\t0x0\n"
+        << "\tFacing\t0\n"
+        << "\tRealm\tbritannia\n"
+        << "\tMovable\t1\n"
+        << "\tCProp\tdescription sS21:a bench item in a box\n"
+        << "\tCProp\tcreated i" << 123456 + i << "\n"
+        << "}\n\n";
+  }
+  return filename;
+}
+
+// the usual way to consume an element: a few removes by name, the cprops in a loop
+template <class Elem>
+size_t consume_elem( Elem& elem )
+{
+  size_t sum = elem.remove_ulong( "Serial" );
+  sum += elem.remove_ushort( "Graphic" );
+  sum += elem.remove_int( "X" ) + elem.remove_int( "Y" );
+  sum += elem.remove_string( "Realm", "" ).size();
+  std::string value;
+  while ( elem.remove_prop( "CProp", &value ) )
+    sum += value.size();
+  return sum;
+}
+
+template <class File, class Elem>
+void bench_read_items( benchmark::State& state )
+{
+  const int count = static_cast<int>( state.range( 0 ) );
+  const std::string filename = write_bench_items( count );
+  size_t bytes = 0;
+  {
+    std::ifstream ifs( filename, std::ios::binary | std::ios::ate );
+    bytes = static_cast<size_t>( ifs.tellg() );
+  }
+  while ( state.KeepRunning() )
+  {
+    File cf( filename, "Item" );
+    Elem elem;
+    size_t sum = 0;
+    while ( cf.read( elem ) )
+      sum += consume_elem( elem );
+    benchmark::DoNotOptimize( sum );
+  }
+  remove( filename.c_str() );
+  state.SetLabel( std::to_string( bytes / 1024 ) + " KiB" );
+  state.SetBytesProcessed( state.iterations() * bytes );
+}
+}  // namespace
+
+static void BM_cfgfile_read_items( benchmark::State& state )
+{
+  bench_read_items<Clib::ConfigFile, Clib::ConfigElem>( state );
+}
+BENCHMARK( BM_cfgfile_read_items )->Arg( 10000 )->Arg( 200000 );
+
+static void BM_mappedcfgfile_read_items( benchmark::State& state )
+{
+  bench_read_items<Clib::MappedConfigFile, Clib::ConfigElemView>( state );
+}
+BENCHMARK( BM_mappedcfgfile_read_items )->Arg( 10000 )->Arg( 200000 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
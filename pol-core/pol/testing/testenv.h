@@ -83,6 +83,8 @@ void test_splitnamevalue();
 void test_convertquotedstring();
 void test_sanitizeUnicodeWithIso();
 void test_encodingconversions();
+void mappedcfgfile_test();
+void binpack_test();
 
 void map_test();
 void skilladv_test();
@@ -105,6 +107,8 @@ void range3d_test();
 void test_curlfeatures();
 
 void decay_test();
+void realmtask_test();
+void savedata_test();
 void clamp_test();
 void uoextension_test();
 }  // namespace Testing
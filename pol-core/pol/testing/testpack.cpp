@@ -0,0 +1,131 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#include <string>
+
+#include "../../bscript/berror.h"
+#include "../../bscript/binpack.h"
+#include "../../bscript/bobject.h"
+#include "../../bscript/bstruct.h"
+#include "../../bscript/dict.h"
+#include "../../bscript/impstr.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+namespace Pol
+{
+namespace Testing
+{
+namespace
+{
+// errortext of a failed unpack, otherwise the value in the text format
+std::string unpack_result( const std::string& packed )
+{
+  Bscript::BObject value( Bscript::BObjectImp::unpack( packed.c_str() ) );
+  if ( !value.isa( Bscript::BObjectImp::OTError ) )
+    return value->pack();
+  const Bscript::BObjectImp* text = value.impptr<Bscript::BError>()->FindMember( "errortext" );
+  return text != nullptr ? text->getStringRep() : "";
+}
+}  // namespace
+
+void binpack_test()
+{
+  const std::string prefix = "Unable to unpack binary value: ";
+  UnitTest( []() { return unpack_result( "~a3i:s3heyi>" ); }, "a3:i5S3:heyi7", "array" );
+  UnitTest( []() { return unpack_result( "~d1u" ); },
+            prefix + "dictionary keys must be integer, real, or string", "uninit key" );
+  UnitTest( []() { return unpack_result( "~d1a0i0" ); },
+            prefix + "dictionary keys must be integer, real, or string", "array key" );
+  UnitTest( []() { return unpack_result( "~d1i" ); }, prefix + "invalid integer",
+            "truncated key" );
+  UnitTest( []() { return unpack_result( "~a2i0" ); }, prefix + "unexpected end of data",
+            "unterminated array" );
+  UnitTest( []() { return unpack_result( "~i!" ); }, prefix + "invalid integer", "bad varint" );
+  UnitTest( []() { return unpack_result( "~iPPPPPPPPPPPPP0" ); }, prefix + "invalid integer",
+            "overlong varint" );
+  UnitTest( []() { return unpack_result( "~v3~i0" ); }, prefix + "invalid text value",
+            "binary text value" );
+  // a rejected uninit key must not have released the shared instance
+  UnitTest( []() { return unpack_result( "~a2ui2" ); }, "a2:ui1", "uninit after bad key" );
+
+  std::string nested;
+  std::string nested_text;
+  for ( int i = 0; i < 100; ++i )
+  {
+    nested += "a1";
+    nested_text += "a1:";
+  }
+  UnitTest( [&]() { return unpack_result( "~" + nested + "i0" ); }, nested_text + "i0",
+            "nesting limit" );
+  UnitTest( [&]() { return unpack_result( "~a1" + nested + "i0" ); },
+            prefix + "nesting too deep", "nesting too deep" );
+}
+
+#ifdef ENABLE_BENCHMARK
+namespace
+{
+// a typical bigger cprop: struct with some members and a dictionary of arrays
+Bscript::BObjectImp* bench_pack_value()
+{
+  auto* quests = new Bscript::BDictionary;
+  for ( int i = 1; i <= 50; ++i )
+  {
+    auto* steps = new Bscript::ObjArray;
+    steps->addElement( new Bscript::BLong( i * 1000 ) );
+    steps->addElement( new Bscript::Double( i * 1.5 ) );
+    steps->addElement( new Bscript::String( "step description " + std::to_string( i ) ) );
+    quests->addMember( new Bscript::BLong( i ), steps );
+  }
+  auto* value = new Bscript::BStruct;
+  value->addMember( "name", new Bscript::String( "bench" ) );
+  value->addMember( "serial", new Bscript::BLong( 0x40001234 ) );
+  value->addMember( "active", new Bscript::BBoolean( true ) );
+  value->addMember( "quests", quests );
+  return value;
+}
+
+Bscript::PackFormat bench_pack_format( const benchmark::State& state )
+{
+  return static_cast<Bscript::PackFormat>( state.range( 0 ) );
+}
+}  // namespace
+
+static void BM_pack( benchmark::State& state )
+{
+  Bscript::BObject value( bench_pack_value() );
+  std::string packed;
+  while ( state.KeepRunning() )
+  {
+    packed = Bscript::pack( value.impref(), bench_pack_format( state ) );
+    benchmark::DoNotOptimize( packed );
+  }
+  state.SetLabel( std::to_string( packed.size() ) + " bytes" );
+  state.SetBytesProcessed( state.iterations() * packed.size() );
+}
+BENCHMARK( BM_pack )->Arg( 1 )->Arg( 2 );
+
+static void BM_unpack( benchmark::State& state )
+{
+  Bscript::BObject value( bench_pack_value() );
+  const std::string packed = Bscript::pack( value.impref(), bench_pack_format( state ) );
+  while ( state.KeepRunning() )
+  {
+    Bscript::BObject unpacked( Bscript::BObjectImp::unpack( packed.c_str() ) );
+    benchmark::DoNotOptimize( unpacked.impptr() );
+  }
+  state.SetLabel( std::to_string( packed.size() ) + " bytes" );
+  state.SetBytesProcessed( state.iterations() * packed.size() );
+}
+BENCHMARK( BM_unpack )->Arg( 1 )->Arg( 2 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
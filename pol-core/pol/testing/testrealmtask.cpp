@@ -0,0 +1,87 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../clib/logfacility.h"
+#include "../globals/uvars.h"
+#include "../realms/realm.h"
+#include "../realms/realmtask.h"
+#include "testenv.h"
+
+namespace Pol::Testing
+{
+void realmtask_test()
+{
+  using namespace std::chrono_literals;
+  const auto& realms = Core::gamestate.Realms;
+  if ( realms.size() < 2 )
+  {
+    INFO_PRINTLN( "    at least two realms needed 2>{}", realms.size() );
+    UnitTest::inc_failures();
+    return;
+  }
+
+  // every realm gets one action, which pushes a nested one. The first realm finishes last, but
+  // its actions still have to run first.
+  std::string expected;
+  for ( const auto* realm : realms )
+    expected += realm->name() + "," + realm->name() + " nested,";
+
+  std::vector<std::atomic<int>> visits( realms.size() );
+  std::string order;
+  auto task = [&]( Realms::Realm* realm, Realms::DeferredActions& deferred )
+  {
+    for ( size_t i = 0; i < realms.size(); ++i )
+      if ( realms[i] == realm )
+        ++visits[i];
+    if ( realm == realms.front() )
+      std::this_thread::sleep_for( 50ms );
+    deferred.push(
+        [&order, &deferred, realm]()
+        {
+          order += realm->name() + ",";
+          deferred.push( [&order, realm]() { order += realm->name() + " nested,"; } );
+        } );
+  };
+
+  Realms::for_each_realm_parallel( task );
+  UnitTest( [&]() { return order; }, expected, "deferred actions in realm order" );
+  UnitTest(
+      [&]()
+      {
+        for ( const auto& v : visits )
+          if ( v != 1 )
+            return false;
+        return true;
+      },
+      true, "every realm visited once" );
+
+  // an exception is passed on after all realms are finished and their actions are executed
+  order.clear();
+  bool thrown = false;
+  try
+  {
+    Realms::for_each_realm_parallel(
+        [&]( Realms::Realm* realm, Realms::DeferredActions& deferred )
+        {
+          task( realm, deferred );
+          if ( realm == realms.back() )
+            throw std::runtime_error( "realm task failed" );
+        } );
+  }
+  catch ( const std::runtime_error& )
+  {
+    thrown = true;
+  }
+  UnitTest( [&]() { return thrown; }, true, "exception passed on" );
+  UnitTest( [&]() { return order; }, expected, "deferred actions executed before exception" );
+}
+}  // namespace Pol::Testing
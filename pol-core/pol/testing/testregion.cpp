@@ -0,0 +1,50 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+
+#include "../globals/uvars.h"
+#include "../realms/realm.h"
+#include "../regions/guardrgn.h"
+#endif
+
+namespace Pol
+{
+namespace Testing
+{
+#ifdef ENABLE_BENCHMARK
+// JusticeDef::getregion on a walk over the main realm, one lookup per step
+static void BM_getregion( benchmark::State& state )
+{
+  auto* realm = Core::gamestate.main_realm;
+  auto* justicedef = Core::gamestate.justicedef;
+  const u16 width = realm->width();
+  const u16 height = realm->height();
+
+  u16 x = 0;
+  u16 y = 0;
+  size_t found = 0;
+  while ( state.KeepRunning() )
+  {
+    if ( justicedef->getregion( Core::Pos4d( x, y, 0, realm ) ) != nullptr )
+      ++found;
+    if ( ++x == width )
+    {
+      x = 0;
+      y = static_cast<u16>( ( y + 7 ) % height );
+    }
+  }
+  benchmark::DoNotOptimize( found );
+  state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_getregion );
+#endif
+}  // namespace Testing
+}  // namespace Pol
@@ -0,0 +1,106 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../plib/systemstate.h"
+#include "../globals/uvars.h"
+#include "../item/item.h"
+#include "../realms/realm.h"
+#include "../savedata.h"
+#include "../ufunc.h"
+#include "../uworld.h"
+#include "testenv.h"
+
+namespace fs = std::filesystem;
+
+namespace Pol::Testing
+{
+namespace
+{
+// saves the world into dir and returns the content of each file
+std::map<std::string, std::string> save_files( const fs::path& dir, size_t shard_count,
+                                               size_t max_part_buffer )
+{
+  fs::remove_all( dir );
+  fs::create_directories( dir );
+  auto& world_data_path = Plib::systemstate.config.world_data_path;
+  const auto orig_path = world_data_path;
+  world_data_path = dir.generic_string() + "/";
+  {
+    Core::SaveContext sc;
+    sc.max_part_buffer = max_part_buffer;
+    std::vector<std::future<bool>> tasks;
+    Core::save_world( sc, shard_count,
+                      [&]( std::function<void()> func, std::string )
+                      {
+                        if ( shard_count > 1 )
+                          tasks.push_back( Core::gamestate.task_thread_pool.checked_push( func ) );
+                        else
+                          func();
+                      } );
+    for ( auto& task : tasks )
+      task.get();
+    sc.write_parts();
+  }
+  world_data_path = orig_path;
+
+  std::map<std::string, std::string> files;
+  for ( const auto& entry : fs::directory_iterator( dir ) )
+  {
+    std::ifstream in( entry.path(), std::ios::binary );
+    files[entry.path().filename().string()].assign( std::istreambuf_iterator<char>( in ),
+                                                    std::istreambuf_iterator<char>() );
+  }
+  fs::remove_all( dir );
+  return files;
+}
+}  // namespace
+
+void savedata_test()
+{
+  // spread items over many zones of every realm, so that each file gets several big shards
+  std::vector<Items::Item*> items;
+  for ( auto* realm : Core::gamestate.Realms )
+  {
+    for ( unsigned i = 0; i < 5000; ++i )
+    {
+      auto* item = Items::Item::create( 0x0eed );
+      item->setposition( Core::Pos4d( static_cast<u16>( i * 37 % realm->width() ),
+                                      static_cast<u16>( i * 53 % realm->height() ), 0, realm ) );
+      Core::add_item_to_world( item );
+      items.push_back( item );
+    }
+  }
+
+  const auto dir = fs::temp_directory_path() / "pol_savedata_test";
+  const auto serial = save_files( dir, 1, 0 );
+  // a small part buffer lets the later shards wait for the earlier ones
+  const auto sharded = save_files( dir, 4, 0x8000 );
+  const auto buffered = save_files( dir, 4, 16 * 1024 * 1024 );
+
+  UnitTest( [&]() { return serial.size(); }, sharded.size(), "same files sharded" );
+  for ( const auto& file : serial )
+  {
+    auto compare = [&]( const std::map<std::string, std::string>& files )
+    {
+      auto itr = files.find( file.first );
+      return itr != files.end() && itr->second == file.second;
+    };
+    UnitTest( [&]() { return compare( sharded ); }, true, file.first + " streamed shards" );
+    UnitTest( [&]() { return compare( buffered ); }, true, file.first + " buffered shards" );
+  }
+
+  for ( auto* item : items )
+    Core::destroy_item( item );
+}
+}  // namespace Pol::Testing
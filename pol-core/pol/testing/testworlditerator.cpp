@@ -0,0 +1,70 @@
+/** @file
+ *
+ * @par History
+ */
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "../../plib/realmdescriptor.h"
+#include "../globals/uvars.h"
+#include "../item/item.h"
+#include "../realms/realm.h"
+#include "../ufunc.h"
+#include "../uworld.h"
+#endif
+
+namespace Pol
+{
+namespace Testing
+{
+#ifdef ENABLE_BENCHMARK
+// WorldIterator::InRange over a visual range with state.range(0) ground items per world zone
+static void BM_worlditerator_inrange( benchmark::State& state )
+{
+  auto* realm = Core::gamestate.main_realm;
+  const auto items_per_zone = static_cast<u16>( state.range( 0 ) );
+  const Core::Pos2d center( realm->width() / 2, realm->height() / 2 );
+  const u16 range = 18;
+
+  // fill all zones touched by the range, spread evenly over each zone
+  std::vector<Items::Item*> items;
+  const Core::Vec2d border( range + Plib::WGRID_SIZE, range + Plib::WGRID_SIZE );
+  const Core::Range2d fill( center - border, center + border, realm );
+  const u16 step = static_cast<u16>(
+      std::max( 1u, Plib::WGRID_SIZE * Plib::WGRID_SIZE / static_cast<unsigned>( items_per_zone ) ) );
+  u32 n = 0;
+  for ( const auto& p : fill )
+  {
+    if ( n++ % step )
+      continue;
+    auto* item = Items::Item::create( 0x0eed );
+    item->setposition( Core::Pos4d( p, 0, realm ) );
+    Core::add_item_to_world( item );
+    items.push_back( item );
+  }
+
+  size_t count = 0;
+  while ( state.KeepRunning() )
+  {
+    count = 0;
+    Core::WorldIterator<Core::ItemFilter>::InRange( center, realm, range,
+                                                    [&]( Items::Item* ) { ++count; } );
+    benchmark::DoNotOptimize( count );
+  }
+  state.SetItemsProcessed( state.iterations() * count );
+  state.SetLabel( fmt::format( "{} items, {} in range", items.size(), count ) );
+
+  for ( auto* item : items )
+    Core::destroy_item( item );
+}
+BENCHMARK( BM_worlditerator_inrange )->Arg( 1 )->Arg( 16 )->Arg( 128 )->Arg( 1024 )->Arg( 4096 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
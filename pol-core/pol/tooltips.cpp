@@ -18,11 +18,14 @@
 #include "../bscript/impstr.h"
 #include "../clib/clib_endian.h"
 #include "../clib/rawtypes.h"
+#include "../clib/stlutil.h"
 #include "../plib/uoexpansion.h"
+#include "globals/network.h"
 #include "item/item.h"
 #include "item/itemdesc.h"
 #include "mobile/charactr.h"
 #include "network/client.h"
+#include "network/clienttransmit.h"
 #include "network/packetdefs.h"
 #include "network/packethelper.h"
 #include "network/packets.h"
@@ -89,7 +92,12 @@ void send_object_cache_to_inrange( const UObject* obj )
 }
 
 
-void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+namespace
+{
+// entries of destroyed objects are never removed, start over once the cache grows this big
+const size_t TOOLTIP_CACHE_MAX_ENTRIES = 0x10000;
+
+std::string build_aos_tooltip( UObject* obj, bool vendor_content )
 {
   std::string desc;
   if ( obj->isa( UOBJ_CLASS::CLASS_CHARACTER ) )
@@ -136,7 +144,61 @@ void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content
   u16 len = msg->offset;
   msg->offset = 1;
   msg->WriteFlipped<u16>( len );
-  msg.Send( client, len );
+  return std::string( msg->buffer, len );
+}
+}  // namespace
+
+void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+{
+  auto& cache = networkManager.tooltip_cache;
+  const std::string* pkt = cache.find( obj->serial, obj->rev(), vendor_content );
+  if ( pkt == nullptr )
+  {
+    ++networkManager.iostats.tooltip_cache.misses;
+    pkt = &cache.store( obj->serial, obj->rev(), vendor_content,
+                        build_aos_tooltip( obj, vendor_content ) );
+  }
+  else
+    ++networkManager.iostats.tooltip_cache.hits;
+  networkManager.clientTransmit->AddToQueue( client, pkt->data(),
+                                             static_cast<int>( pkt->size() ) );
+}
+
+u64 TooltipCache::key( u32 serial, bool vendor_content )
+{
+  return ( static_cast<u64>( serial ) << 1 ) | ( vendor_content ? 1 : 0 );
+}
+
+const std::string* TooltipCache::find( u32 serial, u32 rev, bool vendor_content ) const
+{
+  auto itr = entries_.find( key( serial, vendor_content ) );
+  if ( itr == entries_.end() || itr->second.rev != rev )
+    return nullptr;
+  return &itr->second.pkt;
+}
+
+const std::string& TooltipCache::store( u32 serial, u32 rev, bool vendor_content,
+                                        std::string&& pkt )
+{
+  if ( entries_.size() >= TOOLTIP_CACHE_MAX_ENTRIES )
+    entries_.clear();
+  auto& entry = entries_[key( serial, vendor_content )];
+  entry.rev = rev;
+  entry.pkt = std::move( pkt );
+  return entry.pkt;
+}
+
+void TooltipCache::clear()
+{
+  entries_.clear();
+}
+
+size_t TooltipCache::estimateSize() const
+{
+  size_t size = sizeof( TooltipCache ) + Clib::memsize( entries_ );
+  for ( const auto& entry : entries_ )
+    size += entry.second.pkt.capacity();
+  return size;
 }
 }  // namespace Core
 }  // namespace Pol
@@ -9,6 +9,12 @@
 #ifndef __TOOLTIPS_H
 #define __TOOLTIPS_H
 
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+
+#include "../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Network
@@ -21,6 +27,26 @@ class UObject;
 void send_object_cache( Network::Client* client, const UObject* obj );
 void send_object_cache_to_inrange( const UObject* obj );
 void SendAOSTooltip( Network::Client* client, UObject* item, bool vendor_content = false );
+
+// Ready built 0xD6 packets per object and vendor flag. An entry stays valid as long as the
+// object revision matches, every change which alters the tooltip increases the revision.
+class TooltipCache
+{
+public:
+  const std::string* find( u32 serial, u32 rev, bool vendor_content ) const;
+  const std::string& store( u32 serial, u32 rev, bool vendor_content, std::string&& pkt );
+  void clear();
+  size_t estimateSize() const;
+
+private:
+  struct Entry
+  {
+    u32 rev;
+    std::string pkt;
+  };
+  static u64 key( u32 serial, bool vendor_content );
+  std::unordered_map<u64, Entry> entries_;
+};
 }
 }
 #endif
@@ -364,6 +364,9 @@ void send_remove_character( Client* client, const Character* chr )
   /* Don't remove myself */
   if ( client->chr == chr )
     return;
+  /* nothing to remove if it never got created */
+  if ( !client->knows_mobile( chr->serial ) )
+    return;
   Network::RemoveObjectPkt msgremove( chr->serial_ext );
   msgremove.Send( client );
 }
@@ -377,6 +380,9 @@ void send_remove_character( Network::Client* client, const Mobile::Character* ch
   /* Don't remove myself */
   if ( client->chr == chr )
     return;
+  /* nothing to remove if it never got created */
+  if ( !client->knows_mobile( chr->serial ) )
+    return;
   pkt.update( chr->serial_ext );
   pkt.Send( client );
 }
@@ -384,14 +390,15 @@ void send_remove_character( Network::Client* client, const Mobile::Character* ch
 void send_remove_character_to_nearby( const Character* chr )
 {
   Network::RemoveObjectPkt msgremove( chr->serial_ext );
-  WorldIterator<OnlinePlayerFilter>::InMaxVisualRange( chr,
-                                                       [&]( Character* zonechr )
-                                                       {
-                                                         if ( zonechr == chr )
-                                                           return;
-                                                         if ( zonechr->in_visual_range( chr ) )
-                                                           msgremove.Send( zonechr->client );
-                                                       } );
+  WorldIterator<OnlinePlayerFilter>::InMaxVisualRange(
+      chr,
+      [&]( Character* zonechr )
+      {
+        if ( zonechr == chr )
+          return;
+        if ( zonechr->in_visual_range( chr ) && zonechr->client->knows_mobile( chr->serial ) )
+          msgremove.Send( zonechr->client );
+      } );
 }
 
 void send_remove_character_to_nearby_cantsee( const Character* chr )
@@ -403,7 +410,7 @@ void send_remove_character_to_nearby_cantsee( const Character* chr )
       {
         if ( zonechr == chr )
           return;
-        if ( !zonechr->in_visual_range( chr ) )
+        if ( !zonechr->in_visual_range( chr ) || !zonechr->client->knows_mobile( chr->serial ) )
           return;
         if ( !zonechr->is_visible_to_me( chr, /*check_range*/ false ) )
           msgremove.Send( zonechr->client );
@@ -417,7 +424,8 @@ void send_remove_character_to_nearby_cansee( const Character* chr )
       chr,
       [&]( Character* _chr )
       {
-        if ( _chr != chr && _chr->is_visible_to_me( chr ) )
+        if ( _chr != chr && _chr->is_visible_to_me( chr ) &&
+             _chr->client->knows_mobile( chr->serial ) )
           msgremove.Send( _chr->client );
       } );
 }
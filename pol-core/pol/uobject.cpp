@@ -36,6 +36,7 @@
 #include "syshookscript.h"
 #include "tooltips.h"
 #include "uobjcnt.h"
+#include "uworld.h"
 
 namespace Pol
 {
@@ -69,6 +70,7 @@ UObject::UObject( u32 objtype, UOBJ_CLASS i_uobj_class )
       color( 0 ),
       facing( Core::FACING_N ),
       _rev( 0 ),
+      zone_index_{ 0, 0 },
       name_( "" ),
       flags_(),
       proplist_( CPropProfiler::class_to_type( i_uobj_class ) )
@@ -148,6 +150,11 @@ bool UObject::getprop( const std::string& propname, std::string& propval ) const
   return proplist_.getprop( propname, propval );
 }
 
+Bscript::BObjectImp* UObject::getpropimp( const std::string& propname ) const
+{
+  return proplist_.getpropimp( propname );
+}
+
 void UObject::setprop( const std::string& propname, const std::string& propvalue )
 {
   if ( propname[0] != '#' )
@@ -236,6 +243,8 @@ void UObject::setposition( Pos4d newpos )
 {
   set_dirty();
   pos( std::move( newpos ) );
+  if ( in_zone() )
+    update_zone_position( this );
 }
 
 UFACING UObject::direction_toward( UObject* other ) const
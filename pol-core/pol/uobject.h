@@ -30,6 +30,7 @@
 #include "baseobject.h"
 #include "dynproperties.h"
 #include "proplist.h"
+#include "zone.h"
 
 #define pf_endl '\n'
 
@@ -141,6 +142,9 @@ enum class OBJ_FLAGS : u16
   NO_DROP = 1 << 9,             // Item flag
   NO_DROP_EXCEPTION = 1 << 10,  // Container/Character flag
   CURSED = 1 << 11,             // Cursed
+  // Item/NPC script listens for entered-/leftarea events, see Zone::area_event_items
+  AREA_EVENT_LISTENER = 1 << 12,
+  IN_ZONE = 1 << 13,  // listed in a world zone, see update_zone_position
 };
 
 /**
@@ -156,6 +160,7 @@ public:
   void setname( const std::string& );
 
   bool getprop( const std::string& propname, std::string& propvalue ) const;
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const UObject& obj );
@@ -199,6 +204,14 @@ public:
   bool saveonexit() const;
   void saveonexit( bool newvalue );
 
+  bool area_event_listener() const;
+  void area_event_listener( bool newvalue );
+  bool in_zone() const;
+  void in_zone( bool newvalue );
+  // index in the zone list, maintained by ZoneObjects
+  u32 zone_index( ZoneList list ) const;
+  void zone_index( ZoneList list, u32 idx );
+
   virtual void printOn( Clib::StreamWriter& ) const;
   virtual void printSelfOn( Clib::StreamWriter& sw ) const;
 
@@ -312,6 +325,7 @@ public:
 
 private:
   u32 _rev;
+  u32 zone_index_[2];
 
 protected:
   boost_utils::object_name_flystring name_;
@@ -336,6 +350,36 @@ inline void UObject::set_dirty()
   flags_.set( OBJ_FLAGS::DIRTY );
 }
 
+inline bool UObject::area_event_listener() const
+{
+  return flags_.get( OBJ_FLAGS::AREA_EVENT_LISTENER );
+}
+
+inline void UObject::area_event_listener( bool newvalue )
+{
+  flags_.change( OBJ_FLAGS::AREA_EVENT_LISTENER, newvalue );
+}
+
+inline bool UObject::in_zone() const
+{
+  return flags_.get( OBJ_FLAGS::IN_ZONE );
+}
+
+inline void UObject::in_zone( bool newvalue )
+{
+  flags_.change( OBJ_FLAGS::IN_ZONE, newvalue );
+}
+
+inline u32 UObject::zone_index( ZoneList list ) const
+{
+  return zone_index_[static_cast<u8>( list )];
+}
+
+inline void UObject::zone_index( ZoneList list, u32 idx )
+{
+  zone_index_[static_cast<u8>( list )] = idx;
+}
+
 inline unsigned UObject::ref_counted_count() const
 {
   return ref_counted::count();
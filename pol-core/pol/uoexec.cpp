@@ -214,6 +214,11 @@ Bscript::BObjectImp* UOExecutor::clear_event_queue()
   return os_module->clear_event_queue();
 }  // DAVE
 
+bool UOExecutor::event_queue_full() const
+{
+  return os_module->event_queue_full();
+}
+
 using namespace Bscript;
 using namespace Module;
 
@@ -139,6 +139,7 @@ public:
 
 
   Bscript::BObjectImp* clear_event_queue();
+  bool event_queue_full() const;
 
 
 public:
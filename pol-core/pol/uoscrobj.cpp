@@ -4203,7 +4203,9 @@ BObjectImp* UBoat::script_method_id( const int id, Core::UOExecutor& ex )
       u16 multioffset = multiid_ - base_multi;
       multiid_ = new_multiid + multioffset;
     }
-    transform_components( boatshape() );
+    ItemMoves item_moves;
+    transform_components( boatshape(), item_moves );
+    move_boat_items( item_moves );
     send_display_boat_to_inrange( {} );
     return new BLong( 1 );
   }
@@ -5005,6 +5007,9 @@ BObjectImp* Client::set_script_member_id( const int id, int value )
   case MBR_VISUAL_RANGE:
     set_update_range_by_script( Clib::clamp_convert<u8>( value ) );
     return new BLong( update_range() );
+  case MBR_BANDWIDTH_LIMIT:
+    session()->bandwidth_limit( value );
+    return new BLong( static_cast<int>( session()->bandwidth_limit() ) );
   default:
     return nullptr;
   }
@@ -5065,6 +5070,21 @@ BObjectImp* Client::get_script_member_id( const int id )
   case MBR_VISUAL_RANGE:
     return new BLong( update_range() );
     break;
+  case MBR_QUEUED_PACKETS:
+  {
+    std::unique_ptr<BStruct> queued( new BStruct );
+    for ( unsigned i = 0; i < Network::PACKET_PRIORITY_COUNT; ++i )
+    {
+      const auto priority = static_cast<Network::PacketPriority>( i );
+      queued->addMember( Network::packet_priority_name( priority ),
+                         new BLong( session()->held_packet_count( priority ) ) );
+    }
+    return queued.release();
+  }
+  break;
+  case MBR_BANDWIDTH_LIMIT:
+    return new BLong( static_cast<int>( session()->bandwidth_limit() ) );
+    break;
   }
 
   return nullptr;
@@ -32,10 +32,13 @@ void add_item_to_world( Items::Item* item )
 {
   Zone& zone = item->realm()->getzone( item->pos().xy() );
 
-  passert( std::find( zone.items.begin(), zone.items.end(), item ) == zone.items.end() );
+  passert( !zone.items.contains( item ) );
 
   item->realm()->add_toplevel_item( *item );
-  zone.items.push_back( item );
+  zone.items.push_back( item, item->pos2d() );
+  item->in_zone( true );
+  if ( item->area_event_listener() )
+    zone.area_event_items.push_back( item, item->pos2d() );
 }
 
 void remove_item_from_world( Items::Item* item )
@@ -51,37 +54,39 @@ void remove_item_from_world( Items::Item* item )
 
   Zone& zone = item->realm()->getzone( item->pos().xy() );
 
-  ZoneItems::iterator itr = std::find( zone.items.begin(), zone.items.end(), item );
-  if ( itr == zone.items.end() )
+  if ( !zone.items.contains( item ) )
   {
     POLLOG_ERRORLN(
         "remove_item_from_world: item {:#x} at {} does not exist in world zone ( Old Serial: {:#x} "
         ")",
         item->serial, item->pos2d(), ( cfBEu32( item->serial_ext ) ) );
 
-    passert( itr != zone.items.end() );
+    passert( zone.items.contains( item ) );
   }
 
   item->realm()->remove_toplevel_item( *item );
-  zone.items.erase( itr );
+  zone.items.erase( item );
+  item->in_zone( false );
+  if ( item->area_event_listener() )
+    zone.area_event_items.erase( item );
 }
 
 void add_multi_to_world( Multi::UMulti* multi )
 {
   Zone& zone = multi->realm()->getzone( multi->pos2d() );
-  zone.multis.push_back( multi );
+  zone.multis.push_back( multi, multi->pos2d() );
+  multi->in_zone( true );
   multi->realm()->add_multi( *multi );
 }
 
 void remove_multi_from_world( Multi::UMulti* multi )
 {
   Zone& zone = multi->realm()->getzone( multi->pos2d() );
-  ZoneMultis::iterator itr = std::find( zone.multis.begin(), zone.multis.end(), multi );
-
-  passert( itr != zone.multis.end() );
+  passert( zone.multis.contains( multi ) );
 
   multi->realm()->remove_multi( *multi );
-  zone.multis.erase( itr );
+  zone.multis.erase( multi );
+  multi->in_zone( false );
 }
 
 void move_multi_in_world( Multi::UMulti* multi, const Core::Pos4d& oldpos )
@@ -91,11 +96,10 @@ void move_multi_in_world( Multi::UMulti* multi, const Core::Pos4d& oldpos )
 
   if ( &oldzone != &newzone )
   {
-    ZoneMultis::iterator itr = std::find( oldzone.multis.begin(), oldzone.multis.end(), multi );
-    passert( itr != oldzone.multis.end() );
+    passert( oldzone.multis.contains( multi ) );
 
-    oldzone.multis.erase( itr );
-    newzone.multis.push_back( multi );
+    oldzone.multis.erase( multi );
+    newzone.multis.push_back( multi, multi->pos2d() );
   }
 
   if ( multi->realm() != oldpos.realm() )
@@ -105,6 +109,75 @@ void move_multi_in_world( Multi::UMulti* multi, const Core::Pos4d& oldpos )
   }
 }
 
+// Called by UObject::setposition for objects listed in a zone, keeps the cached zone coordinates
+// in sync. This is the only update for moves within a zone. If the zone changes the object is
+// still listed in its old zone and the Move*WorldPosition functions relocate it.
+void update_zone_position( UObject* obj )
+{
+  Zone& zone = obj->realm()->getzone( obj->pos().xy() );
+  const Pos2d pos = obj->pos2d();
+  if ( obj->ismobile() )
+  {
+    auto* chr = static_cast<Mobile::Character*>( obj );
+    if ( obj->isa( UOBJ_CLASS::CLASS_NPC ) )
+    {
+      if ( zone.npcs.update( chr, pos ) && obj->area_event_listener() )
+        zone.area_event_npcs.update( chr, pos );
+    }
+    else
+      zone.characters.update( chr, pos );
+  }
+  else if ( obj->ismulti() )
+    zone.multis.update( static_cast<Multi::UMulti*>( obj ), pos );
+  else
+  {
+    auto* item = static_cast<Items::Item*>( obj );
+    if ( zone.items.update( item, pos ) && obj->area_event_listener() )
+      zone.area_event_items.update( item, pos );
+  }
+}
+
+// Called when the script of a toplevel item or npc starts to listen for entered-/leftarea events.
+// The object is flagged and mirrored into the area_event lists of its zone, the world position
+// functions keep the lists in sync afterwards.
+void register_area_event_listener( UObject* obj )
+{
+  if ( obj->area_event_listener() )
+    return;
+  obj->area_event_listener( true );
+  if ( obj->realm() == nullptr )
+    return;
+
+  Zone& zone = obj->realm()->getzone( obj->pos().xy() );
+  if ( obj->isa( UOBJ_CLASS::CLASS_NPC ) )
+  {
+    auto* npc = static_cast<Mobile::Character*>( obj );
+    if ( zone.npcs.contains( npc ) )
+      zone.area_event_npcs.push_back( npc, npc->pos2d() );
+  }
+  else if ( obj->isitem() )
+  {
+    auto* item = static_cast<Items::Item*>( obj );
+    if ( item->container == nullptr && zone.items.contains( item ) )
+      zone.area_event_items.push_back( item, item->pos2d() );
+  }
+}
+
+void unregister_area_event_listener( UObject* obj )
+{
+  if ( !obj->area_event_listener() )
+    return;
+  obj->area_event_listener( false );
+  if ( obj->realm() == nullptr )
+    return;
+
+  Zone& zone = obj->realm()->getzone( obj->pos().xy() );
+  if ( obj->isa( UOBJ_CLASS::CLASS_NPC ) )
+    zone.area_event_npcs.erase( static_cast<Mobile::Character*>( obj ) );
+  else if ( obj->isitem() && static_cast<Items::Item*>( obj )->container == nullptr )
+    zone.area_event_items.erase( static_cast<Items::Item*>( obj ) );
+}
+
 int get_toplevel_item_count()
 {
   int count = 0;
@@ -130,14 +203,19 @@ void SetCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 
   auto set_pos = [&]( ZoneCharacters& set )
   {
-    passert( std::find( set.begin(), set.end(), chr ) == set.end() );
-    set.push_back( chr );
+    passert( !set.contains( chr ) );
+    set.push_back( chr, chr->pos2d() );
   };
 
   if ( chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+  {
     set_pos( zone.npcs );
+    if ( chr->area_event_listener() )
+      zone.area_event_npcs.push_back( chr, chr->pos2d() );
+  }
   else
     set_pos( zone.characters );
+  chr->in_zone( true );
 
   chr->realm()->add_mobile( *chr, reason );
 }
@@ -152,21 +230,25 @@ void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 
   auto clear_pos = [&]( ZoneCharacters& set )
   {
-    auto itr = std::find( set.begin(), set.end(), chr );
-    if ( itr == set.end() )
+    if ( !set.contains( chr ) )
     {
       find_missing_char_in_zone(
           chr, reason );  // Uh-oh, char was not in the expected zone. Find it and report.
-      passert( itr != set.end() );
+      passert( set.contains( chr ) );
     }
     chr->realm()->remove_mobile( *chr, reason );
-    set.erase( itr );
+    set.erase( chr );
+    chr->in_zone( false );
   };
 
   if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
     clear_pos( zone.characters );
   else
+  {
     clear_pos( zone.npcs );
+    if ( chr->area_event_listener() )
+      zone.area_event_npcs.erase( chr );
+  }
 }
 
 void MoveCharacterWorldPosition( const Core::Pos4d& oldpos, Mobile::Character* chr )
@@ -181,22 +263,28 @@ void MoveCharacterWorldPosition( const Core::Pos4d& oldpos, Mobile::Character* c
     {
       auto move_pos = [&]( ZoneCharacters& oldset, ZoneCharacters& newset )
       {
-        auto oldset_itr = std::find( oldset.begin(), oldset.end(), chr );
-
         // ensure it's found in the old realm
-        passert( oldset_itr != oldset.end() );
+        passert( oldset.contains( chr ) );
         // and that it's not yet in the new realm
-        passert( std::find( newset.begin(), newset.end(), chr ) == newset.end() );
+        passert( !newset.contains( chr ) );
 
-        oldset.erase( oldset_itr );
-        newset.push_back( chr );
+        oldset.erase( chr );
+        newset.push_back( chr, chr->pos2d() );
       };
 
       if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
         move_pos( oldzone.characters, newzone.characters );
       else
+      {
         move_pos( oldzone.npcs, newzone.npcs );
+        if ( chr->area_event_listener() )
+        {
+          oldzone.area_event_npcs.erase( chr );
+          newzone.area_event_npcs.push_back( chr, chr->pos2d() );
+        }
+      }
     }
+    // within the same zone setposition already updated the cached coords
   }
 
   // Regardless of online or not, tell the realms that we've left
@@ -214,21 +302,25 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
 
   if ( &oldzone != &newzone )
   {
-    ZoneItems::iterator itr = std::find( oldzone.items.begin(), oldzone.items.end(), item );
-
-    if ( itr == oldzone.items.end() )
+    if ( !oldzone.items.contains( item ) )
     {
       POLLOG_ERRORLN(
           "MoveItemWorldPosition: item {:#x} at old {} new {} does not exist in world zone.",
           item->serial, oldpos, item->pos() );
 
-      passert( itr != oldzone.items.end() );
+      passert( oldzone.items.contains( item ) );
     }
 
-    oldzone.items.erase( itr );
+    oldzone.items.erase( item );
+
+    passert( !newzone.items.contains( item ) );
+    newzone.items.push_back( item, item->pos2d() );
 
-    passert( std::find( newzone.items.begin(), newzone.items.end(), item ) == newzone.items.end() );
-    newzone.items.push_back( item );
+    if ( item->area_event_listener() )
+    {
+      oldzone.area_event_items.erase( item );
+      newzone.area_event_items.push_back( item, item->pos2d() );
+    }
   }
 
   if ( oldpos.realm() != item->realm() )
@@ -238,6 +330,79 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
   }
 }
 
+// Bulk version of setposition + MoveItemWorldPosition for items moving together (e.g. the deck of a
+// boat). Items staying in their zone only get their cached coords updated by setposition. The
+// others are grouped per zone: all of them are erased from their old zones first, afterwards each
+// destination zone grows at most once and gets its items appended.
+void MoveItemsWorldPosition( const std::vector<std::pair<Items::Item*, Core::Pos4d>>& moves )
+{
+  // a boat spans only a few zones, a linear search is enough
+  struct ZoneBatch
+  {
+    Zone* zone;
+    std::vector<Items::Item*> items;
+  };
+  std::vector<ZoneBatch> leaving;
+  std::vector<ZoneBatch> entering;
+  auto batch_of = []( std::vector<ZoneBatch>& batches, Zone* zone ) -> std::vector<Items::Item*>&
+  {
+    for ( auto& batch : batches )
+    {
+      if ( batch.zone == zone )
+        return batch.items;
+    }
+    batches.push_back( ZoneBatch{ zone, {} } );
+    return batches.back().items;
+  };
+
+  for ( const auto& [item, newpos] : moves )
+  {
+    const Core::Pos4d oldpos = item->pos();
+    Zone* oldzone = &oldpos.realm()->getzone( oldpos.xy() );
+    Zone* newzone = &newpos.realm()->getzone( newpos.xy() );
+    if ( oldzone != newzone && !oldzone->items.contains( item ) )
+    {
+      POLLOG_ERRORLN(
+          "MoveItemsWorldPosition: item {:#x} at old {} new {} does not exist in world zone.",
+          item->serial, oldpos, newpos );
+
+      passert( oldzone->items.contains( item ) );
+    }
+    item->setposition( newpos );
+    if ( oldzone != newzone )
+    {
+      batch_of( leaving, oldzone ).push_back( item );
+      batch_of( entering, newzone ).push_back( item );
+    }
+    if ( oldpos.realm() != item->realm() )
+    {
+      oldpos.realm()->remove_toplevel_item( *item );
+      item->realm()->add_toplevel_item( *item );
+    }
+  }
+
+  for ( auto& [zone, items] : leaving )
+  {
+    for ( auto* item : items )
+    {
+      zone->items.erase( item );
+      if ( item->area_event_listener() )
+        zone->area_event_items.erase( item );
+    }
+  }
+  for ( auto& [zone, items] : entering )
+  {
+    zone->items.reserve_more( items.size() );
+    for ( auto* item : items )
+    {
+      passert( !zone->items.contains( item ) );
+      zone->items.push_back( item, item->pos2d() );
+      if ( item->area_event_listener() )
+        zone->area_event_items.push_back( item, item->pos2d() );
+    }
+  }
+}
+
 // If the ClrCharacterWorldPosition() fails, this function will find the actual char position and
 // report
 // TODO: check if this is really needed...
@@ -266,13 +431,11 @@ void find_missing_char_in_zone( Mobile::Character* chr, Realms::WorldChangeReaso
     bool found = false;
     if ( is_npc )
     {
-      auto _z = chr->realm()->getzone_grid( p ).npcs;
-      found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
+      found = chr->realm()->getzone_grid( p ).npcs.contains( chr );
     }
     else
     {
-      auto _z = chr->realm()->getzone_grid( p ).characters;
-      found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
+      found = chr->realm()->getzone_grid( p ).characters.contains( chr );
     }
     if ( found )
       POLLOG_ERRORLN( "ClrCharacterWorldPosition: Found mob in zone {}", p );
@@ -364,6 +527,8 @@ void optimize_zones()
       realm->getzone_grid( p ).npcs.shrink_to_fit();
       realm->getzone_grid( p ).items.shrink_to_fit();
       realm->getzone_grid( p ).multis.shrink_to_fit();
+      realm->getzone_grid( p ).area_event_npcs.shrink_to_fit();
+      realm->getzone_grid( p ).area_event_items.shrink_to_fit();
     }
   }
 }
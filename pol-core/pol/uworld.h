@@ -23,6 +23,7 @@
 #include "mobile/charactr.h"
 #endif
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "../clib/passert.h"
@@ -54,6 +55,12 @@ void MoveCharacterWorldPosition( const Core::Pos4d& oldpos, Mobile::Character* c
 void SetItemWorldPosition( Items::Item* item );
 void ClrItemWorldPosition( Items::Item* item );
 void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item );
+void MoveItemsWorldPosition( const std::vector<std::pair<Items::Item*, Core::Pos4d>>& moves );
+
+void update_zone_position( UObject* obj );
+
+void register_area_event_listener( UObject* obj );
+void unregister_area_event_listener( UObject* obj );
 
 int get_toplevel_item_count();
 int get_mobile_count();
@@ -114,7 +121,9 @@ enum class FilterType
   OnlinePlayer,  // iterator over online player
   NPC,           // iterator over npcs
   Item,          // iterator over items
-  Multi          // iterator over multis
+  Multi,         // iterator over multis
+  AreaEventNPC,  // iterator over npcs listening for area events
+  AreaEventItem  // iterator over items listening for area events
 };
 
 // Filter implementation struct,
@@ -136,6 +145,8 @@ typedef FilterImp<FilterType::OnlinePlayer> OnlinePlayerFilter;
 typedef FilterImp<FilterType::NPC> NPCFilter;
 typedef FilterImp<FilterType::Item> ItemFilter;
 typedef FilterImp<FilterType::Multi> MultiFilter;
+typedef FilterImp<FilterType::AreaEventNPC> AreaEventNPCFilter;
+typedef FilterImp<FilterType::AreaEventItem> AreaEventItemFilter;
 
 namespace
 {
@@ -149,6 +160,7 @@ struct CoordsArea
   CoordsArea( Range2d box, const Realms::Realm* posrealm );                     // create from box
 
   bool inRange( const UObject* obj ) const;
+  const Range2d& range() const;
 
   // shifted coords
   Range2d warea;
@@ -207,6 +219,11 @@ inline bool CoordsArea::inRange( const UObject* obj ) const
   return area.contains( obj->pos().xy() );
 }
 
+inline const Range2d& CoordsArea::range() const
+{
+  return area;
+}
+
 inline Pos2d CoordsArea::convert( const Pos2d& p )
 {
   // zone_convert, but without Pos4d.
@@ -279,79 +296,69 @@ void WorldIterator<Filter>::_forEach( const CoordsArea& coords, F&& f )
 }
 
 // specializations of FilterImp
+// the range checks use the cached zone coordinates, objects are only dereferenced if in range
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Mobile>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  zone.characters.for_each_in( coords.range(), f );
+  zone.npcs.for_each_in( coords.range(), f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Player>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
+  zone.characters.for_each_in( coords.range(), f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::OnlinePlayer>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( chr->has_active_client() )
-    {
-      if ( coords.inRange( chr ) )
-        f( chr );
-    }
-  }
+  zone.characters.for_each_in( coords.range(),
+                               [&]( Mobile::Character* chr )
+                               {
+                                 if ( chr->has_active_client() )
+                                   f( chr );
+                               } );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::NPC>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  zone.npcs.for_each_in( coords.range(), f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Item>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& item : zone.items )
-  {
-    if ( coords.inRange( item ) )
-      f( item );
-  }
+  zone.items.for_each_in( coords.range(), f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Multi>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& multi : zone.multis )
-  {
-    if ( coords.inRange( multi ) )
-      f( multi );
-  }
+  zone.multis.for_each_in( coords.range(), f );
+}
+
+template <>
+template <typename F>
+void FilterImp<FilterType::AreaEventNPC>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
+{
+  zone.area_event_npcs.for_each_in( coords.range(), f );
+}
+
+template <>
+template <typename F>
+void FilterImp<FilterType::AreaEventItem>::call( Core::Zone& zone, const CoordsArea& coords,
+                                                 F&& f )
+{
+  zone.area_event_items.for_each_in( coords.range(), f );
 }
 }  // namespace Core
 }  // namespace Pol
@@ -6,9 +6,13 @@
 
 #ifndef ZONE_H
 #define ZONE_H
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
+#include "../clib/rawtypes.h"
 #include "base/position.h"
+#include "base/range.h"
 
 namespace Pol
 {
@@ -33,10 +37,66 @@ Pos2d XyToZone( const Pos2d& pos );
 
 typedef unsigned short RegionId;
 
+// The zone lists an object can be listed in at the same time, each keeps its own index in the
+// object (UObject::zone_index)
+enum class ZoneList : u8
+{
+  World,      // characters, npcs, items or multis
+  AreaEvent,  // area_event_npcs or area_event_items
+};
+
+// Object pointers of a zone together with dense copies of their coordinates (structure of
+// arrays). Range checks run over the coordinates only, so objects outside of the range are never
+// dereferenced. The coordinates are kept in sync by the world position functions (uworld.h).
+// Every object knows its index in the list, so lookup, update and erase don't need to search.
+// Erase moves the last object into the gap, the order of the objects is not stable.
+// Behaves like the former std::vector<T*> for reading.
+template <typename T, ZoneList L = ZoneList::World>
+class ZoneObjects
+{
+public:
+  typedef T* value_type;
+  typedef typename std::vector<T*>::iterator iterator;
+  typedef typename std::vector<T*>::const_iterator const_iterator;
+  typedef typename std::vector<T*>::size_type size_type;
+
+  iterator begin() { return _objs.begin(); }
+  iterator end() { return _objs.end(); }
+  const_iterator begin() const { return _objs.begin(); }
+  const_iterator end() const { return _objs.end(); }
+  size_type size() const { return _objs.size(); }
+  bool empty() const { return _objs.empty(); }
+  T* operator[]( size_type idx ) const { return _objs[idx]; }
+
+  bool contains( const T* obj ) const;
+  void push_back( T* obj, const Pos2d& pos );
+  // false if obj is not listed
+  bool erase( T* obj );
+  void clear();
+  // makes room for n more objects, growing at least by the current capacity
+  void reserve_more( size_type n );
+  void shrink_to_fit();
+  // update the cached coordinates of obj, false if obj is not listed
+  bool update( const T* obj, const Pos2d& pos );
+
+  // calls f for every object whose cached coordinates are inside of area
+  template <typename F>
+  void for_each_in( const Range2d& area, F&& f ) const;
+
+  size_t sizeEstimate() const;
+
+private:
+  std::vector<T*> _objs;
+  std::vector<u16> _x;
+  std::vector<u16> _y;
+};
+
 // world
-typedef std::vector<Mobile::Character*> ZoneCharacters;
-typedef std::vector<Multi::UMulti*> ZoneMultis;
-typedef std::vector<Items::Item*> ZoneItems;
+typedef ZoneObjects<Mobile::Character> ZoneCharacters;
+typedef ZoneObjects<Multi::UMulti> ZoneMultis;
+typedef ZoneObjects<Items::Item> ZoneItems;
+typedef ZoneObjects<Mobile::Character, ZoneList::AreaEvent> ZoneAreaEventNpcs;
+typedef ZoneObjects<Items::Item, ZoneList::AreaEvent> ZoneAreaEventItems;
 
 struct Zone
 {
@@ -44,8 +104,128 @@ struct Zone
   ZoneCharacters npcs;
   ZoneItems items;
   ZoneMultis multis;
+
+  // subsets of npcs and items whose scripts listen for entered-/leftarea events
+  // (see register_area_event_listener), only these need to be informed about movement
+  ZoneAreaEventNpcs area_event_npcs;
+  ZoneAreaEventItems area_event_items;
 };
 
+template <typename T, ZoneList L>
+inline bool ZoneObjects<T, L>::contains( const T* obj ) const
+{
+  const size_t idx = obj->zone_index( L );
+  return idx < _objs.size() && _objs[idx] == obj;
+}
+
+template <typename T, ZoneList L>
+inline void ZoneObjects<T, L>::push_back( T* obj, const Pos2d& pos )
+{
+  obj->zone_index( L, static_cast<u32>( _objs.size() ) );
+  _objs.push_back( obj );
+  _x.push_back( pos.x() );
+  _y.push_back( pos.y() );
+}
+
+template <typename T, ZoneList L>
+inline bool ZoneObjects<T, L>::erase( T* obj )
+{
+  if ( !contains( obj ) )
+    return false;
+  const size_t idx = obj->zone_index( L );
+  const size_t last = _objs.size() - 1;
+  if ( idx != last )
+  {
+    _objs[idx] = _objs[last];
+    _x[idx] = _x[last];
+    _y[idx] = _y[last];
+    _objs[idx]->zone_index( L, static_cast<u32>( idx ) );
+  }
+  _objs.pop_back();
+  _x.pop_back();
+  _y.pop_back();
+  return true;
+}
+
+template <typename T, ZoneList L>
+inline void ZoneObjects<T, L>::clear()
+{
+  _objs.clear();
+  _x.clear();
+  _y.clear();
+}
+
+template <typename T, ZoneList L>
+inline void ZoneObjects<T, L>::reserve_more( size_type n )
+{
+  const size_type needed = _objs.size() + n;
+  if ( needed <= _objs.capacity() )
+    return;
+  const size_type capacity = std::max( needed, 2 * _objs.capacity() );
+  _objs.reserve( capacity );
+  _x.reserve( capacity );
+  _y.reserve( capacity );
+}
+
+template <typename T, ZoneList L>
+inline void ZoneObjects<T, L>::shrink_to_fit()
+{
+  _objs.shrink_to_fit();
+  _x.shrink_to_fit();
+  _y.shrink_to_fit();
+}
+
+template <typename T, ZoneList L>
+inline bool ZoneObjects<T, L>::update( const T* obj, const Pos2d& pos )
+{
+  if ( !contains( obj ) )
+    return false;
+  const size_t idx = obj->zone_index( L );
+  _x[idx] = pos.x();
+  _y[idx] = pos.y();
+  return true;
+}
+
+template <typename T, ZoneList L>
+template <typename F>
+inline void ZoneObjects<T, L>::for_each_in( const Range2d& area, F&& f ) const
+{
+  const u16 x1 = area.nw().x();
+  const u16 y1 = area.nw().y();
+  const u16 x2 = area.se().x();
+  const u16 y2 = area.se().y();
+  // first collect the matching indices of a block without branches over the dense coordinates,
+  // afterwards only the objects which passed are visited
+  const size_t block = 64;
+  u8 hits[block];
+  for ( size_t start = 0; start < _objs.size(); start += block )
+  {
+    const size_t count = std::min( block, _objs.size() - start );
+    const u16* xs = _x.data() + start;
+    const u16* ys = _y.data() + start;
+    size_t found = 0;
+    for ( size_t i = 0; i < count; ++i )
+    {
+      hits[found] = static_cast<u8>( i );
+      found += ( xs[i] >= x1 ) & ( xs[i] <= x2 ) & ( ys[i] >= y1 ) & ( ys[i] <= y2 );
+    }
+    for ( size_t i = 0; i < found; ++i )
+    {
+      const size_t idx = start + hits[i];
+      // f should not modify the zone, but be defensive
+      if ( idx < _objs.size() )
+        f( _objs[idx] );
+    }
+  }
+}
+
+template <typename T, ZoneList L>
+inline size_t ZoneObjects<T, L>::sizeEstimate() const
+{
+  return 3 * 3 * sizeof( void* ) + _objs.capacity() * sizeof( T* ) +
+         ( _x.capacity() + _y.capacity() ) * sizeof( u16 );
+}
+
 }  // namespace Core
 }  // namespace Pol
 #endif
@@ -46,6 +46,10 @@ const OT_BOOLEAN          := 38;
 const OT_FUNCOBJECT       := 39;
 const OT_EXPORTEDSCRIPT   := 40;
 const OT_STORAGEAREA      := 41;
+
+// Pack() formats
+const PACK_FORMAT_TEXT   := 1;
+const PACK_FORMAT_BINARY := 2;
 // format-on
 
 // returns the one-based index of Search within Str after position Start
@@ -97,7 +101,8 @@ SubStrReplace( str, replace_with, start, length := 0 );
 // Pack( 5 ) returns "i5"
 // Unpack( "i5" ) returns 5
 // strings, integers, reals, and arrays and dictionaries of these can be packed.
-Pack( expr );
+// PACK_FORMAT_BINARY packs smaller and faster, Unpack() detects the format itself.
+Pack( expr, format := PACK_FORMAT_TEXT );
 Unpack( str );
 
 TypeOf( expr ); // returns "Integer", "Real" etc
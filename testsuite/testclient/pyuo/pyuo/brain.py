@@ -206,6 +206,7 @@ class Event:
   EVT_LIST_EQUIPPED_ITEMS = 110
   EVT_BOAT_MOVE = 111
   EVT_AOS_TOOLTIP = 112
+  EVT_PAUSE_RECV = 113
 
   EVT_INIT = 254
   EVT_CLIENT_CRASH = 255
@@ -272,3 +273,5 @@ class Event:
       return "gump"
     elif self.type==Event.EVT_AOS_TOOLTIP:
       return "aos_tooltip"
+    elif self.type==Event.EVT_PAUSE_RECV:
+      return "pause_recv"
@@ -536,6 +536,8 @@ class Client(threading.Thread):
     self.todoqueue = []
     ## Lock for the todo queue
     self.todoLock = threading.Lock()
+    ## Time until the socket is not read, lets the server backlog
+    self.recvPausedUntil = 0
     ## Dict info about last server connected to {ip, port, user, pass}
     self.server = None
     ## Current client status, one of:
@@ -714,7 +716,7 @@ class Client(threading.Thread):
     self.ping = time.time() + self.PING_INTERVAL
 
     while True:
-      pkt = self.receive(blocking=False)
+      pkt = self.receive(blocking=False) if self.recvPausedUntil <= time.time() else None
       self.send()
 
       if not self.processTodo():
@@ -1366,6 +1368,9 @@ class Client(threading.Thread):
       elif todo.type == brain.Event.EVT_DISABLE_ITEM_LOGGING:
         self.disable_item_logging = todo.value
         self.brain.event(brain.Event(brain.Event.EVT_DISABLE_ITEM_LOGGING))
+      elif todo.type == brain.Event.EVT_PAUSE_RECV:
+        self.recvPausedUntil = time.time() + todo.seconds
+        self.brain.event(brain.Event(brain.Event.EVT_PAUSE_RECV))
       else:
         raise NotImplementedError("Unknown todo event {}",format(todo.type))
     return True
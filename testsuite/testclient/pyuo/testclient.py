@@ -137,6 +137,8 @@ class TestBrain(brain.Brain):
         self.client.addTodo(brain.Event(brain.Event.EVT_DISABLE_ITEM_LOGGING, value = arg))
       elif todo=="aos_tooltip":
         self.client.getAOSTooltip(arg[0],arg[1])
+      elif todo=="pause_recv":
+        self.client.addTodo(brain.Event(brain.Event.EVT_PAUSE_RECV, seconds = arg))
 
     return True
 
@@ -337,6 +339,8 @@ class PolServer:
       res['texts']=ev.texts
     elif ev.type==Event.EVT_AOS_TOOLTIP:
       res['text']=ev.text
+    elif ev.type==Event.EVT_PAUSE_RECV:
+      pass
     else:
       raise NotImplementedError("Unknown event {}",format(ev.type))
 